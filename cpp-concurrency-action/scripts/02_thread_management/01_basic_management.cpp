@@ -4,6 +4,7 @@
 #include <vector>
 
 #include "./utils/scoped_thread.hpp"
+#include "thread_group.hpp"
 
 void task(int& id, std::string data, std::unique_ptr<int> ptr) {
   //   std::cout << "[Thread " << std::this_thread::get_id() << "] "
@@ -29,18 +30,16 @@ int main() {
     // 1. 使用线程包装器（推荐）
     scoped_thread scope_t{spawn_worker(shared_id)};
 
-    // 2. 批量管理
-    std::vector<std::thread> workers;
-    for (int i = 0; i < 100; ++i) {
-      workers.emplace_back(spawn_worker(shared_id));
-    }
-
-    for (auto& t : workers) {
-      if (t.joinable()) t.join();  // 手动 join 批量线程
+    // 2. 批量管理：thread_group 接管工厂返回的线程，离开作用域时统一 join
+    {
+      thread_group workers;
+      for (int i = 0; i < 100; ++i) {
+        workers.add_thread(spawn_worker(shared_id));
+      }
     }
 
   } catch (const std::exception& e) {
-    // 这里 scoped_thread 会自动 join，批量线程也已 join，不用再担心资源泄漏
+    // 这里 scoped_thread 与 thread_group 都会自动 join，不用再担心资源泄漏
     std::cerr << "Exception: " << e.what() << std::endl;
   }
 
@@ -3,11 +3,13 @@
 #include <thread>
 #include <vector>
 
+#include "./utils/stop_aware.hpp"
+
+// 每 200ms 干一次活；睡眠可被 request_stop() 立即打断，而不是睡满才去检查 stop_requested()
 void interruptible_task(std::stop_token stoken) {
-  while (!stoken.stop_requested()) {
+  do {
     std::cout << "Still working...\n";
-    std::this_thread::sleep_for(std::chrono::milliseconds(200));
-  }
+  } while (interruptible_sleep_for(stoken, std::chrono::milliseconds(200)));
   std::cout << "Received stop signal!\n";
 }
 
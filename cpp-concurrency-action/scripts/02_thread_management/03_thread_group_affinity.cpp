@@ -0,0 +1,136 @@
+/**
+ * @file 03_thread_group_affinity.cpp
+ * @brief 线程组 + CPU 亲和性 + 拓扑感知放置（utils/thread_group.hpp, utils/cpu_topology.hpp）
+ * 1) 读取 /sys/devices/system/cpu 拓扑，打印紧凑 / 分散两种放置顺序；
+ * 2) thread_group 按分散策略创建并命名线程（top -H / perf 里能看到名字）；
+ * 3) 基准：SPSCQueue ping-pong 往返延迟与两个线程的相对位置的关系：
+ *    同一逻辑 CPU / 超线程兄弟 / 同插槽不同核 / 跨插槽 / 不绑核。机器上不存在的组合标为 n/a。
+ * 用法：03_thread_group_affinity [rounds]
+ */
+
+#include <sched.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "cpu_topology.hpp"
+#include "spsc_queue.hpp"
+#include "thread_group.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+void print_list(const std::string& title, const std::vector<int>& cpus) {
+  std::cout << title;
+  for (int c : cpus) std::cout << " " << c;
+  std::cout << "\n";
+}
+
+struct rtt_report {
+  double avg_ns;
+  double p99_ns;
+};
+
+// 两个线程分别绑定到 a、b（-1 表示不绑），通过一对 SPSC 队列来回传递 rounds 次
+rtt_report ping_pong(int a, int b, int rounds) {
+  SPSCQueue<int, 64> ping, pong;
+  std::vector<long> rtt(rounds);
+  {
+    thread_group pair;
+    pair.create_thread(thread_options{"pong", b >= 0 ? std::vector<int>{b} : std::vector<int>{}},
+                       [&] {
+                         for (int i = 0; i < rounds; ++i) pong.push_wait(ping.pop_wait());
+                       });
+    pair.create_thread(
+        thread_options{"ping", a >= 0 ? std::vector<int>{a} : std::vector<int>{}}, [&] {
+          for (int i = 0; i < rounds; ++i) {
+            auto t0 = Clock::now();
+            ping.push_wait(i);
+            pong.pop_wait();
+            rtt[i] = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         Clock::now() - t0)
+                         .count();
+          }
+        });
+  }
+  std::sort(rtt.begin(), rtt.end());
+  double sum = 0;
+  for (long r : rtt) sum += r;
+  return {sum / rounds, static_cast<double>(rtt[rounds * 99 / 100])};
+}
+
+void row(const std::string& name, int a, int b, bool available, int rounds) {
+  std::cout << std::left << std::setw(24) << name << std::right;
+  if (!available) {
+    std::cout << std::setw(12) << "n/a" << "\n";
+    return;
+  }
+  auto r = ping_pong(a, b, rounds);
+  std::cout << std::setw(12) << r.avg_ns << std::setw(12) << r.p99_ns;
+  if (a >= 0) std::cout << "    cpu " << a << " <-> " << b;
+  std::cout << "\n";
+}
+
+int main(int argc, char* argv[]) {
+  const int rounds = argc > 1 ? std::atoi(argv[1]) : 100000;
+  const cpu_topology topo = cpu_topology::detect();
+  const std::size_t n = topo.cpus().size();
+
+  // 1. 拓扑
+  std::cout << "[Topology] " << topo.packages() << " package(s), "
+            << topo.physical_cores() << " physical core(s), " << n
+            << " logical CPU(s) available\n";
+  for (auto& c : topo.cpus())
+    std::cout << "  cpu " << c.cpu << ": package " << c.package << ", core "
+              << c.core << "\n";
+  print_list("  compact order:", topo.compact(n));
+  print_list("  spread order: ", topo.spread(n));
+
+  // 2. 分散放置 + 命名
+  {
+    std::mutex io;
+    thread_group workers;
+    workers.create_threads(std::min<std::size_t>(4, std::max<std::size_t>(n, 1)),
+                           placement::spread, topo, "worker",
+                           [&io](std::size_t index) {
+                             char name[16] = {};
+                             pthread_getname_np(pthread_self(), name, sizeof(name));
+                             std::lock_guard<std::mutex> lk(io);
+                             std::cout << "[Group] thread " << index << " named '"
+                                       << name << "' running on cpu "
+                                       << sched_getcpu() << "\n";
+                           });
+  }  // 析构时自动 join
+
+  // 3. ping-pong 延迟 vs 放置
+  const int anchor = topo.cpus().empty() ? 0 : topo.cpus()[0].cpu;
+  int sibling = -1, same_package = -1, remote = -1;
+  for (auto& c : topo.cpus()) {  // 找一个有超线程兄弟的核
+    auto sib = topo.smt_siblings(c.cpu);
+    if (!sib.empty()) {
+      sibling = sib[0];
+      break;
+    }
+  }
+  const int sibling_anchor =
+      sibling >= 0 ? topo.smt_siblings(sibling)[0] : anchor;
+  auto local = topo.same_package_other_cores(anchor);
+  if (!local.empty()) same_package = local[0];
+  auto far = topo.other_packages(anchor);
+  if (!far.empty()) remote = far[0];
+
+  std::cout << "\n[Ping-pong] " << rounds << " round trips\n";
+  std::cout << "placement                rtt avg(ns) rtt p99(ns)\n";
+  std::cout << std::fixed << std::setprecision(0);
+  row("same logical cpu", anchor, anchor, true, rounds);
+  row("smt siblings", sibling_anchor, sibling, sibling >= 0, rounds);
+  row("same package", anchor, same_package, same_package >= 0, rounds);
+  row("cross package", anchor, remote, remote >= 0, rounds);
+  row("unpinned", -1, -1, true, rounds);
+  return 0;
+}
@@ -0,0 +1,205 @@
+/**
+ * @file 04_stop_aware_workers.cpp
+ * @brief 响应 stop_token 的阻塞等待（utils/stop_aware.hpp）
+ * 1) 三类阻塞操作被 request_stop() 打断的延迟：限时睡眠、队列 pop、future 等待；
+ * 2) stop_aware_pool：任务接收 stop_token 提前收尾，排队未执行的任务得到 broken_promise；
+ * 3) 基准：N 个空闲工作线程，轮询式（try_pop + sleep_for 间隔后检查 stop_requested）
+ *    与 stop_aware_queue::wait_and_pop 对比关闭延迟和空闲唤醒次数
+ *    （空闲窗口内各线程的主动上下文切换数，每次睡眠返回都算一次）。
+ *    轮询线程以随机相位开始，关闭延迟是等最慢的那个线程睡醒。
+ * 用法：04_stop_aware_workers [workers] [idle_ms]
+ */
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "./utils/stop_aware.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+double us_between(Clock::time_point a, Clock::time_point b) {
+  return std::chrono::duration<double, std::micro>(b - a).count();
+}
+
+// 线程 tid 的主动上下文切换次数（/proc/self/task/<tid>/status）
+long voluntary_switches(long tid) {
+  std::ifstream in("/proc/self/task/" + std::to_string(tid) + "/status");
+  std::string key;
+  long value = 0;
+  while (in >> key) {
+    if (key == "voluntary_ctxt_switches:") {
+      in >> value;
+      break;
+    }
+  }
+  return value;
+}
+
+// 线程进入 wait(st) 后 20ms 请求停止，返回从请求到 wait 返回的微秒数
+template <typename Wait>
+double stop_latency_us(Wait wait) {
+  Clock::time_point requested, woke;
+  {
+    std::jthread t([&](std::stop_token st) {
+      wait(st);
+      woke = Clock::now();
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    requested = Clock::now();
+    t.request_stop();
+  }  // join 之后读取 woke
+  return us_between(requested, woke);
+}
+
+void demo_blocking_ops() {
+  std::cout << "[Wake on stop] latency from request_stop() to return\n"
+            << std::fixed << std::setprecision(1);
+
+  double sleep_us = stop_latency_us([](std::stop_token st) {
+    interruptible_sleep_for(st, std::chrono::seconds(10));
+  });
+  std::cout << "  interruptible_sleep_for(10s)      " << std::setw(8) << sleep_us << " us\n";
+
+  stop_aware_queue<int> q;
+  double pop_us = stop_latency_us([&q](std::stop_token st) {
+    int v;
+    q.wait_and_pop(v, st);
+  });
+  std::cout << "  stop_aware_queue::wait_and_pop    " << std::setw(8) << pop_us << " us\n";
+
+  double pop_for_us = stop_latency_us([&q](std::stop_token st) {
+    int v;
+    q.wait_for_and_pop(v, st, std::chrono::seconds(10));
+  });
+  std::cout << "  stop_aware_queue::wait_for_and_pop" << std::setw(8) << pop_for_us << " us\n";
+
+  stop_aware_promise<int> never;  // 结果永远不会到来
+  auto fut = never.get_future();
+  double fut_us = stop_latency_us([&fut](std::stop_token st) { fut.get(st); });
+  std::cout << "  stop_aware_future::get            " << std::setw(8) << fut_us << " us\n";
+}
+
+void demo_pool() {
+  std::cout << "\n[Pool] 2 workers, 2 long tasks + 1 queued task, then shutdown\n";
+  std::vector<stop_aware_future<int>> running;
+  stop_aware_future<int> queued;
+  auto t0 = Clock::now();
+  {
+    stop_aware_pool pool(2);
+    for (int i = 0; i < 2; ++i)
+      running.push_back(pool.submit([i](std::stop_token st) {
+        // 被打断时交回部分结果，而不是让析构等满 10 秒
+        return interruptible_sleep_for(st, std::chrono::seconds(10)) ? i : -1;
+      }));
+    queued = pool.submit([] { return 42; });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+  std::cout << "  pool destroyed after " << us_between(t0, Clock::now()) / 1000
+            << " ms\n";
+  for (auto& f : running) std::cout << "  long task returned " << *f.get() << "\n";
+  try {
+    int v = *queued.get();
+    std::cout << "  queued task returned " << v << "\n";
+  } catch (const std::future_error& e) {
+    std::cout << "  queued task: " << e.what() << "\n";
+  }
+  // 与 std::future 一致：结果只能取一次
+  try {
+    running.front().get();
+    std::cout << "  second get() returned a value (unexpected)\n";
+  } catch (const std::future_error& e) {
+    std::cout << "  second get(): " << e.what() << " (valid() == "
+              << std::boolalpha << running.front().valid() << ")\n";
+  }
+}
+
+struct idle_report {
+  double wakeups_per_sec;
+  double shutdown_ms;
+};
+
+// body(st, q) 是工作线程的主循环；空闲 idle_ms 后统一请求停止
+idle_report run_idle(unsigned workers, int idle_ms,
+                     const std::function<void(std::stop_token, stop_aware_queue<int>&)>& body) {
+  stop_aware_queue<int> q;
+  std::vector<std::atomic<long>> tids(workers);
+  std::vector<std::jthread> threads;
+  for (unsigned i = 0; i < workers; ++i)
+    threads.emplace_back([&, i](std::stop_token st) {
+      tids[i] = syscall(SYS_gettid);
+      body(st, q);
+    });
+  for (auto& tid : tids)
+    while (tid.load() == 0) std::this_thread::yield();
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));  // 让线程都进入等待
+
+  // 只统计空闲窗口内的切换，不含线程启动与退出
+  long before = 0, after = 0;
+  for (auto& tid : tids) before += voluntary_switches(tid);
+  std::this_thread::sleep_for(std::chrono::milliseconds(idle_ms));
+  for (auto& tid : tids) after += voluntary_switches(tid);
+
+  auto t0 = Clock::now();
+  for (auto& t : threads) t.request_stop();
+  threads.clear();  // 逐个 join
+  double shutdown_ms = us_between(t0, Clock::now()) / 1000;
+  return {(after - before) * 1000.0 / idle_ms, shutdown_ms};
+}
+
+void polling_body(std::stop_token st, stop_aware_queue<int>& q,
+                  std::chrono::milliseconds interval) {
+  // 真实系统里各线程的轮询相位是任意的，先随机睡一小段
+  thread_local std::mt19937 rng(std::random_device{}());
+  std::this_thread::sleep_for(
+      std::chrono::microseconds(rng() % (interval.count() * 1000)));
+  int v;
+  while (!st.stop_requested()) {
+    if (!q.try_pop(v)) std::this_thread::sleep_for(interval);
+  }
+}
+
+void stop_aware_body(std::stop_token st, stop_aware_queue<int>& q) {
+  int v;
+  while (q.wait_and_pop(v, st)) {
+  }
+}
+
+void row(const std::string& name, const idle_report& r) {
+  std::cout << std::left << std::setw(28) << name << std::right << std::setw(14)
+            << r.wakeups_per_sec << std::setw(16) << r.shutdown_ms << "\n";
+}
+
+int main(int argc, char* argv[]) {
+  const unsigned workers = argc > 1 ? std::atoi(argv[1]) : 8;
+  const int idle_ms = argc > 2 ? std::atoi(argv[2]) : 1000;
+
+  demo_blocking_ops();
+  demo_pool();
+
+  std::cout << "\n[Idle workers] " << workers << " threads idle for " << idle_ms
+            << " ms, then request_stop()\n";
+  std::cout << "worker loop                 wakeups/s     shutdown(ms)\n"
+            << std::fixed << std::setprecision(1);
+  for (int interval : {200, 10, 1}) {
+    auto ms = std::chrono::milliseconds(interval);
+    row("poll, sleep " + std::to_string(interval) + "ms",
+        run_idle(workers, idle_ms, [ms](std::stop_token st, stop_aware_queue<int>& q) {
+          polling_body(st, q, ms);
+        }));
+  }
+  row("stop_aware wait_and_pop", run_idle(workers, idle_ms, stop_aware_body));
+  return 0;
+}
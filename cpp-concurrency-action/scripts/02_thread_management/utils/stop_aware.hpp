@@ -0,0 +1,265 @@
+/**
+ * @file stop_aware.hpp
+ * @brief 响应 stop_token 的阻塞操作：request_stop() 立即唤醒，不需要轮询睡眠
+ *
+ * 核心是 C++20 std::condition_variable_any 的 wait(lock, stop_token, pred) 重载：
+ * 它在内部注册一个 stop_callback，停止请求到来时 notify 这个条件变量。
+ * - interruptible_sleep_for : 可被打断的睡眠（返回 false 表示被停止）
+ * - stop_aware_queue<T>     : 阻塞 / 限时 pop 在停止请求时立即返回 false
+ * - stop_aware_promise / stop_aware_future : get(stop_token) 在停止时返回 std::nullopt；
+ *                             与 std::future 一样只能取一次结果，之后 valid() == false
+ * - stop_aware_pool         : std::jthread 工作线程池，析构时一次性请求所有线程停止；
+ *                             任务可接收 stop_token，未执行的任务其 future 得到 broken_promise
+ * 若等待的条件不在自己的条件变量上（例如等待第三方事件），可用 std::stop_callback 把
+ * 停止请求转发成一次 notify，效果相同。
+ */
+
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <stop_token>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// 睡满 d 返回 true；期间收到停止请求立即返回 false
+template <typename Rep, typename Period>
+bool interruptible_sleep_for(std::stop_token st,
+                             const std::chrono::duration<Rep, Period>& d) {
+  std::mutex m;
+  std::condition_variable_any cv;
+  std::unique_lock<std::mutex> lk(m);
+  cv.wait_for(lk, st, d, [] { return false; });
+  return !st.stop_requested();
+}
+
+template <typename T>
+class stop_aware_queue {
+ private:
+  mutable std::mutex mut;
+  std::queue<T> data_queue;
+  std::condition_variable_any data_cond;
+
+ public:
+  void push(T new_value) {
+    {
+      std::lock_guard<std::mutex> lk(mut);
+      data_queue.push(std::move(new_value));
+    }
+    data_cond.notify_one();
+  }
+
+  // 阻塞式 pop：取到返回 true；停止请求到来时立即返回 false。
+  // 标准 wait(lk, st, pred) 在停止后返回 pred()，队列非空时仍会取出元素，
+  // 这里额外检查 stop_requested()：已停止就不再取，剩余元素留在队列里
+  bool wait_and_pop(T& value, std::stop_token st) {
+    std::unique_lock<std::mutex> lk(mut);
+    if (!data_cond.wait(lk, st, [this] { return !data_queue.empty(); }) ||
+        st.stop_requested())
+      return false;
+    value = std::move(data_queue.front());
+    data_queue.pop();
+    return true;
+  }
+
+  // 限时 pop：超时或停止都返回 false
+  template <typename Rep, typename Period>
+  bool wait_for_and_pop(T& value, std::stop_token st,
+                        const std::chrono::duration<Rep, Period>& timeout) {
+    std::unique_lock<std::mutex> lk(mut);
+    if (!data_cond.wait_for(lk, st, timeout,
+                            [this] { return !data_queue.empty(); }) ||
+        st.stop_requested())
+      return false;
+    value = std::move(data_queue.front());
+    data_queue.pop();
+    return true;
+  }
+
+  bool try_pop(T& value) {
+    std::lock_guard<std::mutex> lk(mut);
+    if (data_queue.empty()) return false;
+    value = std::move(data_queue.front());
+    data_queue.pop();
+    return true;
+  }
+
+  bool empty() const {
+    std::lock_guard<std::mutex> lk(mut);
+    return data_queue.empty();
+  }
+};
+
+// void 结果用 std::monostate 占位，get 返回 std::optional<std::monostate>
+template <typename T>
+using stop_aware_value_t =
+    std::conditional_t<std::is_void<T>::value, std::monostate, T>;
+
+namespace detail {
+template <typename T>
+struct stop_aware_state {
+  std::mutex m;
+  std::condition_variable_any cv;
+  std::optional<stop_aware_value_t<T>> value;
+  std::exception_ptr error;
+  bool ready = false;
+
+  template <typename Set>
+  void complete(Set&& set) {
+    {
+      std::lock_guard<std::mutex> lk(m);
+      if (ready) throw std::future_error(std::future_errc::promise_already_satisfied);
+      set();
+      ready = true;
+    }
+    cv.notify_all();
+  }
+};
+}  // namespace detail
+
+template <typename T>
+class stop_aware_future {
+  std::shared_ptr<detail::stop_aware_state<T>> state;
+
+ public:
+  stop_aware_future() = default;
+  explicit stop_aware_future(std::shared_ptr<detail::stop_aware_state<T>> s)
+      : state(std::move(s)) {}
+
+  bool valid() const { return state != nullptr; }
+
+  // 等到结果或停止请求；停止时返回 std::nullopt，future 仍然有效，可再次 get。
+  // 取到结果（或重新抛出异常结果）后 valid() == false，再调用抛出 no_state
+  std::optional<stop_aware_value_t<T>> get(std::stop_token st = {}) {
+    if (!state) throw std::future_error(std::future_errc::no_state);
+    auto s = state;  // 先于 lk 声明：reset 之后状态（连同其中的 mutex）仍存活到解锁
+    std::unique_lock<std::mutex> lk(s->m);
+    if (!s->cv.wait(lk, st, [&s] { return s->ready; })) return std::nullopt;
+    state.reset();
+    if (s->error) std::rethrow_exception(s->error);
+    return std::move(s->value);
+  }
+
+  // 超时或停止返回 false
+  template <typename Rep, typename Period>
+  bool wait_for(const std::chrono::duration<Rep, Period>& timeout,
+                std::stop_token st = {}) {
+    if (!state) throw std::future_error(std::future_errc::no_state);
+    std::unique_lock<std::mutex> lk(state->m);
+    return state->cv.wait_for(lk, st, timeout, [this] { return state->ready; });
+  }
+};
+
+template <typename T>
+class stop_aware_promise {
+  std::shared_ptr<detail::stop_aware_state<T>> state =
+      std::make_shared<detail::stop_aware_state<T>>();
+
+ public:
+  stop_aware_promise() = default;
+  stop_aware_promise(stop_aware_promise&&) = default;
+  stop_aware_promise& operator=(stop_aware_promise&&) = default;
+  stop_aware_promise(const stop_aware_promise&) = delete;
+  stop_aware_promise& operator=(const stop_aware_promise&) = delete;
+
+  // 未交付结果就销毁（例如任务因停止而被丢弃）：等待者得到 broken_promise
+  ~stop_aware_promise() {
+    if (!state) return;
+    std::lock_guard<std::mutex> lk(state->m);
+    if (state->ready) return;
+    state->error = std::make_exception_ptr(
+        std::future_error(std::future_errc::broken_promise));
+    state->ready = true;
+    state->cv.notify_all();
+  }
+
+  stop_aware_future<T> get_future() { return stop_aware_future<T>(state); }
+
+  template <typename... V>
+  void set_value(V&&... v) {
+    state->complete([&] { state->value.emplace(std::forward<V>(v)...); });
+  }
+
+  void set_exception(std::exception_ptr e) {
+    state->complete([&] { state->error = e; });
+  }
+};
+
+class stop_aware_pool {
+  using task_type = std::function<void(std::stop_token)>;
+
+  stop_aware_queue<task_type> tasks;
+  std::vector<std::jthread> workers;  // 最后声明：析构时先于队列销毁
+
+  void worker_loop(std::stop_token st) {
+    task_type task;
+    while (tasks.wait_and_pop(task, st)) {
+      task(st);
+      task = nullptr;
+    }
+  }
+
+  template <typename F>
+  static decltype(auto) invoke(F& f, std::stop_token st) {
+    if constexpr (std::is_invocable<F&, std::stop_token>::value)
+      return f(st);
+    else
+      return f();
+  }
+
+ public:
+  explicit stop_aware_pool(
+      unsigned thread_count = std::thread::hardware_concurrency()) {
+    if (thread_count == 0) thread_count = 1;
+    for (unsigned i = 0; i < thread_count; ++i)
+      workers.emplace_back([this](std::stop_token st) { worker_loop(st); });
+  }
+
+  // 先向所有线程发出停止请求，再逐个 join（jthread 析构），关闭耗时不随线程数累加
+  ~stop_aware_pool() { request_stop(); }
+
+  stop_aware_pool(const stop_aware_pool&) = delete;
+  stop_aware_pool& operator=(const stop_aware_pool&) = delete;
+
+  void request_stop() {
+    for (auto& w : workers) w.request_stop();
+  }
+
+  // f() 或 f(std::stop_token)
+  template <typename F>
+  void post(F f) {
+    tasks.push([f = std::move(f)](std::stop_token st) mutable { invoke(f, st); });
+  }
+
+  template <typename F>
+  auto submit(F f) {
+    using R = decltype(invoke(f, std::stop_token{}));
+    // std::function 要求可拷贝，promise 放进 shared_ptr
+    auto p = std::make_shared<stop_aware_promise<R>>();
+    auto fut = p->get_future();
+    tasks.push([f = std::move(f), p](std::stop_token st) mutable {
+      try {
+        if constexpr (std::is_void<R>::value) {
+          invoke(f, st);
+          p->set_value();
+        } else {
+          p->set_value(invoke(f, st));
+        }
+      } catch (...) {
+        p->set_exception(std::current_exception());
+      }
+    });
+    return fut;
+  }
+
+  std::size_t size() const { return workers.size(); }
+};
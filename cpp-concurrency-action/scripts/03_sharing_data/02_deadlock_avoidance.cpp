@@ -1,14 +1,9 @@
 #include <iostream>
 #include <mutex>
 #include <thread>
+#include <utility>
 
-struct Account {
-  std::mutex m;
-  int balance;
-  std::string name;
-
-  Account(std::string n, int b) : name(n), balance(b) {}
-};
+#include "utils/account.hpp"
 
 // 交叉转账要同时获取两个账户的锁，可能导致死锁
 void transfer(Account& from, Account& to, int amount) {
@@ -30,6 +25,21 @@ void transfer(Account& from, Account& to, int amount) {
             << ": " << to.balance << "\n";
 }
 
+// 事务内存版本：不加锁，冲突由提交时的版本校验发现并自动重试，涉及多少个账户都不会死锁。
+// 事务体可能执行多次，打印放在事务之外
+void transfer_stm(StmAccount& from, StmAccount& to, int amount) {
+  if (&from == &to) return;
+  auto balances = stm::atomically([&](stm::Tx& tx) {
+    int f = tx.load(from.balance) - amount;
+    int t = tx.load(to.balance) + amount;
+    tx.store(from.balance, f);
+    tx.store(to.balance, t);
+    return std::make_pair(f, t);
+  });
+  std::cout << "Done (STM). " << from.name << ": " << balances.first << ", "
+            << to.name << ": " << balances.second << "\n";
+}
+
 int main() {
   Account a("Gevy", 100);
   Account b("Luose", 100);
@@ -39,5 +49,14 @@ int main() {
 
   t1.join();
   t2.join();
+
+  StmAccount sa("Gevy", 100);
+  StmAccount sb("Luose", 100);
+
+  std::thread t3(transfer_stm, std::ref(sa), std::ref(sb), 10);
+  std::thread t4(transfer_stm, std::ref(sb), std::ref(sa), 20);
+
+  t3.join();
+  t4.join();
   return 0;
 }
\ No newline at end of file
@@ -0,0 +1,204 @@
+/**
+ * @file 06_sharded_cache.cpp
+ * @brief 分片 LRU/TTL 缓存（utils/sharded_cache.hpp）对比 DnsCache（utils/dns_cache.hpp）
+ * 1) 容量与 TTL：CLOCK 淘汰没被再次读到的条目，过期条目读不到；
+ * 2) single-flight：同一冷门域名被 16 个线程同时解析，DnsCache 的 cache-aside 写法
+ *    每个线程都查一次上游，sharded_cache::get_or_load 只查一次；
+ * 3) 基准：Zipf 分布（s=0.99）的域名访问，未命中时查上游并写回。
+ *    DnsCache 无上限地缓存所有见过的域名；sharded_cache 只保留 10% 的容量。
+ * 用法：06_sharded_cache [threads] [ops_per_thread] [keys]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "utils/dns_cache.hpp"
+#include "utils/sharded_cache.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+std::atomic<std::uint64_t> upstream_queries{0};
+
+// 模拟上游 DNS 查询：由域名算出一个固定的 IP
+std::string upstream_lookup(const std::string& domain,
+                            std::chrono::microseconds delay = {}) {
+  upstream_queries.fetch_add(1, std::memory_order_relaxed);
+  if (delay.count()) std::this_thread::sleep_for(delay);
+  std::size_t h = std::hash<std::string>{}(domain);
+  return "10." + std::to_string(h >> 16 & 255) + "." + std::to_string(h >> 8 & 255) +
+         "." + std::to_string(h & 255);
+}
+
+// 秩 k（0 最热）的概率正比于 1 / (k+1)^s
+class zipf_generator {
+  std::vector<double> cdf;
+  std::uniform_real_distribution<double> uniform{0.0, 1.0};
+
+ public:
+  zipf_generator(std::size_t n, double s) : cdf(n) {
+    double sum = 0;
+    for (std::size_t k = 0; k < n; ++k) cdf[k] = sum += 1.0 / std::pow(k + 1.0, s);
+    for (double& c : cdf) c /= sum;
+  }
+
+  template <typename Rng>
+  std::size_t operator()(Rng& rng) {
+    auto it = std::lower_bound(cdf.begin(), cdf.end(), uniform(rng));
+    return std::min<std::size_t>(it - cdf.begin(), cdf.size() - 1);
+  }
+};
+
+void demo_capacity_and_ttl() {
+  using namespace std::chrono_literals;
+  std::cout << "[Capacity + TTL] 1 shard, 4 slots, ttl 50ms\n";
+  sharded_cache<std::string, std::string> cache(4, 50ms, 1);
+  for (const char* d : {"a.com", "b.com", "c.com", "d.com"}) cache.put(d, upstream_lookup(d));
+  cache.get("a.com");  // 只有 a、c 被再次读到
+  cache.get("c.com");
+  cache.put("e.com", upstream_lookup("e.com"));  // 满了：跳过 a，淘汰 b
+  for (const char* d : {"a.com", "b.com", "c.com", "d.com", "e.com"})
+    std::cout << "  " << d << " -> " << cache.get(d).value_or("(evicted)") << "\n";
+  cache.put("short.com", "1.1.1.1", 1ms);
+  std::this_thread::sleep_for(5ms);
+  std::cout << "  short.com (ttl 1ms) after 5ms -> "
+            << cache.get("short.com").value_or("(expired)") << "\n";
+}
+
+void demo_single_flight() {
+  const int n = 16;
+  const auto delay = std::chrono::milliseconds(20);
+  std::cout << "\n[Single-flight] " << n
+            << " threads resolve the same cold domain, upstream takes 20ms\n";
+
+  DnsCache dns;
+  upstream_queries = 0;
+  {
+    std::vector<std::thread> threads;
+    for (int i = 0; i < n; ++i)
+      threads.emplace_back([&] {
+        if (dns.resolve("cold.example.com") == "NXDOMAIN")
+          dns.update("cold.example.com", upstream_lookup("cold.example.com", delay));
+      });
+    for (auto& t : threads) t.join();
+  }
+  std::cout << "  DnsCache (cache-aside)   upstream queries: " << upstream_queries << "\n";
+
+  sharded_cache<std::string, std::string> cache(1024, std::chrono::seconds(60));
+  upstream_queries = 0;
+  {
+    std::vector<std::thread> threads;
+    for (int i = 0; i < n; ++i)
+      threads.emplace_back([&] {
+        cache.get_or_load("cold.example.com",
+                          [&](const std::string& d) { return upstream_lookup(d, delay); });
+      });
+    for (auto& t : threads) t.join();
+  }
+  std::cout << "  sharded_cache::get_or_load upstream queries: " << upstream_queries
+            << " (coalesced " << cache.stats().coalesced << ")\n";
+}
+
+struct bench_result {
+  double mops;
+  double hit_rate;
+  std::uint64_t upstream;
+  std::size_t entries;
+};
+
+template <typename Resolve, typename Size>
+bench_result run_bench(const std::vector<std::string>& domains,
+                       const std::vector<std::vector<std::uint32_t>>& workload,
+                       Resolve resolve, Size size) {
+  upstream_queries = 0;
+  std::atomic<bool> go{false};
+  std::vector<std::thread> threads;
+  for (auto& ops : workload)
+    threads.emplace_back([&] {
+      while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+      for (std::uint32_t k : ops) resolve(domains[k]);
+    });
+  auto t0 = Clock::now();
+  go.store(true, std::memory_order_release);
+  for (auto& t : threads) t.join();
+  double seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+
+  double total = 0;
+  for (auto& ops : workload) total += ops.size();
+  std::uint64_t upstream = upstream_queries.load();
+  return {total / seconds / 1e6, 1.0 - upstream / total, upstream, size()};
+}
+
+void row(const std::string& name, const bench_result& r) {
+  std::cout << std::left << std::setw(16) << name << std::right << std::setw(10)
+            << r.mops << std::setw(10) << r.hit_rate * 100 << std::setw(12)
+            << r.upstream << std::setw(10) << r.entries << "\n";
+}
+
+int main(int argc, char* argv[]) {
+  const unsigned threads =
+      argc > 1 ? std::atoi(argv[1]) : std::max(4u, std::thread::hardware_concurrency());
+  const std::size_t ops = argc > 2 ? std::atoll(argv[2]) : 500000;
+  const std::size_t keys = argc > 3 ? std::atoll(argv[3]) : 100000;
+
+  demo_capacity_and_ttl();
+  demo_single_flight();
+
+  // 预先生成域名与每个线程的访问序列，不把随机数生成算进计时
+  std::vector<std::string> domains;
+  for (std::size_t i = 0; i < keys; ++i)
+    domains.push_back("host" + std::to_string(i) + ".example.com");
+  zipf_generator zipf(keys, 0.99);
+  std::vector<std::vector<std::uint32_t>> workload(threads);
+  for (unsigned t = 0; t < threads; ++t) {
+    std::mt19937_64 rng(t + 1);
+    workload[t].resize(ops);
+    for (auto& k : workload[t]) k = static_cast<std::uint32_t>(zipf(rng));
+  }
+
+  std::cout << "\n[Zipf s=0.99] " << threads << " threads x " << ops << " lookups, "
+            << keys << " domains\n";
+  std::cout << "cache             Mops/s   hit(%)    upstream   entries\n"
+            << std::fixed << std::setprecision(2);
+
+  {
+    DnsCache dns;
+    row("DnsCache", run_bench(
+                        domains, workload,
+                        [&](const std::string& d) {
+                          std::string ip = dns.resolve(d);
+                          if (ip == "NXDOMAIN") dns.update(d, upstream_lookup(d));
+                        },
+                        [&] { return dns.size(); }));
+  }
+  {
+    sharded_cache<std::string, std::string> cache(keys / 10, std::chrono::seconds(60));
+    row("sharded (10%)", run_bench(
+                             domains, workload,
+                             [&](const std::string& d) {
+                               cache.get_or_load(
+                                   d, [](const std::string& k) { return upstream_lookup(k); });
+                             },
+                             [&] { return cache.size(); }));
+  }
+  {
+    sharded_cache<std::string, std::string> cache(keys, std::chrono::seconds(60));
+    row("sharded (100%)", run_bench(
+                              domains, workload,
+                              [&](const std::string& d) {
+                                cache.get_or_load(
+                                    d, [](const std::string& k) { return upstream_lookup(k); });
+                              },
+                              [&] { return cache.size(); }));
+  }
+  return 0;
+}
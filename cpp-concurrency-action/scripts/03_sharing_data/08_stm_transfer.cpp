@@ -0,0 +1,174 @@
+/**
+ * @file 08_stm_transfer.cpp
+ * @brief 软件事务内存（utils/stm.hpp）对比 std::scoped_lock
+ * 1) 多对象工作流：发薪事务一次更新雇主、3 名员工和税务账户，审计线程同时用只读事务
+ *    反复求总额，始终看到一致的快照（总额不变）；
+ * 2) 基准：转账涉及 2 / 4 个账户，账户数从 2 到 65536 变化（越少冲突越激烈），
+ *    对比 scoped_lock 与 STM 的吞吐，以及 STM 的中止率 aborts / (commits + aborts)。
+ * 用法：08_stm_transfer [threads] [ops_per_thread]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "utils/account.hpp"
+#include "utils/stm.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int INITIAL_BALANCE = 1000000;
+
+void demo_payroll() {
+  std::cout << "[Payroll] employer pays 3 employees + tax in one transaction,"
+               " auditor sums all balances concurrently\n";
+  StmAccount employer("employer", 1000000), tax("tax", 0);
+  std::vector<StmAccount> staff(3);
+  const int total = 1000000;
+
+  std::atomic<bool> done{false};
+  std::atomic<int> audits{0}, inconsistent{0};
+  std::thread auditor([&] {
+    while (!done.load()) {
+      int sum = stm::atomically([&](stm::Tx& tx) {
+        int s = tx.load(employer.balance) + tx.load(tax.balance);
+        for (auto& e : staff) s += tx.load(e.balance);
+        return s;
+      });
+      ++audits;
+      if (sum != total) ++inconsistent;
+    }
+  });
+
+  std::vector<std::thread> payroll;
+  for (int t = 0; t < 2; ++t)
+    payroll.emplace_back([&] {
+      for (int month = 0; month < 10000; ++month)
+        stm::atomically([&](stm::Tx& tx) {
+          const int gross = 10, withheld = 2;
+          tx.store(employer.balance, tx.load(employer.balance) - 3 * gross);
+          for (auto& e : staff) tx.store(e.balance, tx.load(e.balance) + gross - withheld);
+          tx.store(tax.balance, tx.load(tax.balance) + 3 * withheld);
+        });
+    });
+  for (auto& t : payroll) t.join();
+  done = true;
+  auditor.join();
+
+  std::cout << "  employer " << employer.balance.unsafe_load() << ", tax "
+            << tax.balance.unsafe_load() << ", staff";
+  for (auto& e : staff) std::cout << " " << e.balance.unsafe_load();
+  std::cout << "\n  " << audits << " audits, " << inconsistent
+            << " saw an inconsistent total\n";
+}
+
+// 从 k 个互不相同的账户中选出 ids：ids[0] 向其余每个账户各转 1
+void pick(std::mt19937& rng, std::size_t n, int k, std::uint32_t* ids) {
+  std::uniform_int_distribution<std::uint32_t> any(0, static_cast<std::uint32_t>(n - 1));
+  for (int i = 0; i < k; ++i) {
+    bool dup;
+    do {
+      ids[i] = any(rng);
+      dup = std::find(ids, ids + i, ids[i]) != ids + i;
+    } while (dup);
+  }
+}
+
+void transfer_locked(std::vector<Account>& acc, const std::uint32_t* ids, int k) {
+  auto apply = [&] {
+    acc[ids[0]].balance -= k - 1;
+    for (int i = 1; i < k; ++i) acc[ids[i]].balance += 1;
+  };
+  if (k == 2) {
+    std::scoped_lock lock(acc[ids[0]].m, acc[ids[1]].m);
+    apply();
+  } else {
+    std::scoped_lock lock(acc[ids[0]].m, acc[ids[1]].m, acc[ids[2]].m, acc[ids[3]].m);
+    apply();
+  }
+}
+
+void transfer_stm(std::vector<StmAccount>& acc, const std::uint32_t* ids, int k) {
+  stm::atomically([&](stm::Tx& tx) {
+    tx.store(acc[ids[0]].balance, tx.load(acc[ids[0]].balance) - (k - 1));
+    for (int i = 1; i < k; ++i)
+      tx.store(acc[ids[i]].balance, tx.load(acc[ids[i]].balance) + 1);
+  });
+}
+
+struct run_result {
+  double mops;
+  double abort_rate;
+};
+
+template <typename Body>
+run_result run(unsigned threads, std::size_t ops, std::size_t n, int k, Body body) {
+  std::atomic<std::uint64_t> commits{0}, aborts{0};
+  std::vector<std::thread> workers;
+  auto t0 = Clock::now();
+  for (unsigned t = 0; t < threads; ++t)
+    workers.emplace_back([&, t] {
+      std::mt19937 rng(t + 1);
+      std::uint32_t ids[4];
+      const stm::tx_stats before = stm::thread_stats();
+      for (std::size_t i = 0; i < ops; ++i) {
+        pick(rng, n, k, ids);
+        body(ids);
+      }
+      commits += stm::thread_stats().commits - before.commits;
+      aborts += stm::thread_stats().aborts - before.aborts;
+    });
+  for (auto& w : workers) w.join();
+  double seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+  double attempts = static_cast<double>(commits + aborts);
+  return {threads * ops / seconds / 1e6, attempts > 0 ? aborts / attempts : 0.0};
+}
+
+int main(int argc, char* argv[]) {
+  const unsigned threads =
+      argc > 1 ? std::atoi(argv[1]) : std::max(4u, std::thread::hardware_concurrency());
+  const std::size_t ops = argc > 2 ? std::atoll(argv[2]) : 200000;
+
+  demo_payroll();
+
+  std::cout << "\n[Contention] " << threads << " threads x " << ops << " transfers\n";
+  std::cout << "legs  accounts  scoped_lock(M/s)   stm(M/s)  stm aborts(%)\n"
+            << std::fixed << std::setprecision(2);
+  for (int k : {2, 4}) {
+    for (std::size_t n : {2, 4, 8, 64, 1024, 65536}) {
+      if (n < static_cast<std::size_t>(k)) continue;
+      std::vector<Account> locked(n);
+      std::vector<StmAccount> tm(n);
+      for (std::size_t i = 0; i < n; ++i) {
+        locked[i].balance = INITIAL_BALANCE;
+        stm::atomically([&](stm::Tx& tx) { tx.store(tm[i].balance, INITIAL_BALANCE); });
+      }
+      auto l = run(threads, ops, n, k,
+                   [&](const std::uint32_t* ids) { transfer_locked(locked, ids, k); });
+      auto s = run(threads, ops, n, k,
+                   [&](const std::uint32_t* ids) { transfer_stm(tm, ids, k); });
+
+      long long sum_l = 0, sum_s = 0;
+      for (std::size_t i = 0; i < n; ++i) {
+        sum_l += locked[i].balance;
+        sum_s += tm[i].balance.unsafe_load();
+      }
+      if (sum_l != sum_s || sum_s != static_cast<long long>(n) * INITIAL_BALANCE) {
+        std::cerr << "balance not conserved\n";
+        return 1;
+      }
+      std::cout << std::setw(4) << k << std::setw(10) << n << std::setw(18) << l.mops
+                << std::setw(11) << s.mops << std::setw(14) << s.abort_rate * 100 << "\n";
+    }
+  }
+  return 0;
+}
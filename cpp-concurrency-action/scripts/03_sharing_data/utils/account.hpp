@@ -0,0 +1,29 @@
+/**
+ * @file account.hpp
+ * @brief 银行账户（交叉转账 / 批量转账 / 事务内存示例共用）
+ * - Account    : 余额由账户自己的互斥锁保护
+ * - StmAccount : 余额是事务变量，只在 stm::atomically 中读写，不需要锁（utils/stm.hpp）
+ */
+
+#pragma once
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "stm.hpp"
+
+struct Account {
+  std::mutex m;
+  int balance;
+  std::string name;
+
+  // 默认构造：便于 std::vector<Account>(n) 批量创建（mutex 不可移动，不能 push_back）
+  Account(std::string n = "", int b = 0) : balance(b), name(std::move(n)) {}
+};
+
+struct StmAccount {
+  stm::tvar<int> balance;
+  std::string name;
+
+  StmAccount(std::string n = "", int b = 0) : balance(b), name(std::move(n)) {}
+};
@@ -0,0 +1,52 @@
+/**
+ * @file dns_cache.hpp
+ * @brief 一把读写锁保护一个 std::map 的 DNS 缓存（读多写少的基线实现）
+ *
+ * 读写锁用 distributed_shared_mutex：读者各写各的计数槽，不再争用同一个读者计数；
+ * 写者阶段与读者阶段交替，持续的读流量不会饿死 update。
+ * read_delay / write_delay 在持锁期间睡眠，用于放大演示读写锁的排队现象；
+ * 基准测试时保持默认 0。没有过期时间，也没有容量上限。
+ */
+
+#pragma once
+#include <chrono>
+#include <map>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+
+#include "distributed_shared_mutex.hpp"
+
+// 需使用 C++17 编译: g++ -std=c++17 ...
+class DnsCache {
+  std::map<std::string, std::string> entries;
+  mutable distributed_shared_mutex sm;
+  std::chrono::milliseconds read_delay;
+  std::chrono::milliseconds write_delay;
+
+ public:
+  explicit DnsCache(std::chrono::milliseconds read_delay = {},
+                    std::chrono::milliseconds write_delay = {})
+      : read_delay(read_delay), write_delay(write_delay) {}
+
+  // 读取操作使用共享锁，允许并发读取
+  std::string resolve(const std::string& domain) const {
+    std::shared_lock<distributed_shared_mutex> lk(sm);
+    if (read_delay.count()) std::this_thread::sleep_for(read_delay);  // 模拟读延迟
+
+    auto it = entries.find(domain);
+    return (it != entries.end()) ? it->second : "NXDOMAIN";
+  }
+
+  // 写者等正在读的读者退出，新来的读者等写者结束
+  void update(const std::string& domain, const std::string& ip) {
+    std::lock_guard<distributed_shared_mutex> lk(sm);
+    entries[domain] = ip;
+    if (write_delay.count()) std::this_thread::sleep_for(write_delay);  // 模拟写延迟
+  }
+
+  std::size_t size() const {
+    std::shared_lock<distributed_shared_mutex> lk(sm);
+    return entries.size();
+  }
+};
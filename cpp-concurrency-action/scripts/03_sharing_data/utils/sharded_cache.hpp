@@ -0,0 +1,241 @@
+/**
+ * @file sharded_cache.hpp
+ * @brief 分片 + TTL + 容量上限（CLOCK 近似 LRU）+ single-flight 加载的并发缓存
+ *
+ * DnsCache 的问题：所有 resolve 争用同一个 shared_mutex 的读者计数（同一缓存行），
+ * 条目永不过期、无限增长。这里：
+ * - 按 key 的哈希分成若干分片，每片一把 shared_mutex、一张索引表和固定数量的槽位；
+ * - 命中只拿共享锁：最近使用信息是槽位上的 referenced 原子位（已置位就不再写），
+ *   不需要像严格 LRU 那样在读路径上拿独占锁移动链表节点；
+ * - 插入时分片满了就用 CLOCK 指针扫描：过期的直接复用，referenced 的清位放过一轮，
+ *   否则淘汰。最多扫两圈；
+ * - get_or_load：同一 key 的并发未命中只有一个线程（leader）调用 loader，
+ *   其余线程等待同一个 shared_future；loader 抛出的异常传给所有等待者，不写入缓存。
+ * Key / Value 需可默认构造、可拷贝（get 返回值的拷贝）。
+ */
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "cache_line.hpp"
+
+struct cache_stats {
+  std::uint64_t misses = 0;     // 不存在或已过期
+  std::uint64_t expired = 0;    // 其中因过期而未命中
+  std::uint64_t loads = 0;      // loader 实际调用次数
+  std::uint64_t coalesced = 0;  // 搭上别人那次加载的未命中
+  std::uint64_t evictions = 0;  // 容量淘汰（不含复用过期槽位）
+};
+
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class sharded_cache {
+ public:
+  using clock = std::chrono::steady_clock;
+
+ private:
+  struct slot {
+    Key key;
+    Value value;
+    clock::time_point expires;
+    std::atomic<bool> referenced{false};
+  };
+
+  struct alignas(CACHE_LINE_SIZE) shard {
+    mutable std::shared_mutex mut;
+    std::unordered_map<Key, std::size_t, Hash> index;  // key → 槽位下标
+    std::unique_ptr<slot[]> slots;
+    std::size_t capacity = 0;
+    std::size_t used = 0;
+    std::size_t hand = 0;  // CLOCK 指针
+
+    std::mutex flight_mut;
+    std::unordered_map<Key, std::shared_future<Value>, Hash> inflight;
+
+    std::atomic<std::uint64_t> misses{0}, expired{0}, loads{0}, coalesced{0},
+        evictions{0};
+
+    // 持独占锁调用：返回一个可写入的槽位下标
+    std::size_t claim_slot(clock::time_point now) {
+      if (used < capacity) return used++;
+      for (;;) {
+        std::size_t i = hand;
+        hand = (hand + 1) % capacity;
+        slot& e = slots[i];
+        if (e.expires > now && e.referenced.exchange(false, std::memory_order_relaxed))
+          continue;  // 最近被读过：放过这一轮
+        if (e.expires > now) evictions.fetch_add(1, std::memory_order_relaxed);
+        // erase 过的槽位其 key 可能已被重新插入到别处，只删指向自己的索引
+        auto it = index.find(e.key);
+        if (it != index.end() && it->second == i) index.erase(it);
+        return i;
+      }
+    }
+  };
+
+  Hash hasher;
+  clock::duration ttl;
+  std::size_t shard_mask;
+  std::unique_ptr<shard[]> shards;
+
+  shard& shard_for(const Key& key) const {
+    // 索引表内部也用同一个哈希取低位，这里先混合再取高位，避免分片与桶相关
+    std::uint64_t h = static_cast<std::uint64_t>(hasher(key)) * 0x9E3779B97F4A7C15ull;
+    return shards[(h >> 32) & shard_mask];
+  }
+
+  std::optional<Value> lookup(const Key& key, bool count_miss) const {
+    shard& s = shard_for(key);
+    std::shared_lock<std::shared_mutex> lk(s.mut);
+    auto it = s.index.find(key);
+    if (it == s.index.end()) {
+      if (count_miss) s.misses.fetch_add(1, std::memory_order_relaxed);
+      return std::nullopt;
+    }
+    slot& e = s.slots[it->second];
+    if (clock::now() >= e.expires) {  // 过期条目留给 CLOCK 复用
+      if (count_miss) {
+        s.misses.fetch_add(1, std::memory_order_relaxed);
+        s.expired.fetch_add(1, std::memory_order_relaxed);
+      }
+      return std::nullopt;
+    }
+    // 先读再写：热点条目的位已经置上，读路径不再弄脏这条缓存行
+    if (!e.referenced.load(std::memory_order_relaxed))
+      e.referenced.store(true, std::memory_order_relaxed);
+    return e.value;
+  }
+
+ public:
+  // capacity 为总条目上限（均分到各分片）；shard_count 向上取整到 2 的幂
+  sharded_cache(std::size_t capacity, clock::duration ttl, std::size_t shard_count = 64)
+      : ttl(ttl) {
+    std::size_t n = 1;
+    while (n < shard_count) n <<= 1;
+    shard_mask = n - 1;
+    shards = std::make_unique<shard[]>(n);
+    const std::size_t per_shard = std::max<std::size_t>(1, (capacity + n - 1) / n);
+    for (std::size_t i = 0; i < n; ++i) {
+      shards[i].capacity = per_shard;
+      shards[i].slots = std::make_unique<slot[]>(per_shard);
+      shards[i].index.reserve(per_shard);
+    }
+  }
+
+  sharded_cache(const sharded_cache&) = delete;
+  sharded_cache& operator=(const sharded_cache&) = delete;
+
+  std::optional<Value> get(const Key& key) const { return lookup(key, true); }
+
+  void put(const Key& key, Value value) { put(key, std::move(value), ttl); }
+
+  void put(const Key& key, Value value, clock::duration entry_ttl) {
+    shard& s = shard_for(key);
+    const auto now = clock::now();
+    std::lock_guard<std::shared_mutex> lk(s.mut);
+    auto it = s.index.find(key);
+    if (it != s.index.end()) {
+      slot& e = s.slots[it->second];
+      e.value = std::move(value);
+      e.expires = now + entry_ttl;
+      e.referenced.store(true, std::memory_order_relaxed);
+      return;
+    }
+    std::size_t i = s.claim_slot(now);
+    slot& e = s.slots[i];
+    e.key = key;
+    e.value = std::move(value);
+    e.expires = now + entry_ttl;
+    e.referenced.store(false, std::memory_order_relaxed);  // 新条目要被再次读到才算“最近使用”
+    s.index.emplace(key, i);
+  }
+
+  bool erase(const Key& key) {
+    shard& s = shard_for(key);
+    std::lock_guard<std::shared_mutex> lk(s.mut);
+    auto it = s.index.find(key);
+    if (it == s.index.end()) return false;
+    s.slots[it->second].expires = clock::time_point::min();  // 槽位由 CLOCK 回收
+    s.index.erase(it);
+    return true;
+  }
+
+  // 命中直接返回；未命中时同一 key 只有一个线程调用 load(key)，结果写入缓存
+  template <typename Loader>
+  Value get_or_load(const Key& key, Loader&& load) {
+    if (auto v = get(key)) return *std::move(v);
+
+    shard& s = shard_for(key);
+    std::promise<Value> promise;
+    std::shared_future<Value> result;
+    bool leader = false;
+    {
+      std::lock_guard<std::mutex> lk(s.flight_mut);
+      auto it = s.inflight.find(key);
+      if (it != s.inflight.end()) {
+        result = it->second;
+      } else {
+        result = promise.get_future().share();
+        s.inflight.emplace(key, result);
+        leader = true;
+      }
+    }
+    if (!leader) {  // 不是 leader：等别人那次加载
+      s.coalesced.fetch_add(1, std::memory_order_relaxed);
+      return result.get();
+    }
+
+    // leader 先复查：上一个 leader 可能刚 put 完并离开 inflight
+    try {
+      if (auto v = lookup(key, false)) {
+        promise.set_value(*std::move(v));
+      } else {
+        s.loads.fetch_add(1, std::memory_order_relaxed);
+        Value loaded = load(key);
+        put(key, loaded);
+        promise.set_value(std::move(loaded));
+      }
+    } catch (...) {
+      promise.set_exception(std::current_exception());
+    }
+    {
+      std::lock_guard<std::mutex> lk(s.flight_mut);
+      s.inflight.erase(key);
+    }
+    return result.get();
+  }
+
+  std::size_t size() const {
+    std::size_t n = 0;
+    for (std::size_t i = 0; i <= shard_mask; ++i) {
+      std::shared_lock<std::shared_mutex> lk(shards[i].mut);
+      n += shards[i].index.size();
+    }
+    return n;
+  }
+
+  cache_stats stats() const {
+    cache_stats out;
+    for (std::size_t i = 0; i <= shard_mask; ++i) {
+      const shard& s = shards[i];
+      out.misses += s.misses.load(std::memory_order_relaxed);
+      out.expired += s.expired.load(std::memory_order_relaxed);
+      out.loads += s.loads.load(std::memory_order_relaxed);
+      out.coalesced += s.coalesced.load(std::memory_order_relaxed);
+      out.evictions += s.evictions.load(std::memory_order_relaxed);
+    }
+    return out;
+  }
+};
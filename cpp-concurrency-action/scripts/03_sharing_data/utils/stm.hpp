@@ -0,0 +1,225 @@
+/**
+ * @file stm.hpp
+ * @brief 基于对象的软件事务内存（TL2：全局版本时钟 + 每对象版本锁 + 读写集）
+ *
+ *   stm::tvar<int> a{100}, b{100};
+ *   stm::atomically([&](stm::Tx& tx) {
+ *     tx.store(a, tx.load(a) - 10);
+ *     tx.store(b, tx.load(b) + 10);
+ *   });
+ *
+ * - 开始：读一次全局时钟，得到读版本 rv；
+ * - load：先查写集（读到自己写过的值），否则按 seqlock 方式读值，要求对象未上锁且
+ *   版本 <= rv，否则说明事务开始后有人提交过它，立即中止（不会看到不一致的快照）；
+ * - store：只写入事务私有的写集，提交前对其他线程不可见；
+ * - 提交：给写集中的对象加锁（拿不到就中止，不等待，所以不会死锁）→ 全局时钟加一得到
+ *   写版本 wv → 若期间有其他提交（wv != rv + 1）则重新校验读集 → 写回 → 以 wv 解锁。
+ *   只读事务不加锁、不碰全局时钟。
+ * 中止通过内部异常展开用户的 lambda，随机退避后重试；用户代码抛出的其他异常会放弃
+ * 事务（什么都不写）并继续向外传播。事务体可能被执行多次，里面不要有 I/O 等副作用；
+ * 不支持嵌套调用 atomically。
+ * tvar<T> 要求 T 可平凡复制（值存放在 std::atomic<T> 中）。
+ */
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "spin_wait.hpp"
+
+namespace stm {
+
+// 全局版本时钟
+inline std::atomic<std::uint64_t> global_clock{0};
+
+// 每个线程的提交 / 中止计数
+struct tx_stats {
+  std::uint64_t commits = 0;
+  std::uint64_t aborts = 0;
+};
+
+inline tx_stats& thread_stats() {
+  thread_local tx_stats stats;
+  return stats;
+}
+
+class Tx;
+
+// 版本锁：最低位是锁位，其余位是最近一次提交的写版本
+class tvar_base {
+ protected:
+  std::atomic<std::uint64_t> lock_word{0};
+
+  virtual void publish(const unsigned char* bytes) = 0;
+  virtual ~tvar_base() = default;
+
+  friend class Tx;
+};
+
+template <typename T>
+class tvar : public tvar_base {
+  static_assert(std::is_trivially_copyable<T>::value, "tvar<T> requires trivially copyable T");
+  std::atomic<T> value;
+
+  void publish(const unsigned char* bytes) override {
+    T v;
+    std::memcpy(&v, bytes, sizeof(T));
+    value.store(v, std::memory_order_relaxed);
+  }
+
+  friend class Tx;
+
+ public:
+  explicit tvar(T init = T()) : value(init) {}
+  tvar(const tvar&) = delete;
+  tvar& operator=(const tvar&) = delete;
+
+  // 事务之外的读取（例如全部线程结束后核对结果）
+  T unsafe_load() const { return value.load(std::memory_order_relaxed); }
+};
+
+class Tx {
+  struct abort_tx {};
+
+  struct write_entry {
+    tvar_base* var;
+    std::size_t offset;  // 新值在 buffer 中的位置
+  };
+
+  std::uint64_t rv = 0;
+  std::vector<const tvar_base*> read_set;
+  std::vector<write_entry> write_set;
+  std::vector<unsigned char> buffer;
+
+  static constexpr std::uint64_t LOCKED = 1;
+
+  const write_entry* find_write(const tvar_base* var) const {
+    for (auto& w : write_set)
+      if (w.var == var) return &w;
+    return nullptr;
+  }
+
+  void begin() {
+    rv = global_clock.load(std::memory_order_acquire);
+    read_set.clear();
+    write_set.clear();
+    buffer.clear();
+  }
+
+  [[noreturn]] static void abort() { throw abort_tx{}; }
+
+  void unlock_writes(std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+      auto& w = write_set[i].var->lock_word;
+      w.store(w.load(std::memory_order_relaxed) & ~LOCKED, std::memory_order_release);
+    }
+  }
+
+  bool commit() {
+    if (write_set.empty()) return true;  // 只读事务：所有读取在读时已对 rv 校验过
+
+    for (std::size_t i = 0; i < write_set.size(); ++i) {
+      auto& w = write_set[i].var->lock_word;
+      std::uint64_t cur = w.load(std::memory_order_relaxed);
+      if ((cur & LOCKED) ||
+          !w.compare_exchange_strong(cur, cur | LOCKED, std::memory_order_acquire)) {
+        unlock_writes(i);
+        return false;
+      }
+    }
+    // 与 seqlock 读者的 acquire fence 配对：读者看到新值时必然也看到锁位
+    std::atomic_thread_fence(std::memory_order_release);
+
+    const std::uint64_t wv = global_clock.fetch_add(1, std::memory_order_acq_rel) + 1;
+    if (wv != rv + 1) {
+      for (const tvar_base* var : read_set) {
+        std::uint64_t cur = var->lock_word.load(std::memory_order_acquire);
+        bool locked_by_other = (cur & LOCKED) && !find_write(var);
+        if (locked_by_other || (cur >> 1) > rv) {
+          unlock_writes(write_set.size());
+          return false;
+        }
+      }
+    }
+
+    for (auto& w : write_set) w.var->publish(buffer.data() + w.offset);
+    for (auto& w : write_set)
+      w.var->lock_word.store(wv << 1, std::memory_order_release);
+    return true;
+  }
+
+  template <typename F>
+  friend auto atomically(F&& f) -> decltype(f(std::declval<Tx&>()));
+
+ public:
+  template <typename T>
+  T load(const tvar<T>& var) {
+    if (auto* w = find_write(&var)) {
+      T v;
+      std::memcpy(&v, buffer.data() + w->offset, sizeof(T));
+      return v;
+    }
+    const std::uint64_t v1 = var.lock_word.load(std::memory_order_acquire);
+    T value = var.value.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const std::uint64_t v2 = var.lock_word.load(std::memory_order_relaxed);
+    if (v1 != v2 || (v1 & LOCKED) || (v1 >> 1) > rv) abort();
+    read_set.push_back(&var);
+    return value;
+  }
+
+  template <typename T>
+  void store(tvar<T>& var, const T& value) {
+    std::size_t offset;
+    if (auto* w = find_write(&var)) {
+      offset = w->offset;
+    } else {
+      offset = buffer.size();
+      buffer.resize(offset + sizeof(T));
+      write_set.push_back({&var, offset});
+    }
+    std::memcpy(buffer.data() + offset, &value, sizeof(T));
+  }
+};
+
+// 执行事务直到提交成功，返回事务体的返回值
+template <typename F>
+auto atomically(F&& f) -> decltype(f(std::declval<Tx&>())) {
+  using R = decltype(f(std::declval<Tx&>()));
+  thread_local Tx tx;  // 复用读写集的内存
+  thread_local std::minstd_rand rng(std::random_device{}());
+  tx_stats& stats = thread_stats();
+  for (unsigned attempt = 0;; ++attempt) {
+    tx.begin();
+    try {
+      if constexpr (std::is_void<R>::value) {
+        f(tx);
+        if (tx.commit()) {
+          ++stats.commits;
+          return;
+        }
+      } else {
+        R result = f(tx);
+        if (tx.commit()) {
+          ++stats.commits;
+          return result;
+        }
+      }
+    } catch (const Tx::abort_tx&) {
+    }
+    ++stats.aborts;
+    // 随机指数退避，避免几个冲突的事务步调一致地反复互相中止
+    const unsigned limit = 1u << std::min(attempt, 10u);
+    for (unsigned i = rng() % limit; i > 0; --i) cpu_relax();
+    if (attempt >= 10 || default_spin_limit() == 0) std::this_thread::yield();
+  }
+}
+
+}  // namespace stm
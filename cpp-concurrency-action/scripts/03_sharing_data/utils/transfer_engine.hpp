@@ -0,0 +1,259 @@
+/**
+ * @file transfer_engine.hpp
+ * @brief 批量转账引擎：一批多腿转账，每笔原子执行，永不死锁
+ *
+ * 每笔转账可以有多条腿（from → to, amount），整笔要么全部生效，要么全部不生效
+ * （任一账户余额会变成负数就整笔拒绝）。两种执行策略：
+ * - execute_locked      : 每个线程把自己那段切成 chunk 笔一组，一组涉及的账户去重后
+ *                         按编号升序加锁（全局锁序，不会成环），执行整组再解锁；
+ *                         热点账户每组只加一次锁，而不是每笔一次。chunk = 1 即逐笔加锁。
+ * - execute_partitioned : 先按账户冲突把批次分轮：每笔放进“它涉及的账户上一次出现的
+ *                         轮次 + 1”，同一轮内的转账两两不冲突，可以并行且完全不加锁；
+ *                         轮与轮之间用栅栏隔开。结果与按批内顺序串行执行完全相同。
+ *                         热点账户让轮数变多，相邻的小轮合并成一段由一个线程串行跑完。
+ * 执行期间不允许其他代码绕过引擎修改这些账户。
+ */
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "account.hpp"
+#include "event_count.hpp"
+#include "spin_wait.hpp"
+
+struct transfer_leg {
+  std::uint32_t from;
+  std::uint32_t to;
+  int amount;
+};
+
+// 扁平存储：第 i 笔转账是 legs[offsets[i], offsets[i + 1])
+class transfer_batch {
+  std::vector<transfer_leg> legs;
+  std::vector<std::uint32_t> offsets{0};
+
+ public:
+  void add(std::uint32_t from, std::uint32_t to, int amount) {
+    legs.push_back({from, to, amount});
+    offsets.push_back(static_cast<std::uint32_t>(legs.size()));
+  }
+
+  void add(std::initializer_list<transfer_leg> tx) {
+    legs.insert(legs.end(), tx.begin(), tx.end());
+    offsets.push_back(static_cast<std::uint32_t>(legs.size()));
+  }
+
+  std::size_t size() const { return offsets.size() - 1; }
+  const transfer_leg* begin(std::size_t i) const { return legs.data() + offsets[i]; }
+  const transfer_leg* end(std::size_t i) const { return legs.data() + offsets[i + 1]; }
+
+  void clear() {
+    legs.clear();
+    offsets.assign(1, 0);
+  }
+};
+
+struct batch_result {
+  std::size_t committed = 0;
+  std::size_t rejected = 0;
+
+  batch_result& operator+=(const batch_result& o) {
+    committed += o.committed;
+    rejected += o.rejected;
+    return *this;
+  }
+};
+
+class transfer_engine {
+  std::vector<Account>& accounts;
+  const unsigned threads;
+
+  // 分轮用的账户标记：高 32 位是批次号，低 32 位是该账户最近所在的轮次。
+  // 带批次号就不必每批把百万个标记清零
+  std::vector<std::uint64_t> last_round;
+  std::uint32_t batch_id = 0;
+
+  // C++17 没有 std::barrier：代数翻转栅栏，先自旋再睡在 event_count 上
+  class barrier {
+    std::atomic<std::uint32_t> count;
+    std::atomic<std::uint32_t> generation{0};
+    const std::uint32_t expected;
+    event_count ec;
+
+   public:
+    explicit barrier(std::uint32_t n) : count(n), expected(n) {}
+
+    void arrive_and_wait() {
+      const std::uint32_t gen = generation.load(std::memory_order_acquire);
+      if (count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        count.store(expected, std::memory_order_relaxed);
+        generation.store(gen + 1, std::memory_order_release);
+        ec.notify_all();
+        return;
+      }
+      auto passed = [&] { return generation.load(std::memory_order_acquire) != gen; };
+      for (int i = 0, limit = default_spin_limit(); i < limit; ++i) {
+        if (passed()) return;
+        cpu_relax();
+      }
+      while (!passed()) {
+        auto key = ec.prepare_wait();
+        if (passed()) {
+          ec.cancel_wait();
+          return;
+        }
+        ec.commit_wait(key);
+      }
+    }
+  };
+
+  // 调用者已持有（或独占）所涉及的全部账户：检查余额后整笔生效或整笔拒绝
+  bool apply(const transfer_leg* first, const transfer_leg* last,
+             std::vector<std::pair<std::uint32_t, int>>& delta) {
+    delta.clear();
+    auto add = [&delta](std::uint32_t id, int d) {
+      for (auto& e : delta)
+        if (e.first == id) {
+          e.second += d;
+          return;
+        }
+      delta.emplace_back(id, d);
+    };
+    for (auto* leg = first; leg != last; ++leg) {
+      add(leg->from, -leg->amount);
+      add(leg->to, leg->amount);
+    }
+    for (auto& e : delta)
+      if (accounts[e.first].balance + e.second < 0) return false;
+    for (auto& e : delta) accounts[e.first].balance += e.second;
+    return true;
+  }
+
+  template <typename F>
+  void run_workers(F f) {
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; ++t) workers.emplace_back(f, t);
+    f(0u);
+    for (auto& w : workers) w.join();
+  }
+
+ public:
+  explicit transfer_engine(std::vector<Account>& accounts,
+                           unsigned threads = std::thread::hardware_concurrency())
+      : accounts(accounts),
+        threads(std::max(1u, threads)),
+        last_round(accounts.size(), 0) {}
+
+  unsigned thread_count() const { return threads; }
+
+  batch_result execute_locked(const transfer_batch& batch, std::size_t chunk = 64) {
+    std::vector<batch_result> results(threads);
+    run_workers([&](unsigned t) {
+      const std::size_t n = batch.size();
+      const std::size_t lo = n * t / threads, hi = n * (t + 1) / threads;
+      std::vector<std::uint32_t> ids;
+      std::vector<std::pair<std::uint32_t, int>> delta;
+      batch_result r;
+      for (std::size_t i = lo; i < hi; i += chunk) {
+        const std::size_t j = std::min(hi, i + chunk);
+        ids.clear();
+        for (std::size_t k = i; k < j; ++k)
+          for (auto* leg = batch.begin(k); leg != batch.end(k); ++leg) {
+            ids.push_back(leg->from);
+            ids.push_back(leg->to);
+          }
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+        for (std::uint32_t id : ids) accounts[id].m.lock();  // 全局锁序：编号升序
+        for (std::size_t k = i; k < j; ++k)
+          ++(apply(batch.begin(k), batch.end(k), delta) ? r.committed : r.rejected);
+        for (auto it = ids.rbegin(); it != ids.rend(); ++it) accounts[*it].m.unlock();
+      }
+      results[t] = r;
+    });
+    batch_result total;
+    for (auto& r : results) total += r;
+    return total;
+  }
+
+  // 小于 min_parallel 笔的轮与相邻小轮合并，由 0 号线程串行执行
+  batch_result execute_partitioned(const transfer_batch& batch,
+                                   std::size_t min_parallel = 1024) {
+    const std::size_t n = batch.size();
+    const std::uint64_t stamp = static_cast<std::uint64_t>(++batch_id) << 32;
+
+    // 1. 分轮：round = 1 + 所涉账户上一次出现的轮次中的最大值
+    std::vector<std::uint32_t> round(n);
+    std::uint32_t rounds = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+      std::uint32_t r = 0;
+      for (auto* leg = batch.begin(i); leg != batch.end(i); ++leg)
+        for (std::uint32_t id : {leg->from, leg->to}) {
+          std::uint64_t s = last_round[id];
+          if ((s & ~0xffffffffull) == stamp)
+            r = std::max(r, static_cast<std::uint32_t>(s) + 1);
+        }
+      for (auto* leg = batch.begin(i); leg != batch.end(i); ++leg)
+        for (std::uint32_t id : {leg->from, leg->to}) last_round[id] = stamp | r;
+      round[i] = r;
+      rounds = std::max(rounds, r + 1);
+    }
+
+    // 2. 按轮计数排序（轮内保持批内顺序）
+    std::vector<std::size_t> start(rounds + 1, 0);
+    for (std::uint32_t r : round) ++start[r + 1];
+    for (std::uint32_t r = 0; r < rounds; ++r) start[r + 1] += start[r];
+    std::vector<std::uint32_t> order(n);
+    {
+      std::vector<std::size_t> pos(start.begin(), start.end() - 1);
+      for (std::size_t i = 0; i < n; ++i) order[pos[round[i]]++] = static_cast<std::uint32_t>(i);
+    }
+
+    // 3. 切段：大轮并行，连续的小轮合并成串行段
+    struct segment {
+      std::size_t begin, end;
+      bool parallel;
+    };
+    std::vector<segment> segments;
+    for (std::uint32_t r = 0; r < rounds; ++r) {
+      const bool big = threads > 1 && start[r + 1] - start[r] >= min_parallel;
+      if (!big && !segments.empty() && !segments.back().parallel)
+        segments.back().end = start[r + 1];
+      else
+        segments.push_back({start[r], start[r + 1], big});
+    }
+
+    // 4. 执行：同一段内互不冲突，无需加锁；段之间用栅栏保证先后与可见性
+    std::vector<batch_result> results(threads);
+    barrier sync(threads);
+    run_workers([&](unsigned t) {
+      std::vector<std::pair<std::uint32_t, int>> delta;
+      batch_result r;
+      for (const segment& seg : segments) {
+        std::size_t lo = seg.begin, hi = seg.end;
+        if (seg.parallel) {
+          const std::size_t len = seg.end - seg.begin;
+          lo = seg.begin + len * t / threads;
+          hi = seg.begin + len * (t + 1) / threads;
+        } else if (t != 0) {
+          lo = hi;
+        }
+        for (std::size_t k = lo; k < hi; ++k)
+          ++(apply(batch.begin(order[k]), batch.end(order[k]), delta) ? r.committed
+                                                                      : r.rejected);
+        if (threads > 1) sync.arrive_and_wait();
+      }
+      results[t] = r;
+    });
+    batch_result total;
+    for (auto& r : results) total += r;
+    return total;
+  }
+};
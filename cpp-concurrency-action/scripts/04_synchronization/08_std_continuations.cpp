@@ -0,0 +1,161 @@
+/**
+ * @file 08_std_continuations.cpp
+ * @brief 不依赖 Boost 的链式异步任务（then / when_all / when_any）
+ * 用 utils/continuable_future.hpp 重写 07_boost_chaining.cpp 中的
+ * 认证 -> 查用户名 -> 记日志 流水线，延续运行在线程池或内联执行，
+ * 不会像 Boost 默认策略那样为每个延续新开线程。
+ * 最后对比链式延续的端到端延迟（定义 WITH_BOOST_FUTURE 时同时测 Boost）。
+ */
+
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "thread_pool.hpp"
+#include "utils/continuable_future.hpp"
+
+#ifdef WITH_BOOST_FUTURE
+#define BOOST_THREAD_PROVIDES_FUTURE
+#define BOOST_THREAD_PROVIDES_FUTURE_CONTINUATION
+#include <boost/thread/future.hpp>
+#endif
+
+int authenticate() {
+  std::cout << "[Auth] Verifying user...\n";
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  return 101;
+}
+
+std::string get_username(int id) {
+  std::cout << "[DB] Getting name for ID " << id << "...\n";
+  return "Alice";
+}
+
+void log_user_login(int id, const std::string& name) {
+  std::cout << "[Log] User " << name << " (" << id << ") logged in.\n";
+}
+
+// ------------------------- 链式延迟基准 -------------------------
+// 预先挂好 DEPTH 级 then，计时从 set_value 开始到链尾结果可取为止
+
+constexpr int DEPTH = 16;
+constexpr int ROUNDS = 200;
+
+template <typename Executor>
+double cont_chain_latency_us(Executor& ex) {
+  double total = 0;
+  for (int r = 0; r < ROUNDS; ++r) {
+    cont::promise<int> p;
+    cont::future<int> f = p.get_future();
+    for (int i = 0; i < DEPTH; ++i)
+      f = f.then(ex, [](cont::future<int> prev) { return prev.get() + 1; });
+
+    auto start = std::chrono::steady_clock::now();
+    p.set_value(0);
+    int v = f.get();
+    auto end = std::chrono::steady_clock::now();
+    if (v != DEPTH) throw std::logic_error("chain result mismatch");
+    total += std::chrono::duration<double, std::micro>(end - start).count();
+  }
+  return total / ROUNDS;
+}
+
+#ifdef WITH_BOOST_FUTURE
+double boost_chain_latency_us(boost::launch policy) {
+  double total = 0;
+  for (int r = 0; r < ROUNDS; ++r) {
+    boost::promise<int> p;
+    boost::future<int> f = p.get_future();
+    for (int i = 0; i < DEPTH; ++i)
+      f = f.then(policy, [](boost::future<int> prev) { return prev.get() + 1; });
+
+    auto start = std::chrono::steady_clock::now();
+    p.set_value(0);
+    int v = f.get();
+    auto end = std::chrono::steady_clock::now();
+    if (v != DEPTH) throw std::logic_error("chain result mismatch");
+    total += std::chrono::duration<double, std::micro>(end - start).count();
+  }
+  return total / ROUNDS;
+}
+#endif
+
+int main() {
+  thread_pool pool(2);
+
+  // 1. 认证用户（在线程池上执行），返回用户ID future<int>
+  cont::future<int> f1 = cont::async(pool, authenticate);
+
+  // 2. 查用户名的延续投递到线程池
+  cont::future<std::string> f2 =
+      f1.then(pool, [](cont::future<int> prev_f) {
+        return get_username(prev_f.get());
+      });
+
+  // 3. 记日志的延续内联执行（在完成 f2 的线程上）
+  cont::future<void> f3 = f2.then([](cont::future<std::string> name_f) {
+    log_user_login(101, name_f.get());
+  });
+  f3.get();
+
+  // ------------------------- when_all -------------------------
+  auto t1 = cont::async(pool, [] { return 100; });
+  auto t2 = cont::async(pool, [] { return std::string("Bob"); });
+
+  cont::future<void> f4 =
+      cont::when_all(std::move(t1), std::move(t2))
+          .then([](cont::future<std::tuple<cont::future<int>,
+                                           cont::future<std::string>>>
+                       result_f) {
+            auto results = result_f.get();
+            int id = std::get<0>(results).get();
+            std::string name = std::get<1>(results).get();
+            log_user_login(id, name);
+          });  // Wait(A & B) -> C
+  f4.get();
+
+  // ------------------------- when_any -------------------------
+  std::vector<cont::future<std::string>> replicas;
+  for (int delay_ms : {50, 10, 30}) {
+    replicas.push_back(cont::async(pool, [delay_ms] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms));
+      return "replica-" + std::to_string(delay_ms) + "ms";
+    }));
+  }
+  auto first = cont::when_any(replicas.begin(), replicas.end()).get();
+  std::cout << "[when_any] First answer from #" << first.index << ": "
+            << first.futures[first.index].get() << "\n";
+
+  // ------------------------- 异常沿链传播 -------------------------
+  auto failed = cont::async(pool, []() -> int {
+                  throw std::runtime_error("Auth server down");
+                }).then([](cont::future<int> prev) {
+    return get_username(prev.get());  // get() 重新抛出，跳过查询
+  });
+  try {
+    failed.get();
+  } catch (const std::exception& e) {
+    std::cout << "[Error] Chain aborted: " << e.what() << "\n";
+  }
+
+  // ------------------------- 基准 -------------------------
+  std::cout << "\nChain latency (" << DEPTH << " continuations, avg of "
+            << ROUNDS << " rounds):\n";
+  inline_executor inline_ex;
+  std::cout << "  cont::future  inline       : "
+            << cont_chain_latency_us(inline_ex) << " us\n";
+  std::cout << "  cont::future  thread_pool  : "
+            << cont_chain_latency_us(pool) << " us\n";
+#ifdef WITH_BOOST_FUTURE
+  std::cout << "  boost::future launch::sync : "
+            << boost_chain_latency_us(boost::launch::sync) << " us\n";
+  std::cout << "  boost::future launch::async: "
+            << boost_chain_latency_us(boost::launch::async) << " us\n";
+#else
+  std::cout << "  (Boost not found, skipping boost::future baseline)\n";
+#endif
+  return 0;
+}
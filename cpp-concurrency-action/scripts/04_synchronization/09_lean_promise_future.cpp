@@ -0,0 +1,195 @@
+/**
+ * @file 09_lean_promise_future.cpp
+ * @brief 轻量级 promise/future（utils/lean_future.hpp）与 std 版本对比
+ * 1) 异常传播、shared_future 广播语义与 04/05 示例一致；
+ *    两个线程同时 set_value 时只有一个成功，另一个得到 promise_already_satisfied；
+ * 2) 基准：单线程 create+set+get、跨线程 set->get、广播唤醒 N 个等待者。
+ */
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "utils/lean_future.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+double ns_per_op(Clock::time_point start, Clock::time_point end, long ops) {
+  return std::chrono::duration<double, std::nano>(end - start).count() / ops;
+}
+
+// ------------------------- 单线程：创建 + 设置 + 获取 -------------------------
+template <typename Promise, typename... Tag>
+double bench_create_set_get(long iterations, Tag... tag) {
+  long sum = 0;
+  auto start = Clock::now();
+  for (long i = 0; i < iterations; ++i) {
+    Promise p(tag...);
+    auto f = p.get_future();
+    p.set_value(static_cast<int>(i));
+    sum += f.get();
+  }
+  auto end = Clock::now();
+  if (sum < 0) std::cout << "";  // 防止被优化掉
+  return ns_per_op(start, end, iterations);
+}
+
+// ------------------------- 跨线程：RPC 风格请求/应答 -------------------------
+// 调用方创建 promise 交给服务线程，自己阻塞在 get() 上
+template <typename Promise, typename... Tag>
+double bench_cross_thread(long iterations, Tag... tag) {
+  std::vector<Promise> slots;
+  slots.reserve(iterations);
+  std::atomic<long> published{0};
+
+  std::thread server([&] {
+    for (long i = 0; i < iterations; ++i) {
+      while (published.load(std::memory_order_acquire) <= i)
+        std::this_thread::yield();
+      slots[i].set_value(static_cast<int>(i));
+    }
+  });
+
+  auto start = Clock::now();
+  for (long i = 0; i < iterations; ++i) {
+    slots.emplace_back(tag...);
+    auto f = slots.back().get_future();
+    published.store(i + 1, std::memory_order_release);
+    if (f.get() != i) throw std::logic_error("value mismatch");
+  }
+  auto end = Clock::now();
+  server.join();
+  return ns_per_op(start, end, iterations);
+}
+
+// ------------------------- 广播：一次 set 唤醒 N 个等待者 -------------------------
+template <typename Promise>
+double bench_broadcast_us(int waiters, int rounds) {
+  double total = 0;
+  for (int r = 0; r < rounds; ++r) {
+    Promise p;
+    auto sf = p.get_future().share();
+    std::atomic<int> ready{0};
+    std::atomic<long long> last_wake_ns{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < waiters; ++i) {
+      threads.emplace_back([sf, &ready, &last_wake_ns] {
+        ready.fetch_add(1);
+        sf.get();
+        long long now = Clock::now().time_since_epoch().count();
+        long long prev = last_wake_ns.load();
+        while (prev < now && !last_wake_ns.compare_exchange_weak(prev, now));
+      });
+    }
+    while (ready.load() < waiters) std::this_thread::yield();
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));  // 让等待者真正睡下
+
+    auto start = Clock::now();
+    p.set_value(1);
+    for (auto& t : threads) t.join();
+    total += std::chrono::duration<double, std::micro>(
+                 Clock::duration(last_wake_ns.load()) -
+                 start.time_since_epoch())
+                 .count();
+  }
+  return total / rounds;
+}
+
+int main() {
+  // 1. 异常传播（对应 04_promise_future.cpp）
+  {
+    lean::promise<int> p;
+    lean::future<int> f = p.get_future();
+    std::thread t([&p] {
+      try {
+        throw std::runtime_error("Error in promise!");
+      } catch (...) {
+        p.set_exception(std::current_exception());
+      }
+    });
+    try {
+      std::cout << "Promise Result: " << f.get() << "\n";
+    } catch (const std::exception& e) {
+      std::cout << "Promise Exception: " << e.what() << "\n";
+    }
+    t.join();
+  }
+
+  // 2. 广播（对应 05_shared_future.cpp）
+  {
+    lean::promise<int> p;
+    lean::shared_future<int> sf = p.get_future().share();
+    std::vector<std::thread> threads;
+    for (int id = 1; id <= 3; ++id) {
+      threads.emplace_back([sf, id] {
+        int result = sf.get();
+        std::cout << "[Thread " << id << "] Result: " << result << "\n";
+      });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    std::cout << "Main: Setting value to 888 (Broadcast)...\n";
+    p.set_value(888);  // 一次 notify_all 唤醒全部等待者
+    for (auto& t : threads) t.join();
+  }
+
+  // 3. 两个线程抢着设置同一个 promise：恰好一个成功，future 读到的就是它的值
+  {
+    const int ROUNDS = 200;
+    int ok_rounds = 0;
+    for (int r = 0; r < ROUNDS; ++r) {
+      lean::promise<std::vector<int>> p;
+      auto f = p.get_future();
+      std::atomic<int> winner{-1}, rejected{0};
+      std::vector<std::thread> setters;
+      for (int id = 0; id < 2; ++id)
+        setters.emplace_back([&, id] {
+          try {
+            p.set_value(std::vector<int>(1000, id));
+            winner = id;
+          } catch (const std::future_error& e) {
+            if (e.code() == std::future_errc::promise_already_satisfied) ++rejected;
+          }
+        });
+      for (auto& t : setters) t.join();
+      const std::vector<int> v = f.get();
+      if (rejected == 1 && winner >= 0 && v == std::vector<int>(1000, winner.load())) ++ok_rounds;
+    }
+    std::cout << "Racing setters: " << ok_rounds << "/" << ROUNDS
+              << " rounds with exactly one winner\n";
+    if (ok_rounds != ROUNDS) return 1;
+  }
+
+  // 4. 基准
+  const long N = 1000000;
+  std::cout << "\ncreate+set+get, same thread (" << N << " ops):\n";
+  std::cout << "  std::promise          : "
+            << bench_create_set_get<std::promise<int>>(N) << " ns/op\n";
+  std::cout << "  lean::promise         : "
+            << bench_create_set_get<lean::promise<int>>(N) << " ns/op\n";
+  std::cout << "  lean::promise(pooled) : "
+            << bench_create_set_get<lean::promise<int>>(N, lean::pooled)
+            << " ns/op\n";
+
+  const long M = 100000;
+  std::cout << "\ncreate+set+get, cross thread (" << M << " ops):\n";
+  std::cout << "  std::promise          : "
+            << bench_cross_thread<std::promise<int>>(M) << " ns/op\n";
+  std::cout << "  lean::promise         : "
+            << bench_cross_thread<lean::promise<int>>(M) << " ns/op\n";
+  std::cout << "  lean::promise(pooled) : "
+            << bench_cross_thread<lean::promise<int>>(M, lean::pooled)
+            << " ns/op\n";
+
+  const int WAITERS = 8;
+  std::cout << "\nbroadcast wake-up of " << WAITERS
+            << " waiters (set -> last waiter awake):\n";
+  std::cout << "  std::shared_future    : "
+            << bench_broadcast_us<std::promise<int>>(WAITERS, 20) << " us\n";
+  std::cout << "  lean::shared_future   : "
+            << bench_broadcast_us<lean::promise<int>>(WAITERS, 20) << " us\n";
+  return 0;
+}
@@ -0,0 +1,154 @@
+/**
+ * @file 10_coroutine_task.cpp
+ * @brief C++20 协程 task<T> 与线程池、队列、定时器集成
+ * 前面的异步示例都让线程阻塞在 future::get() 上；协程挂起时只保留一个协程帧，
+ * 因此几万个并发中的操作只需要少量线程。
+ * 1) schedule_on(pool) 切换执行线程；2) when_all 汇合大量定时等待；
+ * 3) co_await queue.pop() 生产者-消费者；4) 基准：协程交接 vs 线程 + 条件变量交接。
+ */
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "thread_pool.hpp"
+#include "thread_safe_queue.hpp"
+#include "utils/async_timer.hpp"
+#include "utils/awaitable_queue.hpp"
+#include "utils/task.hpp"
+
+using namespace std::chrono_literals;
+using Clock = std::chrono::steady_clock;
+
+coro::task<int> authenticate(thread_pool& pool) {
+  co_await coro::schedule_on(pool);  // 之后的代码运行在线程池上
+  std::cout << "[Auth] Verifying user on thread " << std::this_thread::get_id()
+            << "\n";
+  co_return 101;
+}
+
+coro::task<std::string> login(thread_pool& pool) {
+  int id = co_await authenticate(pool);  // 不阻塞任何线程
+  co_return "Alice#" + std::to_string(id);
+}
+
+// 模拟一次带超时的 RPC：挂起期间不占线程
+coro::task<int> fake_rpc(coro::timer_queue& timers, int i) {
+  co_await timers.sleep_for(50ms);
+  co_return i;
+}
+
+coro::task<long> fan_out(coro::timer_queue& timers, int n) {
+  std::vector<coro::task<int>> calls;
+  calls.reserve(n);
+  for (int i = 0; i < n; ++i) calls.push_back(fake_rpc(timers, i));
+  std::vector<int> results = co_await coro::when_all(std::move(calls));
+  co_return std::accumulate(results.begin(), results.end(), 0L);
+}
+
+// 只能移动、没有默认构造函数的消息：awaitable_queue 不要求 T 可默认构造
+struct job {
+  std::unique_ptr<int> payload;
+  explicit job(int v) : payload(std::make_unique<int>(v)) {}
+};
+
+coro::task<int> consumer(coro::awaitable_queue<job>& q, int count) {
+  int sum = 0;
+  for (int i = 0; i < count; ++i) sum += *(co_await q.pop()).payload;
+  co_return sum;
+}
+
+// ------------------------- 交接（上下文切换）基准 -------------------------
+// ping 把数字交给 pong，pong 加一后交回：每轮两次交接
+
+coro::task<void> pong(coro::awaitable_queue<int>& in,
+                      coro::awaitable_queue<int>& out, int rounds) {
+  for (int i = 0; i < rounds; ++i) out.push(co_await in.pop() + 1);
+}
+
+coro::task<void> ping(coro::awaitable_queue<int>& in,
+                      coro::awaitable_queue<int>& out, int rounds) {
+  int v = 0;
+  for (int i = 0; i < rounds; ++i) {
+    out.push(v);
+    v = co_await in.pop();
+  }
+  if (v != rounds) throw std::logic_error("ping-pong mismatch");
+}
+
+double coroutine_handoff_ns(int rounds) {
+  coro::awaitable_queue<int> to_pong, to_ping;
+  std::vector<coro::task<void>> players;
+  players.push_back(pong(to_pong, to_ping, rounds));
+  players.push_back(ping(to_ping, to_pong, rounds));
+  auto start = Clock::now();
+  coro::sync_wait(coro::when_all(std::move(players)));
+  auto end = Clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count() /
+         (2.0 * rounds);
+}
+
+double thread_handoff_ns(int rounds) {
+  thread_safe_queue<int> to_pong, to_ping;
+  std::thread ponger([&] {
+    for (int i = 0; i < rounds; ++i) {
+      int v;
+      to_pong.wait_and_pop(v);
+      to_ping.push(v + 1);
+    }
+  });
+  auto start = Clock::now();
+  int v = 0;
+  for (int i = 0; i < rounds; ++i) {
+    to_pong.push(v);
+    to_ping.wait_and_pop(v);
+  }
+  auto end = Clock::now();
+  ponger.join();
+  return std::chrono::duration<double, std::nano>(end - start).count() /
+         (2.0 * rounds);
+}
+
+int main() {
+  thread_pool pool(2);
+  coro::timer_queue timers;
+
+  // 1. 调度到线程池
+  std::cout << "[Main] thread " << std::this_thread::get_id() << "\n";
+  std::string user = coro::sync_wait(login(pool));
+  std::cout << "[Main] login -> " << user << "\n";
+
+  // 2. 大量并发中的操作：N 个协程同时挂起在定时器上
+  const int N = 20000;
+  auto start = Clock::now();
+  long sum = coro::sync_wait(fan_out(timers, N));
+  auto elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start);
+  std::cout << "[when_all] " << N << " concurrent 50ms waits finished in "
+            << elapsed.count() << " ms, sum=" << sum << " (expected "
+            << static_cast<long>(N) * (N - 1) / 2 << ")\n";
+
+  // 3. co_await queue.pop()：消费者协程在队列空时挂起
+  {
+    coro::awaitable_queue<job> q;
+    std::thread producer([&] {
+      for (int i = 1; i <= 100; ++i) q.push(job(i));
+    });
+    std::cout << "[Queue] consumer sum = " << coro::sync_wait(consumer(q, 100))
+              << " (expected 5050)\n";
+    producer.join();
+  }
+
+  // 4. 基准
+  const int ROUNDS = 100000;
+  std::cout << "\nHandoff cost (ping-pong, " << ROUNDS << " rounds):\n";
+  std::cout << "  coroutine (awaitable_queue)   : "
+            << coroutine_handoff_ns(ROUNDS) << " ns/handoff\n";
+  std::cout << "  std::thread (mutex + cv queue): "
+            << thread_handoff_ns(ROUNDS) << " ns/handoff\n";
+  return 0;
+}
@@ -0,0 +1,125 @@
+/**
+ * @file 11_barrier_latch_event.cpp
+ * @brief C++20 阶段性协作同步：栅栏、锁存器、事件（utils/sync_primitives.hpp）
+ * 1) 事件当“发令枪”：代替 05_shared_future.cpp 中用 shared_future 做一次性广播；
+ * 2) countdown_latch 复用：每轮等待所有 worker 初始化完毕；
+ * 3) 基准：2~64 线程下栅栏每秒完成的轮数（spin_barrier / std::barrier / mutex+cv）。
+ * 用法：11_barrier_latch_event [episodes] [max_threads]
+ */
+
+#include <barrier>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "utils/sync_primitives.hpp"
+
+// mutex + cv 实现的可复用栅栏（对照组）
+class cv_barrier {
+  std::mutex m;
+  std::condition_variable cv;
+  const unsigned expected;
+  unsigned count;
+  unsigned long generation = 0;
+
+ public:
+  explicit cv_barrier(unsigned n) : expected(n), count(n) {}
+
+  void arrive_and_wait() {
+    std::unique_lock<std::mutex> lk(m);
+    unsigned long gen = generation;
+    if (--count == 0) {
+      count = expected;
+      ++generation;
+      lk.unlock();
+      cv.notify_all();
+      return;
+    }
+    cv.wait(lk, [&] { return gen != generation; });
+  }
+};
+
+template <typename Barrier>
+double episodes_per_second(unsigned threads, int episodes) {
+  Barrier barrier(threads);
+  manual_reset_event start;
+  std::vector<std::thread> workers;
+  for (unsigned i = 0; i < threads; ++i) {
+    workers.emplace_back([&] {
+      start.wait();
+      for (int e = 0; e < episodes; ++e) barrier.arrive_and_wait();
+    });
+  }
+  auto t0 = std::chrono::steady_clock::now();
+  start.set();
+  for (auto& t : workers) t.join();
+  auto t1 = std::chrono::steady_clock::now();
+  return episodes / std::chrono::duration<double>(t1 - t0).count();
+}
+
+int main(int argc, char* argv[]) {
+  int episodes = argc > 1 ? std::atoi(argv[1]) : 2000;
+  unsigned max_threads = argc > 2 ? std::atoi(argv[2]) : 64;
+
+  // 1. 发令枪：所有线程就位后一次 set 同时放行
+  {
+    manual_reset_event go;
+    std::vector<std::thread> runners;
+    for (int id = 1; id <= 3; ++id) {
+      runners.emplace_back([&go, id] {
+        go.wait();
+        std::cout << "[Runner " << id << "] Go!\n";
+      });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    std::cout << "Main: Fire the starting gun...\n";
+    go.set();
+    for (auto& t : runners) t.join();
+  }
+
+  // 2. 可复用锁存器 + 自动复位事件
+  {
+    const int WORKERS = 4;
+    countdown_latch initialized(WORKERS);
+    auto_reset_event token;  // 每次 set 只放行一个 worker 进入“报告”区
+    for (int round = 0; round < 2; ++round) {
+      std::vector<std::thread> workers;
+      for (int id = 0; id < WORKERS; ++id) {
+        workers.emplace_back([&, id] {
+          initialized.count_down();  // 初始化完成
+          token.wait();
+          std::cout << "[Round " << round << "] worker " << id << " reporting\n";
+          token.set();  // 把令牌交给下一个
+        });
+      }
+      initialized.wait();
+      std::cout << "[Round " << round << "] all " << WORKERS
+                << " workers initialized\n";
+      token.set();
+      for (auto& t : workers) t.join();
+      token.wait();  // 收回最后一个 worker 交还的令牌
+      initialized.reset(WORKERS);  // 本轮已无等待者，复用
+    }
+  }
+
+  // 3. 基准
+  std::cout << "\nBarrier episodes/s (" << episodes << " episodes per run):\n";
+  std::cout << "threads   spin_barrier    std::barrier      cv_barrier\n";
+  for (unsigned n = 2; n <= max_threads; n *= 2) {
+    std::cout.width(7);
+    std::cout << n;
+    std::cout.width(15);
+    std::cout << static_cast<long>(episodes_per_second<spin_barrier>(n, episodes));
+    std::cout.width(16);
+    std::cout << static_cast<long>(
+        episodes_per_second<std::barrier<>>(n, episodes));
+    std::cout.width(16);
+    std::cout << static_cast<long>(episodes_per_second<cv_barrier>(n, episodes))
+              << "\n";
+  }
+  return 0;
+}
@@ -0,0 +1,231 @@
+/**
+ * @file 12_timing_wheel.cpp
+ * @brief 分层时间轮管理海量截止时间（utils/timing_wheel.hpp）
+ * 1) 连接空闲超时：大量定时器，有活动的连接取消定时器，其余到期后在线程池上批量触发；
+ * 2) 队列的限时 pop（thread_safe_queue::wait_for_and_pop）；
+ * 3) 超出量程（2^26 tick）的截止时间：不得提前触发，准点触发；
+ * 4) 基准：插入 / 取消 / 到期吞吐，对比 std::priority_queue 最小堆定时器。
+ * 用法：12_timing_wheel [timers]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include "thread_pool.hpp"
+#include "thread_safe_queue.hpp"
+#include "utils/timing_wheel.hpp"
+
+using namespace std::chrono_literals;
+using Clock = std::chrono::steady_clock;
+
+// 对照组：最小堆定时器。堆不支持从中间删除，只能“惰性取消”：
+// 取消时把节点标记失效，弹出时跳过代数不匹配的条目
+class heap_timer {
+ public:
+  using callback = std::function<void()>;
+  struct timer_handle {
+    std::uint32_t index;
+    std::uint32_t generation;
+  };
+
+  timer_handle schedule(std::uint64_t expiry, callback cb) {
+    std::uint32_t i;
+    if (!free_list.empty()) {
+      i = free_list.back();
+      free_list.pop_back();
+    } else {
+      i = static_cast<std::uint32_t>(nodes.size());
+      nodes.emplace_back();
+    }
+    nodes[i].cb = std::move(cb);
+    nodes[i].active = true;
+    heap.push({expiry, i, nodes[i].generation});
+    return {i, nodes[i].generation};
+  }
+
+  bool cancel(timer_handle h) {
+    node& n = nodes[h.index];
+    if (!n.active || n.generation != h.generation) return false;
+    n.active = false;
+    n.cb = nullptr;
+    ++n.generation;
+    free_list.push_back(h.index);
+    return true;
+  }
+
+  template <typename Sink>
+  void advance(std::uint64_t now, Sink&& sink) {
+    while (!heap.empty() && heap.top().expiry <= now) {
+      entry e = heap.top();
+      heap.pop();
+      node& n = nodes[e.index];
+      if (!n.active || n.generation != e.generation) continue;  // 已取消
+      callback cb = std::move(n.cb);
+      n.active = false;
+      ++n.generation;
+      free_list.push_back(e.index);
+      sink(std::move(cb));
+    }
+  }
+
+ private:
+  struct node {
+    bool active = false;
+    std::uint32_t generation = 0;
+    callback cb;
+  };
+  struct entry {
+    std::uint64_t expiry;
+    std::uint32_t index;
+    std::uint32_t generation;
+    bool operator>(const entry& o) const { return expiry > o.expiry; }
+  };
+  std::vector<node> nodes;
+  std::vector<std::uint32_t> free_list;
+  std::priority_queue<entry, std::vector<entry>, std::greater<entry>> heap;
+};
+
+struct bench_result {
+  double insert_mops, cancel_mops, expire_mops;
+  long fired;
+};
+
+double mops(Clock::time_point a, Clock::time_point b, std::size_t ops) {
+  return ops / std::chrono::duration<double, std::micro>(b - a).count();
+}
+
+// 模拟时间：截止时间均匀分布在 [1, horizon] ms，先插入全部，再取消一半，最后推进到底
+bench_result bench_wheel(const std::vector<std::uint64_t>& expiries,
+                         std::uint64_t horizon) {
+  const auto origin = Clock::time_point{};
+  timing_wheel wheel(1ms, origin);
+  std::vector<timing_wheel::timer_handle> handles;
+  handles.reserve(expiries.size());
+  long fired = 0;
+
+  auto t0 = Clock::now();
+  for (auto e : expiries)
+    handles.push_back(wheel.schedule(origin + std::chrono::milliseconds(e),
+                                     [&fired] { ++fired; }));
+  auto t1 = Clock::now();
+  for (std::size_t i = 0; i < handles.size(); i += 2) wheel.cancel(handles[i]);
+  auto t2 = Clock::now();
+  for (std::uint64_t now = 0; now <= horizon; now += 10)  // 每 10ms 驱动一次
+    wheel.advance(origin + std::chrono::milliseconds(now),
+                  [](timing_wheel::callback&& cb) { cb(); });
+  auto t3 = Clock::now();
+
+  std::size_t n = expiries.size();
+  return {mops(t0, t1, n), mops(t1, t2, (n + 1) / 2), mops(t2, t3, n / 2),
+          fired};
+}
+
+bench_result bench_heap(const std::vector<std::uint64_t>& expiries,
+                        std::uint64_t horizon) {
+  heap_timer timers;
+  std::vector<heap_timer::timer_handle> handles;
+  handles.reserve(expiries.size());
+  long fired = 0;
+
+  auto t0 = Clock::now();
+  for (auto e : expiries)
+    handles.push_back(timers.schedule(e, [&fired] { ++fired; }));
+  auto t1 = Clock::now();
+  for (std::size_t i = 0; i < handles.size(); i += 2) timers.cancel(handles[i]);
+  auto t2 = Clock::now();
+  for (std::uint64_t now = 0; now <= horizon; now += 10)
+    timers.advance(now, [](heap_timer::callback&& cb) { cb(); });
+  auto t3 = Clock::now();
+
+  std::size_t n = expiries.size();
+  return {mops(t0, t1, n), mops(t1, t2, (n + 1) / 2), mops(t2, t3, n / 2),
+          fired};
+}
+
+int main(int argc, char* argv[]) {
+  const std::size_t N = argc > 1 ? std::atol(argv[1]) : 1000000;
+
+  // 1. 连接空闲超时
+  {
+    thread_pool pool(2);
+    timer_service timers(pool);
+    const int CONNECTIONS = 100000;
+    std::atomic<int> closed{0};
+    std::vector<timer_service::timer_handle> idle_timeouts;
+    idle_timeouts.reserve(CONNECTIONS);
+
+    auto start = Clock::now();
+    for (int i = 0; i < CONNECTIONS; ++i)
+      idle_timeouts.push_back(timers.schedule_after(
+          100ms + std::chrono::milliseconds(i % 100),
+          [&closed] { closed.fetch_add(1, std::memory_order_relaxed); }));
+    // 3/4 的连接在超时前有活动：O(1) 取消
+    int cancelled = 0;
+    for (int i = 0; i < CONNECTIONS; ++i)
+      if (i % 4 != 0 && timers.cancel(idle_timeouts[i])) ++cancelled;
+
+    while (timers.pending() > 0) std::this_thread::sleep_for(10ms);
+    std::this_thread::sleep_for(20ms);  // 等线程池执行完最后一批回调
+    auto elapsed =
+        std::chrono::duration<double, std::milli>(Clock::now() - start);
+    std::cout << "[Idle] " << CONNECTIONS << " timers, " << cancelled
+              << " cancelled, " << closed.load() << " fired within "
+              << elapsed.count() << " ms\n";
+  }
+
+  // 2. 限时 pop
+  {
+    thread_safe_queue<int> requests;
+    int req;
+    auto t0 = Clock::now();
+    bool got = requests.wait_for_and_pop(req, 50ms);
+    std::cout << "[Queue] wait_for_and_pop(50ms) -> " << (got ? "value" : "timeout")
+              << " after "
+              << std::chrono::duration<double, std::milli>(Clock::now() - t0).count()
+              << " ms\n";
+  }
+
+  // 3. 超出量程的截止时间：2^26 tick 之后再过 1000 tick
+  {
+    const auto origin = Clock::time_point{};
+    timing_wheel wheel(1ms, origin);
+    const std::uint64_t far = (std::uint64_t(1) << 26) + 1000;
+    std::uint64_t fired_at = 0;
+    std::uint64_t now = 0;
+    wheel.schedule(origin + std::chrono::milliseconds(far), [&] { fired_at = now; });
+    for (std::uint64_t step : {std::uint64_t(1) << 25, std::uint64_t(1) << 26, far - 1, far}) {
+      now = step;
+      wheel.advance(origin + std::chrono::milliseconds(now),
+                    [](timing_wheel::callback&& cb) { cb(); });
+      if (fired_at && fired_at != far) break;
+    }
+    const bool ok = fired_at == far;
+    std::cout << "[Far] deadline at tick " << far << " fired at tick " << fired_at
+              << (ok ? "  ok" : "  WRONG") << "\n";
+    if (!ok) return 1;
+  }
+
+  // 4. 基准
+  const std::uint64_t HORIZON = 600000;  // 10 分钟，覆盖时间轮的多层
+  std::mt19937_64 rng(42);
+  std::uniform_int_distribution<std::uint64_t> dist(1, HORIZON);
+  std::vector<std::uint64_t> expiries(N);
+  for (auto& e : expiries) e = dist(rng);
+
+  auto w = bench_wheel(expiries, HORIZON);
+  auto h = bench_heap(expiries, HORIZON);
+  std::cout << "\nTimers: " << N << " (cancel 50%, horizon " << HORIZON
+            << " ms), throughput in Mops/s:\n";
+  std::cout << "               insert    cancel    expire   fired\n";
+  std::cout << "timing_wheel " << w.insert_mops << "  " << w.cancel_mops << "  "
+            << w.expire_mops << "  " << w.fired << "\n";
+  std::cout << "binary_heap  " << h.insert_mops << "  " << h.cancel_mops << "  "
+            << h.expire_mops << "  " << h.fired << "\n";
+  return 0;
+}
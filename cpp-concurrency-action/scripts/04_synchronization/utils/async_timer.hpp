@@ -0,0 +1,106 @@
+/**
+ * @file async_timer.hpp
+ * @brief 可 co_await 的定时器：co_await timers.sleep_for(10ms);
+ *
+ * 单个后台线程维护按截止时间排序的最小堆，到期后在定时器线程上恢复协程。
+ * 成千上万个挂起中的定时等待只占用堆中的一个条目，而不是一个线程。
+ */
+
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace coro {
+
+class timer_queue {
+  using clock = std::chrono::steady_clock;
+
+  struct entry {
+    clock::time_point deadline;
+    std::coroutine_handle<> handle;
+    bool operator>(const entry& other) const {
+      return deadline > other.deadline;
+    }
+  };
+
+  std::mutex mut;
+  std::condition_variable cond;
+  std::priority_queue<entry, std::vector<entry>, std::greater<entry>> timers;
+  bool done = false;
+  std::thread worker;  // 最后声明：其余成员先于线程构造
+
+  void run() {
+    std::unique_lock<std::mutex> lk(mut);
+    while (!done) {
+      if (timers.empty()) {
+        cond.wait(lk);
+        continue;
+      }
+      auto deadline = timers.top().deadline;
+      if (clock::now() < deadline) {
+        cond.wait_until(lk, deadline);  // 可能被更早的新定时器提前唤醒
+        continue;
+      }
+      // 批量取出所有已到期的定时器，在锁外恢复，避免协程里再次 sleep 时死锁
+      std::vector<std::coroutine_handle<>> expired;
+      auto now = clock::now();
+      while (!timers.empty() && timers.top().deadline <= now) {
+        expired.push_back(timers.top().handle);
+        timers.pop();
+      }
+      lk.unlock();
+      for (auto h : expired) h.resume();
+      lk.lock();
+    }
+  }
+
+  void schedule(clock::time_point deadline, std::coroutine_handle<> h) {
+    bool earliest;
+    {
+      std::lock_guard<std::mutex> lk(mut);
+      earliest = timers.empty() || deadline < timers.top().deadline;
+      timers.push({deadline, h});
+    }
+    if (earliest) cond.notify_one();
+  }
+
+ public:
+  timer_queue() : worker(&timer_queue::run, this) {}
+
+  // 注意：析构时尚未到期的协程不会再被恢复
+  ~timer_queue() {
+    {
+      std::lock_guard<std::mutex> lk(mut);
+      done = true;
+    }
+    cond.notify_one();
+    worker.join();
+  }
+
+  timer_queue(const timer_queue&) = delete;
+  timer_queue& operator=(const timer_queue&) = delete;
+
+  auto sleep_until(clock::time_point deadline) {
+    struct awaiter {
+      timer_queue& tq;
+      clock::time_point deadline;
+      bool await_ready() const { return clock::now() >= deadline; }
+      void await_suspend(std::coroutine_handle<> h) { tq.schedule(deadline, h); }
+      void await_resume() const noexcept {}
+    };
+    return awaiter{*this, deadline};
+  }
+
+  template <typename Rep, typename Period>
+  auto sleep_for(std::chrono::duration<Rep, Period> d) {
+    return sleep_until(clock::now() +
+                       std::chrono::duration_cast<clock::duration>(d));
+  }
+};
+
+}  // namespace coro
@@ -0,0 +1,86 @@
+/**
+ * @file awaitable_queue.hpp
+ * @brief 把 thread_safe_queue 包装成可 co_await 的队列：T v = co_await q.pop();
+ *
+ * 队列为空时消费者协程挂起（不占线程）并登记到等待链表；
+ * push 发现有等待者时直接把值交给它，并在 push 所在线程上恢复该协程。
+ * 需要换到线程池继续执行的消费者可以再 co_await coro::schedule_on(pool)。
+ */
+
+#pragma once
+#include <coroutine>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+#include "thread_safe_queue.hpp"
+
+namespace coro {
+
+template <typename T>
+class awaitable_queue {
+ public:
+  class pop_awaiter {
+    awaitable_queue& q;
+    std::optional<T> value;
+    std::coroutine_handle<> handle;
+    pop_awaiter* next = nullptr;
+    friend class awaitable_queue;
+
+   public:
+    explicit pop_awaiter(awaitable_queue& q_) : q(q_) {}
+
+    // 取到的值直接放进 optional：T 只需可移动构造，不要求可默认构造
+    bool await_ready() {
+      if (auto v = q.queue.try_pop()) value.emplace(std::move(*v));
+      return value.has_value();
+    }
+
+    // 加锁后再查一次：与 push 的“检查等待者/入队”互斥，避免唤醒丢失
+    bool await_suspend(std::coroutine_handle<> h) {
+      std::lock_guard<std::mutex> lk(q.waiters_mutex);
+      if (auto v = q.queue.try_pop()) {
+        value.emplace(std::move(*v));
+        return false;
+      }
+      handle = h;
+      if (q.tail)
+        q.tail->next = this;
+      else
+        q.head = this;
+      q.tail = this;
+      return true;
+    }
+
+    T await_resume() { return std::move(*value); }
+  };
+
+  void push(T new_value) {
+    pop_awaiter* w = nullptr;
+    {
+      std::lock_guard<std::mutex> lk(waiters_mutex);
+      if (head) {
+        w = head;
+        head = w->next;
+        if (!head) tail = nullptr;
+        w->value.emplace(std::move(new_value));  // 直接交接，不经过底层队列
+      } else {
+        queue.push(std::move(new_value));
+      }
+    }
+    if (w) w->handle.resume();
+  }
+
+  [[nodiscard]] pop_awaiter pop() { return pop_awaiter(*this); }
+
+  bool try_pop(T& value) { return queue.try_pop(value); }
+  bool empty() const { return queue.empty(); }
+
+ private:
+  thread_safe_queue<T> queue;
+  std::mutex waiters_mutex;
+  pop_awaiter* head = nullptr;  // 挂起消费者的 FIFO 链表（节点就是各协程帧里的 awaiter）
+  pop_awaiter* tail = nullptr;
+};
+
+}  // namespace coro
@@ -0,0 +1,366 @@
+/**
+ * @file continuable_future.hpp
+ * @brief 纯标准库实现的可链式 future/promise（then / when_all / when_any）
+ *
+ * 与 Boost.Future 的区别：延续（continuation）只会
+ * 1) 在完成 promise 的线程上内联执行（或 then 时已就绪则在调用线程执行）；
+ * 2) 投递到调用者提供的执行器（thread_pool、inline_executor 等）。
+ * 绝不为延续新开线程，也不会在析构时阻塞。
+ *
+ * 执行器只需提供 post(F&&) 接口，见 utils/thread_pool.hpp。
+ */
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "thread_pool.hpp"  // function_wrapper / inline_executor
+
+namespace cont {
+
+template <typename T>
+class future;
+template <typename T>
+class promise;
+
+namespace detail {
+
+struct unit {};  // 让 void 也能存进 variant
+template <typename T>
+using value_t = std::conditional_t<std::is_void<T>::value, unit, T>;
+
+template <typename T>
+struct shared_state {
+  std::mutex m;
+  std::condition_variable cv;
+  std::variant<std::monostate, value_t<T>, std::exception_ptr> result;
+  bool ready = false;
+  function_wrapper continuation;  // 至多一个延续：future 被 then 消费
+
+  template <std::size_t I, typename... Args>
+  void complete(Args&&... args) {
+    function_wrapper cont;
+    {
+      std::lock_guard<std::mutex> lk(m);
+      if (ready)
+        throw std::future_error(std::future_errc::promise_already_satisfied);
+      result.template emplace<I>(std::forward<Args>(args)...);
+      ready = true;
+      cont = std::move(continuation);
+    }
+    cv.notify_all();
+    if (cont) cont();  // 在锁外执行延续，避免延续里再次加锁导致死锁
+  }
+
+  // 未就绪则登记延续，已就绪则立即在当前线程执行
+  void on_ready(function_wrapper f) {
+    std::unique_lock<std::mutex> lk(m);
+    if (!ready) {
+      continuation = std::move(f);
+      return;
+    }
+    lk.unlock();
+    f();
+  }
+
+  bool is_ready() {
+    std::lock_guard<std::mutex> lk(m);
+    return ready;
+  }
+
+  void wait() {
+    std::unique_lock<std::mutex> lk(m);
+    cv.wait(lk, [this] { return ready; });
+  }
+};
+
+// 执行 g 并把结果/异常写入 p
+template <typename R, typename G>
+void fulfill(promise<R>& p, G&& g) {
+  try {
+    if constexpr (std::is_void<R>::value) {
+      std::forward<G>(g)();
+      p.set_value();
+    } else {
+      p.set_value(std::forward<G>(g)());
+    }
+  } catch (...) {
+    p.set_exception(std::current_exception());
+  }
+}
+
+template <typename T>
+std::shared_ptr<shared_state<T>> state_of(const future<T>& f) {
+  return f.state;
+}
+
+}  // namespace detail
+
+template <typename T>
+class promise {
+  std::shared_ptr<detail::shared_state<T>> state;
+  bool future_retrieved = false;
+
+ public:
+  promise() : state(std::make_shared<detail::shared_state<T>>()) {}
+
+  // 与 std::promise 一致：未兑现就析构时传播 broken_promise，
+  // 这样挂在上面的延续一定会被触发，不会因引用环泄漏
+  ~promise() {
+    if (state && !state->is_ready()) {
+      state->template complete<2>(std::make_exception_ptr(
+          std::future_error(std::future_errc::broken_promise)));
+    }
+  }
+
+  promise(promise&&) noexcept = default;
+  promise& operator=(promise&&) noexcept = default;
+  promise(const promise&) = delete;
+  promise& operator=(const promise&) = delete;
+
+  future<T> get_future() {
+    if (future_retrieved)
+      throw std::future_error(std::future_errc::future_already_retrieved);
+    future_retrieved = true;
+    return future<T>(state);
+  }
+
+  template <typename... Args>
+  void set_value(Args&&... args) {
+    state->template complete<1>(std::forward<Args>(args)...);
+  }
+
+  void set_exception(std::exception_ptr e) {
+    state->template complete<2>(std::move(e));
+  }
+};
+
+template <typename T>
+class future {
+  std::shared_ptr<detail::shared_state<T>> state;
+
+  explicit future(std::shared_ptr<detail::shared_state<T>> s)
+      : state(std::move(s)) {}
+
+  friend class promise<T>;
+  template <typename U>
+  friend class future;
+  friend std::shared_ptr<detail::shared_state<T>> detail::state_of<T>(
+      const future<T>&);
+
+ public:
+  future() = default;
+  future(future&&) noexcept = default;
+  future& operator=(future&&) noexcept = default;
+  future(const future&) = delete;
+  future& operator=(const future&) = delete;
+
+  bool valid() const { return state != nullptr; }
+  bool is_ready() const { return state->is_ready(); }
+  void wait() const { state->wait(); }
+
+  // get() 消费 future：取走值（或重新抛出异常），之后 valid() == false
+  T get() {
+    state->wait();
+    auto s = std::move(state);
+    if (s->result.index() == 2) std::rethrow_exception(std::get<2>(s->result));
+    if constexpr (!std::is_void<T>::value) return std::move(std::get<1>(s->result));
+  }
+
+  // 延续在 ex 上执行；f 接收已就绪的 future<T>，可以 get() 取值或处理异常
+  template <typename Executor, typename F>
+  auto then(Executor& ex, F&& f)
+      -> future<std::invoke_result_t<std::decay_t<F>, future<T>>> {
+    using R = std::invoke_result_t<std::decay_t<F>, future<T>>;
+    promise<R> p;
+    auto res = p.get_future();
+    auto s = std::move(state);
+    auto* raw = s.get();
+    raw->on_ready([ex = &ex, s = std::move(s), f = std::forward<F>(f),
+                   p = std::move(p)]() mutable {
+      ex->post([s = std::move(s), f = std::move(f), p = std::move(p)]() mutable {
+        detail::fulfill(p, [&] { return f(future<T>(std::move(s))); });
+      });
+    });
+    return res;
+  }
+
+  // 不指定执行器时内联执行
+  template <typename F>
+  auto then(F&& f) {
+    static inline_executor inline_ex;
+    return then(inline_ex, std::forward<F>(f));
+  }
+};
+
+template <typename T>
+future<std::decay_t<T>> make_ready_future(T&& value) {
+  promise<std::decay_t<T>> p;
+  auto f = p.get_future();
+  p.set_value(std::forward<T>(value));
+  return f;
+}
+
+inline future<void> make_ready_future() {
+  promise<void> p;
+  auto f = p.get_future();
+  p.set_value();
+  return f;
+}
+
+// 在执行器上异步执行 f，返回结果通道
+template <typename Executor, typename F>
+auto async(Executor& ex, F f) -> future<std::invoke_result_t<F>> {
+  promise<std::invoke_result_t<F>> p;
+  auto res = p.get_future();
+  ex.post([p = std::move(p), f = std::move(f)]() mutable {
+    detail::fulfill(p, f);
+  });
+  return res;
+}
+
+// ------------------------- when_all -------------------------
+// 所有输入就绪后，结果 future 携带全部（已就绪的）输入 future
+
+template <typename... Ts>
+future<std::tuple<future<Ts>...>> when_all(future<Ts>... fs) {
+  using result_type = std::tuple<future<Ts>...>;
+  struct context {
+    result_type futures;
+    std::atomic<std::size_t> remaining{sizeof...(Ts)};
+    promise<result_type> p;
+  };
+
+  auto ctx = std::make_shared<context>();
+  auto res = ctx->p.get_future();
+  if constexpr (sizeof...(Ts) == 0) {
+    ctx->p.set_value();
+  } else {
+    // 先拷贝出各个共享状态：最后一个延续可能内联触发并移走 ctx->futures
+    auto states = std::make_tuple(detail::state_of(fs)...);
+    ctx->futures = result_type(std::move(fs)...);
+    std::apply(
+        [&ctx](auto&... s) {
+          (s->on_ready([ctx] {
+             if (ctx->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+               ctx->p.set_value(std::move(ctx->futures));
+           }),
+           ...);
+        },
+        states);
+  }
+  return res;
+}
+
+template <typename InputIt>
+auto when_all(InputIt first, InputIt last)
+    -> future<std::vector<typename std::iterator_traits<InputIt>::value_type>> {
+  using future_type = typename std::iterator_traits<InputIt>::value_type;
+  using result_type = std::vector<future_type>;
+  struct context {
+    result_type futures;
+    std::atomic<std::size_t> remaining{0};
+    promise<result_type> p;
+  };
+
+  auto ctx = std::make_shared<context>();
+  auto res = ctx->p.get_future();
+  for (; first != last; ++first) ctx->futures.push_back(std::move(*first));
+  if (ctx->futures.empty()) {
+    ctx->p.set_value();
+    return res;
+  }
+
+  std::vector<decltype(detail::state_of(ctx->futures[0]))> states;
+  for (auto& f : ctx->futures) states.push_back(detail::state_of(f));
+  ctx->remaining.store(states.size(), std::memory_order_relaxed);
+  for (auto& s : states) {
+    s->on_ready([ctx] {
+      if (ctx->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        ctx->p.set_value(std::move(ctx->futures));
+    });
+  }
+  return res;
+}
+
+// ------------------------- when_any -------------------------
+// 任意一个输入就绪即完成，index 指出是哪一个；其余 future 原样交还
+
+template <typename Sequence>
+struct when_any_result {
+  std::size_t index;
+  Sequence futures;
+};
+
+template <typename InputIt>
+auto when_any(InputIt first, InputIt last) -> future<when_any_result<
+    std::vector<typename std::iterator_traits<InputIt>::value_type>>> {
+  using future_type = typename std::iterator_traits<InputIt>::value_type;
+  using result_type = when_any_result<std::vector<future_type>>;
+  struct context {
+    std::vector<future_type> futures;
+    std::atomic<bool> fired{false};
+    promise<result_type> p;
+  };
+
+  auto ctx = std::make_shared<context>();
+  auto res = ctx->p.get_future();
+  for (; first != last; ++first) ctx->futures.push_back(std::move(*first));
+  if (ctx->futures.empty()) {
+    ctx->p.set_value(result_type{static_cast<std::size_t>(-1), {}});
+    return res;
+  }
+
+  std::vector<decltype(detail::state_of(ctx->futures[0]))> states;
+  for (auto& f : ctx->futures) states.push_back(detail::state_of(f));
+  for (std::size_t i = 0; i < states.size(); ++i) {
+    states[i]->on_ready([ctx, i] {
+      if (!ctx->fired.exchange(true, std::memory_order_acq_rel))
+        ctx->p.set_value(result_type{i, std::move(ctx->futures)});
+    });
+  }
+  return res;
+}
+
+template <typename... Ts>
+future<when_any_result<std::tuple<future<Ts>...>>> when_any(
+    future<Ts>... fs) {
+  using sequence_type = std::tuple<future<Ts>...>;
+  using result_type = when_any_result<sequence_type>;
+  struct context {
+    sequence_type futures;
+    std::atomic<bool> fired{false};
+    promise<result_type> p;
+  };
+
+  auto ctx = std::make_shared<context>();
+  auto res = ctx->p.get_future();
+  auto states = std::make_tuple(detail::state_of(fs)...);
+  ctx->futures = sequence_type(std::move(fs)...);
+  auto attach = [&ctx](auto& s, std::size_t i) {
+    s->on_ready([ctx, i] {
+      if (!ctx->fired.exchange(true, std::memory_order_acq_rel))
+        ctx->p.set_value(result_type{i, std::move(ctx->futures)});
+    });
+  };
+  std::apply(
+      [&attach](auto&... s) {
+        std::size_t i = 0;
+        (attach(s, i++), ...);
+      },
+      states);
+  return res;
+}
+
+}  // namespace cont
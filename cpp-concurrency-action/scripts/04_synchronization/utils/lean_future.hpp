@@ -0,0 +1,303 @@
+/**
+ * @file lean_future.hpp
+ * @brief 轻量级 promise/future：单次分配 + 状态字 atomic::wait/notify（C++20）
+ *
+ * std::promise/std::future 的共享状态 = shared_ptr 控制块 + mutex + 条件变量。
+ * 这里把共享状态压缩成：
+ * - 一个 32 位状态字：EMPTY / VALUE / EXCEPTION + HAS_WAITER、SETTING 标志位
+ * - 一个侵入式引用计数（promise、future、各个 shared_future 各持一份）
+ * - 值与 exception_ptr 共用的一块存储
+ * 阻塞直接用 std::atomic::wait，只有确实有人在等（HAS_WAITER）时 setter 才 notify。
+ * 传入 lean::pooled 时共享状态从线程本地空闲链表复用，稳态下零分配。
+ */
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace lean {
+
+struct pooled_t {
+  explicit pooled_t() = default;
+};
+inline constexpr pooled_t pooled{};
+
+namespace detail {
+
+enum : std::uint32_t {
+  EMPTY = 0,
+  VALUE = 1,
+  EXCEPTION = 2,
+  READY_MASK = 3,
+  HAS_WAITER = 4,
+  SETTING = 8,  // 已有 setter 认领，正在构造结果
+};
+
+struct unit {};
+template <typename T>
+using value_t = std::conditional_t<std::is_void<T>::value, unit, T>;
+
+template <typename T>
+struct shared_state {
+  std::atomic<std::uint32_t> status{EMPTY};
+  std::atomic<std::uint32_t> refs{2};  // promise + future
+  bool pooled = false;
+  shared_state* next_free = nullptr;  // 仅在空闲链表中使用
+  union {
+    value_t<T> value;
+    std::exception_ptr error;
+  };
+
+  shared_state() {}
+  ~shared_state() {}
+
+  // ---------- 线程本地空闲链表（只在本线程内压入/弹出，无需同步） ----------
+  struct free_list {
+    shared_state* head = nullptr;
+    std::size_t size = 0;
+    ~free_list() {
+      while (head) {
+        shared_state* n = head;
+        head = head->next_free;
+        delete n;
+      }
+    }
+  };
+  static constexpr std::size_t MAX_CACHED = 1024;
+  static free_list& local_cache() {
+    static thread_local free_list cache;
+    return cache;
+  }
+
+  static shared_state* create(bool use_pool) {
+    shared_state* s = nullptr;
+    if (use_pool) {
+      auto& cache = local_cache();
+      if (cache.head) {
+        s = cache.head;
+        cache.head = s->next_free;
+        --cache.size;
+        s->status.store(EMPTY, std::memory_order_relaxed);
+        s->refs.store(2, std::memory_order_relaxed);
+      }
+    }
+    if (!s) s = new shared_state();
+    s->pooled = use_pool;
+    return s;
+  }
+
+  void destroy_payload() {
+    std::uint32_t st = status.load(std::memory_order_acquire) & READY_MASK;
+    if (st == VALUE)
+      value.~value_t<T>();
+    else if (st == EXCEPTION)
+      error.~exception_ptr();
+  }
+
+  void add_ref() { refs.fetch_add(1, std::memory_order_relaxed); }
+
+  void release() {
+    if (refs.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+    destroy_payload();
+    // 谁释放最后一个引用，就回收到谁的线程本地链表
+    auto& cache = local_cache();
+    if (pooled && cache.size < MAX_CACHED) {
+      next_free = cache.head;
+      cache.head = this;
+      ++cache.size;
+    } else {
+      delete this;
+    }
+  }
+
+  // 认领写入权：先原子地置上 SETTING 再构造结果，并发的第二个 setter 在这里被拒绝，
+  // 不会与第一个同时往同一块存储里构造
+  void claim() {
+    if (status.fetch_or(SETTING, std::memory_order_acquire) & (READY_MASK | SETTING))
+      throw std::future_error(std::future_errc::promise_already_satisfied);
+  }
+
+  // 构造结果时抛出异常：放弃认领，promise 仍可再次设置（或析构时报 broken_promise）
+  void abandon_claim() { status.fetch_and(~SETTING, std::memory_order_release); }
+
+  // 发布结果：一次 exchange 同时完成“写入就绪”“清除 SETTING”与“检查有无等待者”
+  void publish(std::uint32_t kind) {
+    std::uint32_t old = status.exchange(kind, std::memory_order_acq_rel);
+    if (old & HAS_WAITER) status.notify_all();  // 一次 notify 唤醒所有等待者
+  }
+
+  template <typename... Args>
+  void set_value(Args&&... args) {
+    claim();
+    try {
+      ::new (static_cast<void*>(&value)) value_t<T>(std::forward<Args>(args)...);
+    } catch (...) {
+      abandon_claim();
+      throw;
+    }
+    publish(VALUE);
+  }
+
+  void set_exception(std::exception_ptr e) {
+    claim();
+    ::new (static_cast<void*>(&error)) std::exception_ptr(std::move(e));
+    publish(EXCEPTION);
+  }
+
+  bool is_ready() const {
+    return status.load(std::memory_order_acquire) & READY_MASK;
+  }
+
+  std::uint32_t wait() {
+    std::uint32_t s = status.load(std::memory_order_acquire);
+    for (int spin = 0; !(s & READY_MASK) && spin < 64; ++spin)
+      s = status.load(std::memory_order_acquire);  // 短暂自旋，结果常常马上就到
+    while (!(s & READY_MASK)) {
+      if (!(s & HAS_WAITER)) {
+        // 先登记“有人在等”，setter 才会 notify；CAS 失败说明状态已变，重读
+        if (!status.compare_exchange_weak(s, s | HAS_WAITER,
+                                          std::memory_order_acquire))
+          continue;
+        s |= HAS_WAITER;
+      }
+      status.wait(s, std::memory_order_acquire);
+      s = status.load(std::memory_order_acquire);
+    }
+    return s & READY_MASK;
+  }
+};
+
+}  // namespace detail
+
+template <typename T>
+class shared_future;
+
+template <typename T>
+class future {
+  detail::shared_state<T>* state = nullptr;
+
+  explicit future(detail::shared_state<T>* s) : state(s) {}
+  template <typename U>
+  friend class promise;
+  friend class shared_future<T>;
+
+ public:
+  future() = default;
+  future(future&& other) noexcept : state(std::exchange(other.state, nullptr)) {}
+  future& operator=(future&& other) noexcept {
+    if (this != &other) {
+      if (state) state->release();
+      state = std::exchange(other.state, nullptr);
+    }
+    return *this;
+  }
+  ~future() {
+    if (state) state->release();
+  }
+
+  bool valid() const { return state != nullptr; }
+  bool is_ready() const { return state->is_ready(); }
+  void wait() const { state->wait(); }
+
+  // 与 std::future 一致：get() 之后 valid() == false
+  T get() {
+    detail::shared_state<T>* s = std::exchange(state, nullptr);
+    struct releaser {
+      detail::shared_state<T>* s;
+      ~releaser() { s->release(); }
+    } guard{s};
+    if (s->wait() == detail::EXCEPTION) std::rethrow_exception(s->error);
+    if constexpr (!std::is_void<T>::value) return std::move(s->value);
+  }
+
+  shared_future<T> share() { return shared_future<T>(std::move(*this)); }
+};
+
+// 广播版：可拷贝，多个线程 get() 读到同一份结果，set 时一次 notify_all 全部唤醒
+template <typename T>
+class shared_future {
+  detail::shared_state<T>* state = nullptr;
+
+ public:
+  shared_future() = default;
+  shared_future(future<T>&& f) noexcept
+      : state(std::exchange(f.state, nullptr)) {}
+  shared_future(const shared_future& other) : state(other.state) {
+    if (state) state->add_ref();
+  }
+  shared_future(shared_future&& other) noexcept
+      : state(std::exchange(other.state, nullptr)) {}
+  shared_future& operator=(shared_future other) noexcept {
+    std::swap(state, other.state);
+    return *this;
+  }
+  ~shared_future() {
+    if (state) state->release();
+  }
+
+  bool valid() const { return state != nullptr; }
+  bool is_ready() const { return state->is_ready(); }
+  void wait() const { state->wait(); }
+
+  std::conditional_t<std::is_void<T>::value, void, const detail::value_t<T>&>
+  get() const {
+    if (state->wait() == detail::EXCEPTION) std::rethrow_exception(state->error);
+    if constexpr (!std::is_void<T>::value) return state->value;
+  }
+};
+
+template <typename T>
+class promise {
+  detail::shared_state<T>* state;
+  bool future_retrieved = false;
+
+ public:
+  promise() : state(detail::shared_state<T>::create(false)) {}
+  explicit promise(pooled_t) : state(detail::shared_state<T>::create(true)) {}
+
+  promise(promise&& other) noexcept
+      : state(std::exchange(other.state, nullptr)),
+        future_retrieved(other.future_retrieved) {}
+  promise& operator=(promise&& other) noexcept {
+    promise(std::move(other)).swap(*this);
+    return *this;
+  }
+  promise(const promise&) = delete;
+  promise& operator=(const promise&) = delete;
+
+  ~promise() {
+    if (!state) return;
+    if (!state->is_ready()) {
+      state->set_exception(std::make_exception_ptr(
+          std::future_error(std::future_errc::broken_promise)));
+    }
+    if (!future_retrieved) state->release();  // future 那份引用也由我们归还
+    state->release();
+  }
+
+  void swap(promise& other) noexcept {
+    std::swap(state, other.state);
+    std::swap(future_retrieved, other.future_retrieved);
+  }
+
+  future<T> get_future() {
+    if (future_retrieved)
+      throw std::future_error(std::future_errc::future_already_retrieved);
+    future_retrieved = true;
+    return future<T>(state);
+  }
+
+  template <typename... Args>
+  void set_value(Args&&... args) {
+    state->set_value(std::forward<Args>(args)...);
+  }
+
+  void set_exception(std::exception_ptr e) { state->set_exception(std::move(e)); }
+};
+
+}  // namespace lean
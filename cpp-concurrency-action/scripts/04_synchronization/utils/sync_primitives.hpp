@@ -0,0 +1,126 @@
+/**
+ * @file sync_primitives.hpp
+ * @brief 低延迟可复用的同步原语：栅栏 / 倒计时锁存器 / 事件（C++20 atomic::wait）
+ *
+ * - spin_barrier       : 代数（generation）翻转栅栏，先自旋再 atomic::wait 阻塞
+ * - countdown_latch    : 可 reset 复用的倒计时锁存器（std::latch 只能用一次）
+ * - manual_reset_event : 手动复位事件，set 后一直放行，直到 reset
+ * - auto_reset_event   : 自动复位事件，每次 set 只放行一个等待者
+ * 没有 mutex，也没有条件变量：快路径只有一两次原子操作。
+ */
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+#include "cache_line.hpp"
+#include "spin_wait.hpp"
+
+// 在 atomic 上先自旋、再阻塞，直到其值不再等于 old
+template <typename T>
+T spin_then_wait_while_equal(const std::atomic<T>& a, T old,
+                             int spin_limit = default_spin_limit()) {
+  T cur = a.load(std::memory_order_acquire);
+  for (int i = 0; cur == old && i < spin_limit; ++i) {
+    cpu_relax();
+    cur = a.load(std::memory_order_acquire);
+  }
+  while (cur == old) {
+    a.wait(old, std::memory_order_acquire);
+    cur = a.load(std::memory_order_acquire);
+  }
+  return cur;
+}
+
+// 集中式“感应翻转”栅栏：最后到达者重置计数并翻转代数，其余线程等代数变化。
+// 用单调递增的代数代替 bool sense，天然区分相邻两轮，不需要线程本地 sense。
+class spin_barrier {
+  alignas(CACHE_LINE_SIZE) std::atomic<std::uint32_t> count;
+  alignas(CACHE_LINE_SIZE) std::atomic<std::uint32_t> generation{0};
+  const std::uint32_t expected;
+
+ public:
+  explicit spin_barrier(std::uint32_t n) : count(n), expected(n) {}
+  spin_barrier(const spin_barrier&) = delete;
+  spin_barrier& operator=(const spin_barrier&) = delete;
+
+  void arrive_and_wait() {
+    const std::uint32_t gen = generation.load(std::memory_order_acquire);
+    if (count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      // 下一轮的到达者必须先看到代数变化，所以先重置计数再翻转
+      count.store(expected, std::memory_order_relaxed);
+      generation.store(gen + 1, std::memory_order_release);
+      generation.notify_all();
+      return;
+    }
+    spin_then_wait_while_equal(generation, gen);
+  }
+};
+
+class countdown_latch {
+  std::atomic<std::int32_t> count;
+
+ public:
+  explicit countdown_latch(std::int32_t n) : count(n) {}
+  countdown_latch(const countdown_latch&) = delete;
+  countdown_latch& operator=(const countdown_latch&) = delete;
+
+  void count_down(std::int32_t n = 1) {
+    if (count.fetch_sub(n, std::memory_order_acq_rel) == n) count.notify_all();
+  }
+
+  bool try_wait() const { return count.load(std::memory_order_acquire) == 0; }
+
+  void wait() const {
+    std::int32_t cur = count.load(std::memory_order_acquire);
+    while (cur != 0) cur = spin_then_wait_while_equal(count, cur);
+  }
+
+  void arrive_and_wait(std::int32_t n = 1) {
+    count_down(n);
+    wait();
+  }
+
+  // 复用：只能在本轮所有等待者都已返回后调用（与 std::latch 不同，这里允许重置）
+  void reset(std::int32_t n) { count.store(n, std::memory_order_release); }
+};
+
+class manual_reset_event {
+  std::atomic<std::uint32_t> state;
+
+ public:
+  explicit manual_reset_event(bool initially_set = false)
+      : state(initially_set ? 1 : 0) {}
+
+  void set() {
+    if (state.exchange(1, std::memory_order_release) == 0) state.notify_all();
+  }
+  void reset() { state.store(0, std::memory_order_relaxed); }
+  bool is_set() const { return state.load(std::memory_order_acquire) == 1; }
+
+  void wait() const { spin_then_wait_while_equal(state, 0u); }
+};
+
+class auto_reset_event {
+  std::atomic<std::uint32_t> state;
+
+ public:
+  explicit auto_reset_event(bool initially_set = false)
+      : state(initially_set ? 1 : 0) {}
+
+  // 已处于 set 状态时再次 set 不会累计（与信号量不同）
+  void set() {
+    if (state.exchange(1, std::memory_order_release) == 0) state.notify_one();
+  }
+
+  // 抢到 1 -> 0 的线程通过，其余继续等
+  void wait() {
+    for (;;) {
+      std::uint32_t expected = 1;
+      if (state.compare_exchange_weak(expected, 0, std::memory_order_acquire,
+                                      std::memory_order_relaxed))
+        return;
+      if (expected == 0) spin_then_wait_while_equal(state, 0u);
+    }
+  }
+};
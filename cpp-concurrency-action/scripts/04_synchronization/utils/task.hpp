@@ -0,0 +1,321 @@
+/**
+ * @file task.hpp
+ * @brief C++20 协程 task<T>：惰性启动 + 对称转移 + 调度器集成
+ *
+ * - task<T>      : co_await 时才启动；完成后通过 final_suspend 对称转移回等待者，
+ *                  长链 co_await 不会增长调用栈
+ * - schedule_on  : co_await schedule_on(pool) 把当前协程挪到线程池上继续执行
+ * - when_all     : 并发启动一组 task，全部完成后恢复调用者（最后完成者负责恢复）
+ * - sync_wait    : 在普通线程里阻塞等待 task 结果（main 函数入口使用）
+ * 等待中的协程只占一个协程帧，不占线程，因此可以同时挂起成千上万个操作。
+ */
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace coro {
+
+template <typename T>
+class task;
+
+namespace detail {
+
+template <typename T>
+struct result_slot {
+  std::variant<std::monostate, T, std::exception_ptr> result;
+
+  template <typename U>
+  void return_value(U&& v) {
+    result.template emplace<1>(std::forward<U>(v));
+  }
+  void unhandled_exception() {
+    result.template emplace<2>(std::current_exception());
+  }
+  T get() {
+    if (result.index() == 2) std::rethrow_exception(std::get<2>(result));
+    return std::move(std::get<1>(result));
+  }
+};
+
+template <>
+struct result_slot<void> {
+  std::exception_ptr error;
+
+  void return_void() {}
+  void unhandled_exception() { error = std::current_exception(); }
+  void get() {
+    if (error) std::rethrow_exception(error);
+  }
+};
+
+template <typename T>
+struct task_promise : result_slot<T> {
+  std::coroutine_handle<> continuation = std::noop_coroutine();
+
+  struct final_awaiter {
+    bool await_ready() const noexcept { return false; }
+    // 对称转移：直接切到等待者，而不是在当前栈上 resume 它
+    template <typename Promise>
+    std::coroutine_handle<> await_suspend(
+        std::coroutine_handle<Promise> h) noexcept {
+      return h.promise().continuation;
+    }
+    void await_resume() const noexcept {}
+  };
+
+  task<T> get_return_object() noexcept;
+  std::suspend_always initial_suspend() const noexcept { return {}; }
+  final_awaiter final_suspend() const noexcept { return {}; }
+};
+
+}  // namespace detail
+
+template <typename T = void>
+class [[nodiscard]] task {
+ public:
+  using promise_type = detail::task_promise<T>;
+
+  task() = default;
+  explicit task(std::coroutine_handle<promise_type> h) : handle(h) {}
+  task(task&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+  task& operator=(task&& other) noexcept {
+    if (this != &other) {
+      if (handle) handle.destroy();
+      handle = std::exchange(other.handle, {});
+    }
+    return *this;
+  }
+  task(const task&) = delete;
+  task& operator=(const task&) = delete;
+  ~task() {
+    if (handle) handle.destroy();
+  }
+
+  auto operator co_await() && noexcept {
+    struct awaiter {
+      std::coroutine_handle<promise_type> h;
+      bool await_ready() const noexcept { return !h || h.done(); }
+      std::coroutine_handle<> await_suspend(
+          std::coroutine_handle<> awaiting) noexcept {
+        h.promise().continuation = awaiting;
+        return h;  // 对称转移：启动子协程
+      }
+      T await_resume() { return h.promise().get(); }
+    };
+    return awaiter{handle};
+  }
+
+ private:
+  std::coroutine_handle<promise_type> handle;
+};
+
+template <typename T>
+task<T> detail::task_promise<T>::get_return_object() noexcept {
+  return task<T>(std::coroutine_handle<task_promise>::from_promise(*this));
+}
+
+// ------------------------- schedule_on -------------------------
+// Executor 只需提供 post(F&&)，例如 utils/thread_pool.hpp 中的 thread_pool
+
+template <typename Executor>
+auto schedule_on(Executor& ex) {
+  struct awaiter {
+    Executor& ex;
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> h) {
+      ex.post([h] { h.resume(); });
+    }
+    void await_resume() const noexcept {}
+  };
+  return awaiter{ex};
+}
+
+// ------------------------- when_all -------------------------
+
+namespace detail {
+
+// 计数初值 = 子任务数 + 1：多出来的 1 归调用者，防止子任务在调用者
+// 挂起之前全部完成时重复恢复调用者
+struct when_all_counter {
+  std::atomic<std::size_t> count;
+  std::coroutine_handle<> parent;
+
+  explicit when_all_counter(std::size_t n) : count(n + 1) {}
+  bool arrive() noexcept {
+    return count.fetch_sub(1, std::memory_order_acq_rel) == 1;
+  }
+};
+
+// 驱动单个子任务的辅助协程，完成时递减计数，最后一个完成者转移回调用者
+struct when_all_helper {
+  struct promise_type {
+    when_all_counter* counter = nullptr;
+
+    when_all_helper get_return_object() noexcept {
+      return when_all_helper{
+          std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    auto final_suspend() const noexcept {
+      struct awaiter {
+        bool await_ready() const noexcept { return false; }
+        std::coroutine_handle<> await_suspend(
+            std::coroutine_handle<promise_type> h) noexcept {
+          when_all_counter* c = h.promise().counter;
+          return c->arrive() ? c->parent : std::noop_coroutine();
+        }
+        void await_resume() const noexcept {}
+      };
+      return awaiter{};
+    }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { std::terminate(); }  // 异常已在内部捕获
+  };
+
+  std::coroutine_handle<promise_type> handle;
+};
+
+template <typename T>
+when_all_helper run_into(task<T>& t, result_slot<T>& slot) {
+  try {
+    if constexpr (std::is_void<T>::value) {
+      co_await std::move(t);
+    } else {
+      slot.return_value(co_await std::move(t));
+    }
+  } catch (...) {
+    slot.unhandled_exception();
+  }
+}
+
+template <typename T>
+class when_all_awaitable {
+  std::vector<task<T>>& tasks;
+  std::vector<result_slot<T>>& slots;
+  when_all_counter counter;
+  std::vector<when_all_helper> helpers;
+
+ public:
+  when_all_awaitable(std::vector<task<T>>& t, std::vector<result_slot<T>>& s)
+      : tasks(t), slots(s), counter(t.size()) {}
+  ~when_all_awaitable() {
+    for (auto& h : helpers) h.handle.destroy();
+  }
+
+  bool await_ready() const noexcept { return tasks.empty(); }
+  bool await_suspend(std::coroutine_handle<> parent) {
+    counter.parent = parent;
+    helpers.reserve(tasks.size());
+    for (std::size_t i = 0; i < tasks.size(); ++i) {
+      helpers.push_back(run_into(tasks[i], slots[i]));
+      helpers.back().handle.promise().counter = &counter;
+    }
+    for (auto& h : helpers) h.handle.resume();
+    return !counter.arrive();  // 全部已同步完成则不挂起
+  }
+  void await_resume() const noexcept {}
+};
+
+}  // namespace detail
+
+template <typename T>
+task<std::vector<T>> when_all(std::vector<task<T>> tasks) {
+  std::vector<detail::result_slot<T>> slots(tasks.size());
+  co_await detail::when_all_awaitable<T>(tasks, slots);
+  std::vector<T> results;
+  results.reserve(slots.size());
+  for (auto& s : slots) results.push_back(s.get());  // 重新抛出首个异常
+  co_return results;
+}
+
+inline task<void> when_all(std::vector<task<void>> tasks) {
+  std::vector<detail::result_slot<void>> slots(tasks.size());
+  co_await detail::when_all_awaitable<void>(tasks, slots);
+  for (auto& s : slots) s.get();
+}
+
+// ------------------------- sync_wait -------------------------
+
+namespace detail {
+
+// 完成标志放在 sync_wait 的栈上，并在锁内通知：
+// 等待者拿到锁之前，通知方不会再访问任何共享对象
+struct sync_wait_event {
+  std::mutex m;
+  std::condition_variable cv;
+  bool done = false;
+
+  void set() {
+    std::lock_guard<std::mutex> lk(m);
+    done = true;
+    cv.notify_one();
+  }
+  void wait() {
+    std::unique_lock<std::mutex> lk(m);
+    cv.wait(lk, [this] { return done; });
+  }
+};
+
+struct sync_wait_task {
+  struct promise_type {
+    sync_wait_event* event = nullptr;
+
+    sync_wait_task get_return_object() noexcept {
+      return sync_wait_task{
+          std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    auto final_suspend() noexcept {
+      struct awaiter {
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+          h.promise().event->set();
+        }
+        void await_resume() const noexcept {}
+      };
+      return awaiter{};
+    }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { std::terminate(); }
+  };
+
+  std::coroutine_handle<promise_type> handle;
+};
+
+template <typename T>
+sync_wait_task run_sync(task<T>& t, result_slot<T>& slot) {
+  try {
+    if constexpr (std::is_void<T>::value) {
+      co_await std::move(t);
+    } else {
+      slot.return_value(co_await std::move(t));
+    }
+  } catch (...) {
+    slot.unhandled_exception();
+  }
+}
+
+}  // namespace detail
+
+template <typename T>
+T sync_wait(task<T> t) {
+  detail::result_slot<T> slot;
+  detail::sync_wait_event event;
+  auto waiter = detail::run_sync(t, slot);
+  waiter.handle.promise().event = &event;
+  waiter.handle.resume();
+  event.wait();
+  waiter.handle.destroy();
+  return slot.get();
+}
+
+}  // namespace coro
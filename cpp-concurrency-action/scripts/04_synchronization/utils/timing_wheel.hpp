@@ -0,0 +1,329 @@
+/**
+ * @file timing_wheel.hpp
+ * @brief 分层时间轮：O(1) 插入/取消海量定时器 + 批量投递到线程池的驱动线程
+ *
+ * timing_wheel（单线程数据结构，调用者负责加锁）：
+ * - 4 层轮子：第 0 层 256 个槽（每槽 1 tick），第 1~3 层各 64 个槽，
+ *   覆盖 2^26 个 tick（tick = 1ms 时约 18.6 小时）。更远的定时器先挂在最外层量程的末端，
+ *   节点记录的仍是真实截止时间，每次降级都按它重新计算槽位，不会提前触发。
+ * - 定时器节点放在 slab（vector + 空闲链表）里，槽内用下标双向链表串起来，
+ *   插入 = 算槽位 + 头插，取消 = 摘链，都是 O(1)。
+ * - 句柄带代数（generation），节点复用后旧句柄自动失效，取消已触发的定时器是安全的空操作。
+ * - 第 0 层转完一圈时把上一层对应槽的节点“降级”重新插入（cascade）。
+ *
+ * timer_service：驱动线程按 tick 推进时间轮，把到期回调按批投递到线程池执行。
+ */
+
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "thread_pool.hpp"
+
+class timing_wheel {
+ public:
+  using clock = std::chrono::steady_clock;
+  using callback = std::function<void()>;
+
+  struct timer_handle {
+    std::uint32_t index = NIL;
+    std::uint32_t generation = 0;
+  };
+
+  explicit timing_wheel(clock::duration tick = std::chrono::milliseconds(1),
+                        clock::time_point start = clock::now())
+      : tick_len(tick), origin(start) {
+    for (auto& head : slots) head = NIL;
+  }
+
+  timer_handle schedule(clock::time_point deadline, callback cb) {
+    std::uint32_t i = allocate();
+    node& n = nodes[i];
+    n.cb = std::move(cb);
+    n.expiry = std::max(to_tick_ceil(deadline), current_tick);
+    n.active = true;
+    link(i);
+    ++count;
+    return {i, n.generation};
+  }
+
+  // 返回 false 表示定时器已触发或已取消
+  bool cancel(timer_handle h) {
+    if (h.index >= nodes.size()) return false;
+    node& n = nodes[h.index];
+    if (!n.active || n.generation != h.generation) return false;
+    unlink(h.index);
+    n.cb = nullptr;
+    release(h.index);
+    --count;
+    return true;
+  }
+
+  // 推进到 now，把所有到期回调交给 sink(callback&&)
+  template <typename Sink>
+  void advance(clock::time_point now, Sink&& sink) {
+    std::uint64_t target = to_tick_floor(now);
+    while (current_tick <= target) {
+      if (count == 0) {  // 空轮直接跳到目标时刻
+        current_tick = target + 1;
+        break;
+      }
+      process_tick(sink);
+    }
+  }
+
+  std::size_t size() const { return count; }
+  bool empty() const { return count == 0; }
+  clock::duration tick() const { return tick_len; }
+  clock::time_point next_tick_time() const {
+    return origin + tick_len * static_cast<clock::rep>(current_tick);
+  }
+
+ private:
+  static constexpr std::uint32_t NIL = 0xffffffffu;
+  static constexpr int LEVELS = 4;
+  static constexpr int ROOT_BITS = 8;  // 第 0 层 256 槽
+  static constexpr int LEVEL_BITS = 6;  // 其余每层 64 槽
+  static constexpr std::uint64_t ROOT_SIZE = 1u << ROOT_BITS;
+  static constexpr std::uint64_t LEVEL_SIZE = 1u << LEVEL_BITS;
+  static constexpr int SLOT_COUNT = ROOT_SIZE + (LEVELS - 1) * LEVEL_SIZE;
+  static constexpr std::uint64_t MAX_DELTA =
+      (std::uint64_t(1) << (ROOT_BITS + (LEVELS - 1) * LEVEL_BITS)) - 1;
+
+  struct node {
+    std::uint32_t prev = NIL;
+    std::uint32_t next = NIL;
+    std::uint32_t slot = 0;
+    std::uint32_t generation = 0;
+    std::uint64_t expiry = 0;
+    bool active = false;
+    callback cb;
+  };
+
+  clock::duration tick_len;
+  clock::time_point origin;
+  std::uint64_t current_tick = 0;  // 下一个待处理的 tick
+  std::size_t count = 0;
+  std::vector<node> nodes;
+  std::uint32_t free_head = NIL;
+  std::uint32_t slots[SLOT_COUNT];
+
+  std::uint64_t to_tick_floor(clock::time_point tp) const {
+    if (tp <= origin) return 0;
+    return static_cast<std::uint64_t>((tp - origin) / tick_len);
+  }
+  std::uint64_t to_tick_ceil(clock::time_point tp) const {
+    if (tp <= origin) return 0;
+    auto d = tp - origin;
+    return static_cast<std::uint64_t>((d + tick_len - clock::duration(1)) /
+                                      tick_len);
+  }
+
+  std::uint32_t allocate() {
+    if (free_head != NIL) {
+      std::uint32_t i = free_head;
+      free_head = nodes[i].next;
+      return i;
+    }
+    nodes.emplace_back();
+    return static_cast<std::uint32_t>(nodes.size() - 1);
+  }
+
+  void release(std::uint32_t i) {
+    node& n = nodes[i];
+    n.active = false;
+    ++n.generation;  // 让旧句柄失效
+    n.next = free_head;
+    free_head = i;
+  }
+
+  std::uint32_t slot_for(std::uint64_t expiry) const {
+    std::uint64_t delta = expiry - current_tick;
+    // 超出量程：只截断槽位，放在最外层能表示的最远处，降级时再按真实截止时间重新插入
+    if (delta > MAX_DELTA) delta = MAX_DELTA;
+    const std::uint64_t target = current_tick + delta;
+    if (delta < ROOT_SIZE) return target & (ROOT_SIZE - 1);
+    for (int level = 1; level < LEVELS; ++level) {
+      int shift = ROOT_BITS + level * LEVEL_BITS;
+      if (delta < (std::uint64_t(1) << shift)) {
+        int lower = shift - LEVEL_BITS;
+        return ROOT_SIZE + (level - 1) * LEVEL_SIZE +
+               ((target >> lower) & (LEVEL_SIZE - 1));
+      }
+    }
+    return SLOT_COUNT - 1;  // 不可达
+  }
+
+  void link(std::uint32_t i) {
+    node& n = nodes[i];
+    n.slot = slot_for(n.expiry);
+    n.prev = NIL;
+    n.next = slots[n.slot];
+    if (n.next != NIL) nodes[n.next].prev = i;
+    slots[n.slot] = i;
+  }
+
+  void unlink(std::uint32_t i) {
+    node& n = nodes[i];
+    if (n.prev != NIL)
+      nodes[n.prev].next = n.next;
+    else
+      slots[n.slot] = n.next;
+    if (n.next != NIL) nodes[n.next].prev = n.prev;
+  }
+
+  // 把第 level 层第 index 个槽的节点按新的剩余时间重新插入
+  void cascade(int level, std::uint64_t index) {
+    std::uint32_t slot = ROOT_SIZE + (level - 1) * LEVEL_SIZE + index;
+    std::uint32_t i = slots[slot];
+    slots[slot] = NIL;
+    while (i != NIL) {
+      std::uint32_t next = nodes[i].next;
+      link(i);
+      i = next;
+    }
+  }
+
+  template <typename Sink>
+  void process_tick(Sink& sink) {
+    const std::uint64_t t = current_tick;
+    const std::uint64_t root_index = t & (ROOT_SIZE - 1);
+    if (root_index == 0) {
+      // 低层每转完一圈，上一层前进一个槽
+      for (int level = 1; level < LEVELS; ++level) {
+        int lower = ROOT_BITS + (level - 1) * LEVEL_BITS;
+        std::uint64_t index = (t >> lower) & (LEVEL_SIZE - 1);
+        cascade(level, index);
+        if (index != 0) break;
+      }
+    }
+
+    std::uint32_t i = slots[root_index];
+    slots[root_index] = NIL;
+    while (i != NIL) {
+      node& n = nodes[i];
+      std::uint32_t next = n.next;
+      if (n.expiry > t) {  // 还没到真实截止时间：重新插入而不是触发
+        link(i);
+        i = next;
+        continue;
+      }
+      callback cb = std::move(n.cb);
+      n.cb = nullptr;
+      release(i);
+      --count;
+      sink(std::move(cb));
+      i = next;
+    }
+    current_tick = t + 1;
+  }
+};
+
+// 驱动线程 + 线程池：回调在线程池上执行，时间轮只负责按时把它们成批取出
+class timer_service {
+ public:
+  using clock = timing_wheel::clock;
+  using timer_handle = timing_wheel::timer_handle;
+
+  explicit timer_service(thread_pool& pool_,
+                         clock::duration tick = std::chrono::milliseconds(1),
+                         std::size_t batch = 256)
+      : pool(pool_), wheel(tick), batch_size(batch),
+        driver(&timer_service::run, this) {}
+
+  ~timer_service() {
+    {
+      std::lock_guard<std::mutex> lk(mut);
+      done = true;
+    }
+    cond.notify_one();
+    driver.join();
+  }
+
+  timer_service(const timer_service&) = delete;
+  timer_service& operator=(const timer_service&) = delete;
+
+  timer_handle schedule_at(clock::time_point deadline,
+                           timing_wheel::callback cb) {
+    bool was_empty;
+    timer_handle h;
+    {
+      std::lock_guard<std::mutex> lk(mut);
+      was_empty = wheel.empty();
+      h = wheel.schedule(deadline, std::move(cb));
+    }
+    if (was_empty) cond.notify_one();  // 驱动线程在空轮上无限期睡眠
+    return h;
+  }
+
+  template <typename Rep, typename Period>
+  timer_handle schedule_after(std::chrono::duration<Rep, Period> d,
+                              timing_wheel::callback cb) {
+    return schedule_at(clock::now() + d, std::move(cb));
+  }
+
+  bool cancel(timer_handle h) {
+    std::lock_guard<std::mutex> lk(mut);
+    return wheel.cancel(h);
+  }
+
+  std::size_t pending() {
+    std::lock_guard<std::mutex> lk(mut);
+    return wheel.size();
+  }
+
+ private:
+  thread_pool& pool;
+  std::mutex mut;
+  std::condition_variable cond;
+  timing_wheel wheel;
+  std::size_t batch_size;
+  bool done = false;
+  std::thread driver;  // 最后声明：其余成员先初始化
+
+  void flush(std::vector<timing_wheel::callback>& batch) {
+    if (batch.empty()) return;
+    pool.post([b = std::move(batch)]() mutable {
+      for (auto& cb : b) cb();
+    });
+    batch = {};
+    batch.reserve(batch_size);
+  }
+
+  void run() {
+    std::vector<timing_wheel::callback> batch;
+    batch.reserve(batch_size);
+    std::unique_lock<std::mutex> lk(mut);
+    while (!done) {
+      if (wheel.empty()) {
+        cond.wait(lk, [this] { return done || !wheel.empty(); });
+        continue;
+      }
+      cond.wait_until(lk, wheel.next_tick_time(), [this] { return done; });
+      if (done) break;
+
+      std::vector<std::vector<timing_wheel::callback>> ready;
+      wheel.advance(clock::now(), [&](timing_wheel::callback&& cb) {
+        batch.push_back(std::move(cb));
+        if (batch.size() == batch_size) {
+          ready.push_back(std::move(batch));
+          batch = {};
+          batch.reserve(batch_size);
+        }
+      });
+      if (!batch.empty()) ready.push_back(std::move(batch));
+      batch = {};
+      batch.reserve(batch_size);
+
+      lk.unlock();  // 在锁外投递，避免阻塞 schedule/cancel
+      for (auto& b : ready) flush(b);
+      lk.lock();
+    }
+  }
+};
@@ -1,6 +1,8 @@
 /**
  * @file 03_atomic_flag_spinlock.cpp
  * @brief 使用 atomic_flag 实现自旋锁
+ * 自旋锁只保护一小段内存操作；日志交给异步日志（utils/async_logger.hpp），
+ * 不在临界区里做 I/O——持锁写 std::cout 会让其他线程陪着等输出。
  */
 
 #include <atomic>
@@ -8,23 +10,37 @@
 #include <thread>
 #include <vector>
 
+#include "async_logger.hpp"
+#include "trace.hpp"  // 以 -DENABLE_TRACE=ON 构建时记录锁等待
+
 // 初始化必须用 ATOMIC_FLAG_INIT (C++20之前)
-std::atomic_flag lock_stream = ATOMIC_FLAG_INIT;
+std::atomic_flag lock_flag = ATOMIC_FLAG_INIT;
+long entries = 0;  // 由 lock_flag 保护
+
+async_logger logger;  // 写 stdout
 
 void f(int n) {
+  long seen;
   // 将标志置为 true，返回旧值（true 表示“锁”已被占用，自旋等待）
-  while (lock_stream.test_and_set(std::memory_order_acquire)) {
-    std::this_thread::yield();  // 让出 CPU 时间片，避免空转
+  if (lock_flag.test_and_set(std::memory_order_acquire)) {
+    TRACE_SCOPE("spinlock.wait");  // 只有发生竞争才记录等待区间
+    while (lock_flag.test_and_set(std::memory_order_acquire)) {
+      std::this_thread::yield();  // 让出 CPU 时间片，避免空转
+    }
   }
   // ---------- 临界区开始 ----------
 
-  std::cout << "[Thread " << n << "] is in critical section.\n";
+  seen = ++entries;
 
   // ---------- 临界区结束 ----------
-  lock_stream.clear(std::memory_order_release);  // 解锁，并确保写在解锁前完成
+  lock_flag.clear(std::memory_order_release);  // 解锁，并确保写在解锁前完成
+
+  // 只记录一条定长记录，格式化和 write(2) 在后台线程完成
+  logger.log("[Thread %d] entered the critical section (#%ld).", n, seen);
 }
 
 int main() {
+  TRACE_SESSION("03_atomic_flag_spinlock.trace.json");
   std::vector<std::thread> v;  // 批量线程管理
   for (int n = 0; n < 10; ++n) {
     v.emplace_back(f, n);
@@ -32,5 +48,6 @@ int main() {
   for (auto& t : v) {
     t.join();
   }
+  logger.flush();
   return 0;
 }
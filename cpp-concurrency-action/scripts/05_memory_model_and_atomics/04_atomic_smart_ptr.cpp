@@ -1,13 +1,18 @@
 /**
  * @file 04_atomic_smart_ptr.cpp
- * @brief 使用原子智能指针管理全局配置(C++20及以上)
+ * @brief 使用原子智能指针管理全局配置
+ * C++20 用 std::atomic<std::shared_ptr>；C++17 改用 utils/atomic_shared_ptr.hpp
+ * （分离引用计数，无锁），接口相同
  */
 
 #include <atomic>
 #include <iostream>
 #include <memory>
+#include <string>
 #include <thread>
 
+#include "atomic_shared_ptr.hpp"  // C++17 下的替代实现
+
 struct Config {
   int id;
   std::string name;
@@ -16,9 +21,20 @@ struct Config {
 #if __cplusplus >= 202002L
 std::atomic<std::shared_ptr<Config>> global_config;
 
+std::shared_ptr<Config> make_config(int id, const char* name) {
+  return std::make_shared<Config>(Config{id, name});
+}
+#else
+atomic_shared_ptr<Config> global_config;
+
+counted_ptr<Config> make_config(int id, const char* name) {
+  return make_counted<Config>(Config{id, name});
+}
+#endif
+
 void updater() {
   for (int i = 0; i < 100; ++i) {
-    auto new_conf = std::make_shared<Config>(Config{i, "Updated"});
+    auto new_conf = make_config(i, "Updated");
     global_config.store(new_conf, std::memory_order_release);
   }
 }
@@ -37,7 +53,7 @@ void reader() {
 }
 
 int main() {
-  global_config.store(std::make_shared<Config>(Config{0, "Init"}));
+  global_config.store(make_config(0, "Init"));
 
   std::thread t1(updater);
   std::thread t2(reader);
@@ -47,9 +63,3 @@ int main() {
 
   return 0;
 }
-#else
-int main() {
-  std::cout << "This example requires C++20 compiler.\n";
-  return 0;
-}
-#endif
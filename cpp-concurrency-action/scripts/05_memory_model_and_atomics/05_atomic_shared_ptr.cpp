@@ -0,0 +1,214 @@
+/**
+ * @file 05_atomic_shared_ptr.cpp
+ * @brief 分离引用计数的无锁原子共享指针（utils/atomic_shared_ptr.hpp）
+ * 1) 压力测试：多个线程随机 load / store / CAS 同一个原子指针，对象带校验字段，
+ *    读到已释放的对象或结束时仍有对象未释放都会报错；
+ * 2) 读多写少：多个线程不停 load，一个线程定期 store 新配置；
+ * 3) CAS 自增：每个线程 load 当前值、构造 +1 的新对象、CAS 换上，失败重试，
+ *    最终值必须等于成功次数之和。
+ * 对比 atomic_shared_ptr、std::atomic<std::shared_ptr>（C++20，libstdc++ 内部加锁）
+ * 与互斥量保护的 std::shared_ptr。
+ * 用法：05_atomic_shared_ptr [threads] [ops_per_thread]
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "atomic_shared_ptr.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+struct payload {
+  static inline std::atomic<long> live{0};
+  static constexpr std::uint64_t ALIVE = 0x600DF00DULL, DEAD = 0xDEADBEEFULL;
+  std::uint64_t canary = ALIVE;
+  long value;
+
+  explicit payload(long v) : value(v) { live.fetch_add(1, std::memory_order_relaxed); }
+  ~payload() {
+    canary = DEAD;
+    live.fetch_sub(1, std::memory_order_relaxed);
+  }
+};
+
+// 三种实现套同一组接口：make / load / store / cas
+struct split_count_impl {
+  using ptr = counted_ptr<payload>;
+  atomic_shared_ptr<payload> a;
+  static ptr make(long v) { return make_counted<payload>(v); }
+  ptr load() { return a.load(); }
+  void store(ptr p) { a.store(std::move(p)); }
+  bool cas(ptr& expected, ptr desired) { return a.compare_exchange_strong(expected, std::move(desired)); }
+};
+
+#if __cplusplus >= 202002L
+struct std_atomic_impl {
+  using ptr = std::shared_ptr<payload>;
+  std::atomic<ptr> a;
+  static ptr make(long v) { return std::make_shared<payload>(v); }
+  ptr load() { return a.load(); }
+  void store(ptr p) { a.store(std::move(p)); }
+  bool cas(ptr& expected, ptr desired) { return a.compare_exchange_strong(expected, std::move(desired)); }
+};
+#endif
+
+struct mutex_impl {
+  using ptr = std::shared_ptr<payload>;
+  std::mutex m;
+  ptr p;
+  static ptr make(long v) { return std::make_shared<payload>(v); }
+  ptr load() {
+    std::lock_guard<std::mutex> lk(m);
+    return p;
+  }
+  void store(ptr desired) {
+    std::lock_guard<std::mutex> lk(m);
+    p.swap(desired);  // 旧对象在锁外析构
+  }
+  bool cas(ptr& expected, ptr desired) {
+    std::lock_guard<std::mutex> lk(m);
+    if (p == expected) {
+      p.swap(desired);
+      return true;
+    }
+    expected = p;
+    return false;
+  }
+};
+
+template <typename F>
+double timed(int threads, F&& body) {
+  std::vector<std::thread> workers;
+  auto t0 = Clock::now();
+  for (int t = 0; t < threads; ++t) workers.emplace_back(body, t);
+  for (auto& w : workers) w.join();
+  return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+void check(const payload* p) {
+  if (p && p->canary != payload::ALIVE) {
+    std::cerr << "use after free detected\n";
+    std::exit(1);
+  }
+}
+
+template <typename Impl>
+void stress(const char* name, int threads, long ops) {
+  {
+    Impl impl;
+    impl.store(Impl::make(0));
+    timed(threads, [&](int t) {
+      std::mt19937 rng(t);
+      for (long i = 0; i < ops; ++i) {
+        switch (rng() % 4) {
+          case 0:
+            impl.store(rng() % 8 ? Impl::make(i) : nullptr);  // 偶尔存空指针
+            break;
+          case 1: {
+            auto expected = impl.load();
+            impl.cas(expected, Impl::make(i));
+            check(expected.get());
+            break;
+          }
+          default: {
+            auto p = impl.load();
+            check(p.get());
+            auto copy = p;  // 拷贝、析构都要正确计数
+            check(copy.get());
+          }
+        }
+      }
+    });
+  }
+  const long leaked = payload::live.load();
+  std::cout << "  " << name << "  " << (leaked ? "LEAK" : "ok") << " (" << leaked
+            << " objects alive after destruction)\n";
+  if (leaked) std::exit(1);
+}
+
+template <typename Impl>
+void read_mostly(const char* name, int readers, long loads) {
+  Impl impl;
+  impl.store(Impl::make(0));
+  std::atomic<bool> done{false};
+  std::thread writer([&] {
+    for (long v = 1; !done.load(std::memory_order_relaxed); ++v) {
+      impl.store(Impl::make(v));
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+  });
+  const double secs = timed(readers, [&](int) {
+    long sum = 0;
+    for (long i = 0; i < loads; ++i) sum += impl.load()->value;
+    if (sum < 0) std::cout << sum;
+  });
+  done = true;
+  writer.join();
+  std::cout << "  " << name << "  " << std::setw(7) << readers * loads / secs / 1e6
+            << " M loads/s\n";
+}
+
+template <typename Impl>
+void cas_increment(const char* name, int threads, long increments) {
+  Impl impl;
+  impl.store(Impl::make(0));
+  std::atomic<long> retries{0};
+  const double secs = timed(threads, [&](int) {
+    long local_retries = 0;
+    for (long i = 0; i < increments; ++i) {
+      auto cur = impl.load();
+      while (!impl.cas(cur, Impl::make(cur->value + 1))) ++local_retries;
+    }
+    retries.fetch_add(local_retries);
+  });
+  const long final_value = impl.load()->value;
+  const bool ok = final_value == threads * increments;
+  std::cout << "  " << name << "  " << std::setw(7) << threads * increments / secs / 1e6
+            << " M incr/s  retries " << std::setw(7) << retries << "  " << (ok ? "ok" : "WRONG")
+            << "\n";
+  if (!ok) std::exit(1);
+}
+
+int main(int argc, char* argv[]) {
+  const int threads = argc > 1 ? std::atoi(argv[1]) : 4;
+  const long ops = argc > 2 ? std::atol(argv[2]) : 200000;
+  std::cout << std::fixed << std::setprecision(2);
+  atomic_shared_ptr<payload> probe;
+  std::cout << "atomic_shared_ptr is_lock_free: " << std::boolalpha << probe.is_lock_free();
+#if __cplusplus >= 202002L
+  std::cout << ", std::atomic<std::shared_ptr> is_lock_free: "
+            << std::atomic<std::shared_ptr<payload>>().is_lock_free();
+#endif
+  std::cout << "\n";
+
+  std::cout << "[Stress] " << threads << " threads x " << ops << " random load/store/CAS\n";
+  stress<split_count_impl>("atomic_shared_ptr           ", threads, ops);
+#if __cplusplus >= 202002L
+  stress<std_atomic_impl>("std::atomic<shared_ptr>     ", threads, ops);
+#endif
+  stress<mutex_impl>("mutex + shared_ptr          ", threads, ops);
+
+  std::cout << "[Read-mostly] " << threads << " readers, 1 writer storing every 100 us\n";
+  read_mostly<split_count_impl>("atomic_shared_ptr           ", threads, ops * 5);
+#if __cplusplus >= 202002L
+  read_mostly<std_atomic_impl>("std::atomic<shared_ptr>     ", threads, ops * 5);
+#endif
+  read_mostly<mutex_impl>("mutex + shared_ptr          ", threads, ops * 5);
+
+  std::cout << "[CAS increment] " << threads << " threads\n";
+  cas_increment<split_count_impl>("atomic_shared_ptr           ", threads, ops);
+#if __cplusplus >= 202002L
+  cas_increment<std_atomic_impl>("std::atomic<shared_ptr>     ", threads, ops);
+#endif
+  cas_increment<mutex_impl>("mutex + shared_ptr          ", threads, ops);
+  return 0;
+}
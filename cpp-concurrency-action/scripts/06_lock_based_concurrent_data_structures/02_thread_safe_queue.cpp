@@ -3,60 +3,11 @@
  * @brief 基于锁的线程安全队列实现
  * 重点关注使用 condition_variable 解决 生产者-消费者 问题。
  */
-#include <condition_variable>
+#include <chrono>
 #include <iostream>
-#include <memory>
-#include <mutex>
-#include <queue>
 #include <thread>
 
-template <typename T>
-class thread_safe_queue {
- private:
-  mutable std::mutex mut;
-  std::queue<T> data_queue;
-  std::condition_variable data_cond;
-
- public:
-  thread_safe_queue() {}
-
-  void push(T new_value) {
-    std::lock_guard<std::mutex> lk(mut);
-    data_queue.push(std::move(new_value));
-    data_cond.notify_one();  // 唤醒一个等待者
-  }
-
-  // 阻塞式 pop
-  void wait_and_pop(T& value) {
-    std::unique_lock<std::mutex> lk(mut);
-    // 等待直到队列非空
-    data_cond.wait(lk, [this] { return !data_queue.empty(); });
-    value = std::move(data_queue.front());
-    data_queue.pop();
-  }
-
-  std::shared_ptr<T> wait_and_pop() {
-    std::unique_lock<std::mutex> lk(mut);
-    data_cond.wait(lk, [this] { return !data_queue.empty(); });
-    std::shared_ptr<T> res(std::make_shared<T>(std::move(data_queue.front())));
-    data_queue.pop();
-    return res;
-  }
-
-  // 非阻塞式 pop (try_pop)
-  bool try_pop(T& value) {
-    std::lock_guard<std::mutex> lk(mut);
-    if (data_queue.empty()) return false;
-    value = std::move(data_queue.front());
-    data_queue.pop();
-    return true;
-  }
-
-  bool empty() const {
-    std::lock_guard<std::mutex> lk(mut);
-    return data_queue.empty();
-  }
-};
+#include "thread_safe_queue.hpp"  // 队列实现放在公共头文件中，供其他章节复用
 
 int main() {
   thread_safe_queue<int> queue;
@@ -79,5 +30,10 @@ int main() {
 
   producer.join();
   consumer.join();
+
+  // 限时 pop：队列已空，等待 200ms 后超时返回
+  int val;
+  if (!queue.wait_for_and_pop(val, std::chrono::milliseconds(200)))
+    std::cout << "wait_for_and_pop timed out (queue empty)\n";
   return 0;
 }
@@ -2,23 +2,51 @@
  * @file 03_fine_grained_queue.cpp
  * @brief 基于锁的细粒度线程安全队列实现
  * 重点关注对于 链表、树 这类数据结构，使用手递手（步进式）锁定。
+ * Allocator 决定节点与元素的内存来源，例如 utils/object_pool.hpp 的 pool_allocator。
  */
 
+#include <chrono>
+#include <condition_variable>
 #include <iostream>
 #include <memory>
 #include <mutex>
+#include <thread>
 
-template <typename T>
+#include "object_pool.hpp"
+
+template <typename T, typename Allocator = std::allocator<T>>
 class fine_grained_queue {
  private:
+  struct node;
+  using node_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<node>;
+  using node_traits = std::allocator_traits<node_allocator>;
+
+  // 无状态删除器：把节点还给 Allocator，unique_ptr 的大小不变
+  struct node_deleter {
+    void operator()(node* p) const {
+      node_allocator alloc;
+      node_traits::destroy(alloc, p);
+      node_traits::deallocate(alloc, p, 1);
+    }
+  };
+  using node_ptr = std::unique_ptr<node, node_deleter>;
+
   struct node {
-    std::shared_ptr<T> data;     // 数据需要在多个节点间传递
-    std::unique_ptr<node> next;  // 指针不能被共享，只能移交
+    std::shared_ptr<T> data;  // 数据需要在多个节点间传递
+    node_ptr next;            // 指针不能被共享，只能移交
   };
 
+  static node_ptr make_node() {
+    node_allocator alloc;
+    node* p = node_traits::allocate(alloc, 1);
+    node_traits::construct(alloc, p);
+    return node_ptr(p);
+  }
+
   std::mutex head_mutex;
   std::mutex tail_mutex;
-  std::unique_ptr<node> head;
+  std::condition_variable data_cond;  // 与 head_mutex 配合，等待队列非空
+  node_ptr head;
 
   node* tail;  // 原生指针，不拥有所有权，指向 head 链表的最后一个
 
@@ -27,18 +55,23 @@ class fine_grained_queue {
     return tail;
   }
 
-  std::unique_ptr<node> pop_head() {
-    std::unique_ptr<node> old_head = std::move(head);
+  node_ptr pop_head() {
+    node_ptr old_head = std::move(head);
     head = std::move(old_head->next);
     return old_head;
   }
 
  public:
-  fine_grained_queue() : head(new node), tail(head.get()) {}  // 哑节点开头
+  fine_grained_queue() : head(make_node()), tail(head.get()) {}  // 哑节点开头
+
+  // 逐个释放节点，避免 unique_ptr 链式析构在长队列上递归过深
+  ~fine_grained_queue() {
+    while (head) head = std::move(head->next);
+  }
 
   void push(T new_value) {
-    std::shared_ptr<T> new_data(std::make_shared<T>(std::move(new_value)));
-    std::unique_ptr<node> p(new node);
+    std::shared_ptr<T> new_data(std::allocate_shared<T>(Allocator(), std::move(new_value)));
+    node_ptr p(make_node());
     node* const new_tail = p.get();
 
     {
@@ -47,6 +80,10 @@ class fine_grained_queue {
       tail->next = std::move(p);
       tail = new_tail;
     }
+    // 等待者持 head_mutex 检查谓词后才睡下：这里短暂拿一下 head_mutex，
+    // 保证通知不会落在“检查完谓词、尚未睡下”的窗口里（唤醒丢失）
+    { std::lock_guard<std::mutex> head_lock(head_mutex); }
+    data_cond.notify_one();
   }
 
   std::shared_ptr<T> try_pop() {
@@ -58,7 +95,22 @@ class fine_grained_queue {
     }
 
     std::shared_ptr<T> const res = head->data;
-    std::unique_ptr<node> old_head = pop_head();
+    node_ptr old_head = pop_head();
+    return res;
+  }
+
+  // 限时 pop：超时返回 nullptr
+  template <typename Rep, typename Period>
+  std::shared_ptr<T> wait_for_and_pop(
+      std::chrono::duration<Rep, Period> const& timeout) {
+    std::unique_lock<std::mutex> head_lock(head_mutex);
+    if (!data_cond.wait_until(head_lock,
+                              std::chrono::steady_clock::now() + timeout,
+                              [&] { return head.get() != get_tail(); }))
+      return std::shared_ptr<T>();
+
+    std::shared_ptr<T> const res = head->data;
+    node_ptr old_head = pop_head();
     return res;
   }
 };
@@ -68,5 +120,23 @@ int main() {
   fq.push(42);
   auto p = fq.try_pop();
   if (p) std::cout << "Fine-grained Pop: " << *p << "\n";
+
+  std::thread producer([&] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    fq.push(7);
+  });
+  auto w = fq.wait_for_and_pop(std::chrono::milliseconds(500));  // 50ms 后拿到
+  if (w) std::cout << "Fine-grained timed Pop: " << *w << "\n";
+  producer.join();
+
+  if (!fq.wait_for_and_pop(std::chrono::milliseconds(100)))
+    std::cout << "Fine-grained timed Pop: timed out\n";
+
+  // 节点与元素从对象池分配
+  fine_grained_queue<int, pool_allocator<int>> pooled;
+  for (int i = 0; i < 1000; ++i) pooled.push(i);
+  long sum = 0;
+  while (auto v = pooled.try_pop()) sum += *v;
+  std::cout << "Pooled queue sum: " << sum << "\n";
   return 0;
 }
\ No newline at end of file
@@ -3,6 +3,9 @@
  * @brief 基于锁的线程安全查找表实现
  * 重点关注使用 分段锁 (Striped Locking) 提高并发性能。
  * 每个桶（bucket）使用独立的读写锁保护，允许多个线程并发访问不同桶的数据。
+ * 桶锁是 distributed_shared_mutex（utils/distributed_shared_mutex.hpp）：热点桶上的
+ * 并发读者各写各的计数槽，不会因为争用同一个读者计数而互相拖慢。
+ * Allocator 用于桶内链表的节点，例如 utils/object_pool.hpp 的 pool_allocator。
  */
 
 #include <algorithm>
@@ -14,21 +17,25 @@
 #include <utility>
 #include <vector>
 
-template <typename Key, typename Value, typename Hash = std::hash<Key>>
+#include "distributed_shared_mutex.hpp"
+#include "object_pool.hpp"
+
+template <typename Key, typename Value, typename Hash = std::hash<Key>,
+          typename Allocator = std::allocator<std::pair<Key, Value>>>
 class thread_safe_lookup_table {
  private:
   // 1. 定义桶类型，包含数据（键值对的链表）和保护数据的读写锁
   class bucket_type {
    private:
     typedef std::pair<Key, Value> bucket_value;
-    typedef std::list<bucket_value> bucket_data;
+    typedef std::list<bucket_value, Allocator> bucket_data;
     bucket_data data;
-    mutable std::shared_mutex mutex;  // 使用读写锁
+    mutable distributed_shared_mutex mutex;  // 使用读写锁（读者计数按线程分散）
 
    public:
     // 读操作：共享锁
     Value value_for(Key const& key, Value const& default_value) const {
-      std::shared_lock<std::shared_mutex> lock(mutex);
+      std::shared_lock<distributed_shared_mutex> lock(mutex);
       auto it = std::find_if(
           data.begin(), data.end(),
           [&](bucket_value const& item) { return item.first == key; });
@@ -37,7 +44,7 @@ class thread_safe_lookup_table {
 
     // 写操作：独占锁
     void add_or_update_mapping(Key const& key, Value const& value) {
-      std::unique_lock<std::shared_mutex> lock(mutex);
+      std::unique_lock<distributed_shared_mutex> lock(mutex);
       auto it = std::find_if(
           data.begin(), data.end(),
           [&](bucket_value const& item) { return item.first == key; });
@@ -90,5 +97,10 @@ int main() {
 
   writer.join();
   reader.join();
+
+  // 桶内链表节点从对象池分配
+  thread_safe_lookup_table<int, int, std::hash<int>, pool_allocator<std::pair<int, int>>> pooled;
+  for (int i = 0; i < 1000; ++i) pooled.add_or_update_mapping(i, i * i);
+  std::cout << "Pooled table 31 -> " << pooled.value_for(31, -1) << "\n";
   return 0;
 }
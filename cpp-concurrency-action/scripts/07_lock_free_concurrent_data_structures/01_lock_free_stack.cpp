@@ -1,25 +1,55 @@
+/**
+ * @file 01_lock_free_stack.cpp
+ * @brief 无锁栈：CAS 入栈 / 出栈，出栈的节点交给风险指针（utils/hazard_pointers.hpp）
+ * 延迟释放；节点内存来自 Allocator（可换成 utils/object_pool.hpp 的 pool_allocator）。
+ */
+
 #include <atomic>
 #include <iostream>
 #include <memory>
 #include <thread>
 #include <vector>
 
-template <typename T>
+#include "hazard_pointers.hpp"
+#include "object_pool.hpp"
+#include "perf_counters.hpp"
+
+template <typename T, typename Allocator = std::allocator<T>>
 class LockFreeStack {
  private:
   struct Node {
     std::shared_ptr<T> data;
     Node* next;
-    Node(T const& data_) : data(std::make_shared<T>(data_)), next(nullptr) {}
+    Node(T const& data_) : data(std::allocate_shared<T>(Allocator(), data_)), next(nullptr) {}
   };
 
+  using node_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+  using node_traits = std::allocator_traits<node_allocator>;
+
   std::atomic<Node*> head;
+  HazardPointerManager hp;
+
+  static void destroy_node(void* p) {
+    node_allocator alloc;
+    node_traits::destroy(alloc, static_cast<Node*>(p));
+    node_traits::deallocate(alloc, static_cast<Node*>(p), 1);
+  }
 
  public:
   LockFreeStack() : head(nullptr) {}
 
+  ~LockFreeStack() {
+    for (Node* n = head.load(); n;) {
+      Node* next = n->next;
+      destroy_node(n);
+      n = next;
+    }
+  }
+
   void push(T const& data) {
-    Node* new_node = new Node(data);
+    node_allocator alloc;
+    Node* new_node = node_traits::allocate(alloc, 1);
+    node_traits::construct(alloc, new_node, data);
     new_node->next = head.load(std::memory_order_relaxed);
 
     while (!head.compare_exchange_weak(new_node->next, new_node,
@@ -28,24 +58,52 @@ class LockFreeStack {
   }
 
   std::shared_ptr<T> pop() {
+    hp.registerThread();
     Node* old_head = head.load(std::memory_order_relaxed);
-    while (old_head && !head.compare_exchange_weak(old_head, old_head->next,
-                                                   std::memory_order_acquire,
-                                                   std::memory_order_relaxed));
-    return old_head ? old_head->data : std::shared_ptr<T>();
+    for (;;) {
+      // 先发布风险指针再确认 head 未变，之后读 old_head->next 才不会访问已释放的节点，
+      // 节点也不会被释放后重用，顺带解决了 ABA
+      Node* seen;
+      do {
+        seen = old_head;
+        hp.acquire(0, seen);
+        old_head = head.load(std::memory_order_acquire);
+      } while (old_head != seen);
+      if (!old_head ||
+          head.compare_exchange_weak(old_head, old_head->next, std::memory_order_acquire,
+                                     std::memory_order_relaxed))
+        break;
+    }
+    hp.release(0);
+    if (!old_head) return std::shared_ptr<T>();
+    std::shared_ptr<T> res = std::move(old_head->data);
+    hp.retire(old_head, &LockFreeStack::destroy_node);
+    return res;
   }
 };
 
-int main() {
-  LockFreeStack<int> stack;
-  std::thread t1([&]() {
-    for (int i = 0; i < 100; ++i) stack.push(i);
-  });
-  std::thread t2([&]() {
-    for (int i = 0; i < 100; ++i) stack.pop();
+template <typename Stack>
+void run(const char* name, perf_counters& pc, int ops) {
+  Stack stack;
+  perf_sample perf = pc.measure([&] {
+    std::thread t1([&]() {
+      for (int i = 0; i < ops; ++i) stack.push(i);
+    });
+    std::thread t2([&]() {
+      for (int i = 0; i < ops; ++i) stack.pop();
+    });
+    t1.join();
+    t2.join();
   });
-  t1.join();
-  t2.join();
+  std::cout << "  " << name << perf_summary(perf, 2.0 * ops) << std::endl;
+}
+
+int main() {
+  const int OPS = 100000;
+  perf_counters pc;  // 先于被测线程创建，计数才能覆盖它们
+  std::cout << pc.status() << "\n";
+  run<LockFreeStack<int>>("std::allocator   ", pc, OPS);
+  run<LockFreeStack<int, pool_allocator<int>>>("pool_allocator   ", pc, OPS);
   std::cout << "01_lock_free_stack: Run successfully." << std::endl;
   return 0;
-}
\ No newline at end of file
+}
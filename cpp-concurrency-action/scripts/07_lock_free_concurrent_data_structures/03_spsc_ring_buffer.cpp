@@ -1,78 +1,82 @@
+/**
+ * @file 03_spsc_ring_buffer.cpp
+ * @brief SPSC 环形缓冲区（utils/spsc_queue.hpp）+ 硬件计数器（utils/perf_counters.hpp）
+ * 1) 生产者 / 消费者传递 100 万个整数并校验顺序，附每个元素的 cycles、缓存缺失等；
+ * 2) 伪共享：两个线程各自递增自己的计数器，两个计数器挤在同一条缓存行（packed）
+ *    与各占一条缓存行（与 SPSCQueue 的 AlignedAtomic 相同的填充方式）对比，
+ *    HITM / L1d 缺失直接显示缓存行是否在核间迁移。单核机器上两线程轮流运行，看不出差别。
+ */
+
 #include <atomic>
 #include <chrono>
+#include <cstdlib>
 #include <iostream>
-#include <new>
-#include <optional>
 #include <thread>
-#include <vector>
-
-#ifdef __cpp_lib_hardware_interference_size
-using std::hardware_destructive_interference_size;
-#else
-constexpr std::size_t hardware_destructive_interference_size = 64;
-#endif
-
-template <typename T, size_t Capacity>
-class SPSCQueue {
- private:
-  struct alignas(hardware_destructive_interference_size) AlignedAtomic {
-    std::atomic<size_t> val;
-  };
 
-  std::vector<T> buffer;
-  AlignedAtomic head;
-  AlignedAtomic tail;
+#include "cache_line.hpp"
+#include "perf_counters.hpp"
+#include "spsc_queue.hpp"  // 队列实现放在公共头文件中，供其他示例复用
 
- public:
-  SPSCQueue() : buffer(Capacity + 1), head{0}, tail{0} {}
-
-  bool push(const T& item) {
-    const size_t current_tail = tail.val.load(std::memory_order_relaxed);
-    const size_t next_tail = (current_tail + 1) % (Capacity + 1);
-
-    if (next_tail == head.val.load(std::memory_order_acquire)) {
-      return false;
-    }
-    buffer[current_tail] = item;
-    tail.val.store(next_tail, std::memory_order_release);
-    return true;
-  }
+struct packed_counters {
+  std::atomic<long> a{0};
+  std::atomic<long> b{0};
+};
 
-  std::optional<T> pop() {
-    const size_t current_head = head.val.load(std::memory_order_relaxed);
-    if (current_head == tail.val.load(std::memory_order_acquire)) {
-      return std::nullopt;
-    }
-    T item = buffer[current_head];
-    head.val.store((current_head + 1) % (Capacity + 1),
-                   std::memory_order_release);
-    return item;
-  }
+struct padded_counters {
+  alignas(CACHE_LINE_SIZE) std::atomic<long> a{0};
+  alignas(CACHE_LINE_SIZE) std::atomic<long> b{0};
 };
 
+template <typename Counters>
+void false_sharing(const char* name, perf_counters& pc, long iterations) {
+  Counters c;
+  auto t0 = std::chrono::steady_clock::now();
+  perf_sample perf = pc.measure([&] {
+    std::thread t1([&] {
+      for (long i = 0; i < iterations; ++i) c.a.fetch_add(1, std::memory_order_relaxed);
+    });
+    std::thread t2([&] {
+      for (long i = 0; i < iterations; ++i) c.b.fetch_add(1, std::memory_order_relaxed);
+    });
+    t1.join();
+    t2.join();
+  });
+  double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+  std::cout << "  " << name << ": " << ms << " ms, " << perf_summary(perf, 2.0 * iterations)
+            << "\n";
+}
+
 int main() {
   SPSCQueue<long, 1024> queue;
   const long COUNT = 1000000;
+  perf_counters pc;  // 先于被测线程创建，计数才能覆盖它们
+  std::cout << pc.status() << "\n";
 
-  std::thread p([&]() {
-    for (long i = 0; i < COUNT; ++i)
-      while (!queue.push(i)) std::this_thread::yield();
-  });
+  perf_sample perf = pc.measure([&] {
+    std::thread p([&]() {
+      for (long i = 0; i < COUNT; ++i)
+        while (!queue.push(i)) std::this_thread::yield();
+    });
 
-  std::thread c([&]() {
-    for (long i = 0; i < COUNT; ++i) {
-      std::optional<long> v;
-      while (!(v = queue.pop())) std::this_thread::yield();
-      if (*v != i) {
-        std::cerr << "Order check failed!\n";
-        exit(1);
+    std::thread c([&]() {
+      for (long i = 0; i < COUNT; ++i) {
+        long v = queue.pop_wait();  // 队列为空时睡眠，而不是 yield 空转
+        if (v != i) {
+          std::cerr << "Order check failed!\n";
+          exit(1);
+        }
       }
-    }
-  });
+    });
 
-  p.join();
-  c.join();
+    p.join();
+    c.join();
+  });
   std::cout << "03_spsc_ring_buffer: Processed " << COUNT << " items correctly."
             << std::endl;
+  std::cout << "  " << perf_summary(perf, COUNT) << "\n";
+
+  std::cout << "[False sharing] two threads, each incrementing its own counter\n";
+  false_sharing<packed_counters>("packed (same cache line)", pc, 20000000);
+  false_sharing<padded_counters>("padded (one line each)  ", pc, 20000000);
   return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,113 @@
+/**
+ * @file 06_eventcount_blocking.cpp
+ * @brief 用 event_count 给无锁队列加上阻塞等待（utils/event_count.hpp）
+ * 对比消费者“yield 空转”与“pop_wait 睡眠”两种等待方式在稀疏流量下的表现：
+ * - 空闲 CPU：消费者线程消耗的 CPU 时间 / 墙钟时间
+ * - 唤醒延迟：生产者打时间戳到消费者拿到元素的间隔
+ * 用法：06_eventcount_blocking [messages] [gap_us]
+ */
+
+#include <time.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "lock_free_queue.hpp"
+#include "spsc_queue.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+long now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             Clock::now().time_since_epoch())
+      .count();
+}
+
+double thread_cpu_ms() {
+  timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+struct report {
+  double cpu_percent;
+  double avg_us;
+  double p99_us;
+};
+
+// pop 为消费者取一个元素的方式；push 为生产者投递一个时间戳
+template <typename Push, typename Pop>
+report run(int messages, int gap_us, Push push, Pop pop) {
+  std::vector<long> latency(messages);
+  double cpu_ms = 0, wall_ms = 0;
+
+  std::thread consumer([&] {
+    double cpu0 = thread_cpu_ms();
+    auto wall0 = Clock::now();
+    for (int i = 0; i < messages; ++i) {
+      long stamp = pop();
+      latency[i] = now_ns() - stamp;
+    }
+    cpu_ms = thread_cpu_ms() - cpu0;
+    wall_ms = std::chrono::duration<double, std::milli>(Clock::now() - wall0)
+                  .count();
+  });
+
+  for (int i = 0; i < messages; ++i) {
+    std::this_thread::sleep_for(std::chrono::microseconds(gap_us));
+    push(now_ns());
+  }
+  consumer.join();
+
+  std::sort(latency.begin(), latency.end());
+  double sum = 0;
+  for (long l : latency) sum += l;
+  return {100.0 * cpu_ms / wall_ms, sum / messages / 1e3,
+          latency[messages * 99 / 100] / 1e3};
+}
+
+void print(const std::string& name, const report& r) {
+  std::cout << name << "  cpu " << r.cpu_percent << "%  avg " << r.avg_us
+            << " us  p99 " << r.p99_us << " us\n";
+}
+
+int main(int argc, char* argv[]) {
+  int messages = argc > 1 ? std::atoi(argv[1]) : 500;
+  int gap_us = argc > 2 ? std::atoi(argv[2]) : 1000;
+  std::cout << messages << " messages, one every " << gap_us
+            << " us (consumer idle most of the time)\n";
+
+  {
+    SPSCQueue<long, 1024> q;
+    auto push = [&](long v) {
+      while (!q.push(v)) std::this_thread::yield();
+    };
+    print("SPSCQueue     yield loop  ", run(messages, gap_us, push, [&] {
+            std::optional<long> v;
+            while (!(v = q.pop())) std::this_thread::yield();
+            return *v;
+          }));
+    print("SPSCQueue     pop_wait    ", run(messages, gap_us, push, [&] {
+            return q.pop_wait();
+          }));
+  }
+  {
+    LockFreeQueue<long> q;
+    auto push = [&](long v) { q.enqueue(v); };
+    print("LockFreeQueue yield loop  ", run(messages, gap_us, push, [&] {
+            std::shared_ptr<long> v;
+            while (!(v = q.dequeue())) std::this_thread::yield();
+            return *v;
+          }));
+    print("LockFreeQueue dequeue_wait", run(messages, gap_us, push, [&] {
+            return *q.dequeue_wait();
+          }));
+  }
+  return 0;
+}
@@ -0,0 +1,164 @@
+/**
+ * @file 07_spsc_wait_strategies.cpp
+ * @brief SPSCQueue 的等待策略对比（utils/wait_strategy.hpp）
+ * 同一个队列算法，只换 WaitStrategy 模板参数：
+ * 1) 限时等待：pop_wait_for 超时返回 std::nullopt；
+ * 2) ping-pong：两个线程通过一对队列来回传递一个数，测往返延迟（平均 / p99）与进程 CPU 占用；
+ * 3) 稀疏流量：生产者每 gap_us 发一条，测消费者的唤醒延迟与空闲 CPU。
+ * CPU 占用 = 线程 CPU 时间 / 墙钟时间，ping-pong 两个线程合计最高 200%。
+ * 用法：07_spsc_wait_strategies [rounds] [messages] [gap_us]
+ */
+
+#include <sys/resource.h>
+#include <time.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "spsc_queue.hpp"
+#include "wait_strategy.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+long now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             Clock::now().time_since_epoch())
+      .count();
+}
+
+double process_cpu_ms() {
+  rusage ru;
+  getrusage(RUSAGE_SELF, &ru);
+  return (ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1e3 +
+         (ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) / 1e3;
+}
+
+double thread_cpu_ms() {
+  timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+struct report {
+  double avg_us;
+  double p99_us;
+  double cpu_percent;
+};
+
+report summarize(std::vector<long>& samples, double cpu_ms, double wall_ms) {
+  std::sort(samples.begin(), samples.end());
+  double sum = 0;
+  for (long s : samples) sum += s;
+  return {sum / samples.size() / 1e3, samples[samples.size() * 99 / 100] / 1e3,
+          100.0 * cpu_ms / wall_ms};
+}
+
+template <typename Strategy>
+report ping_pong(int rounds) {
+  SPSCQueue<int, 64, Strategy> ping, pong;
+  std::vector<long> rtt(rounds);
+
+  std::thread echo([&] {
+    for (int i = 0; i < rounds; ++i) pong.push_wait(ping.pop_wait());
+  });
+
+  double cpu0 = process_cpu_ms();
+  auto wall0 = Clock::now();
+  for (int i = 0; i < rounds; ++i) {
+    long t0 = now_ns();
+    ping.push_wait(i);
+    if (pong.pop_wait() != i) {
+      std::cerr << "ping-pong out of order\n";
+      std::exit(1);
+    }
+    rtt[i] = now_ns() - t0;
+  }
+  echo.join();
+  double cpu_ms = process_cpu_ms() - cpu0;
+  double wall_ms =
+      std::chrono::duration<double, std::milli>(Clock::now() - wall0).count();
+  return summarize(rtt, cpu_ms, wall_ms);
+}
+
+template <typename Strategy>
+report sparse(int messages, int gap_us) {
+  SPSCQueue<long, 1024, Strategy> q;
+  std::vector<long> latency(messages);
+  double cpu_ms = 0, wall_ms = 0;
+
+  std::thread consumer([&] {
+    double cpu0 = thread_cpu_ms();
+    auto wall0 = Clock::now();
+    for (int i = 0; i < messages; ++i) {
+      long stamp = q.pop_wait();
+      latency[i] = now_ns() - stamp;
+    }
+    cpu_ms = thread_cpu_ms() - cpu0;
+    wall_ms = std::chrono::duration<double, std::milli>(Clock::now() - wall0)
+                  .count();
+  });
+
+  for (int i = 0; i < messages; ++i) {
+    std::this_thread::sleep_for(std::chrono::microseconds(gap_us));
+    q.push_wait(now_ns());
+  }
+  consumer.join();
+  return summarize(latency, cpu_ms, wall_ms);
+}
+
+void print_cell(const report& r) {
+  std::cout << std::setw(9) << r.avg_us << std::setw(9) << r.p99_us
+            << std::setw(8) << r.cpu_percent << "%";
+}
+
+template <typename Strategy>
+void row(const std::string& name, int rounds, int messages, int gap_us,
+         bool skip_ping_pong = false) {
+  std::cout << std::left << std::setw(20) << name << std::right;
+  if (skip_ping_pong)
+    std::cout << std::setw(27) << "(skipped)";
+  else
+    print_cell(ping_pong<Strategy>(rounds));
+  std::cout << "  |";
+  print_cell(sparse<Strategy>(messages, gap_us));
+  std::cout << "\n";
+}
+
+int main(int argc, char* argv[]) {
+  int rounds = argc > 1 ? std::atoi(argv[1]) : 20000;
+  int messages = argc > 2 ? std::atoi(argv[2]) : 500;
+  int gap_us = argc > 3 ? std::atoi(argv[3]) : 1000;
+
+  // 1. 限时等待
+  {
+    SPSCQueue<int, 16> q;
+    auto t0 = Clock::now();
+    auto v = q.pop_wait_for(std::chrono::milliseconds(20));
+    std::cout << "[Timed] pop_wait_for(20ms) on empty queue -> "
+              << (v ? "value" : "nullopt") << " after "
+              << std::chrono::duration<double, std::milli>(Clock::now() - t0).count()
+              << " ms\n\n";
+  }
+
+  // 2~3. 策略矩阵。单核上两个 busy-spin 线程只能靠时间片轮转交接，每次往返要等几毫秒
+  const bool single_core = std::thread::hardware_concurrency() < 2;
+
+  std::cout << std::fixed << std::setprecision(1);
+  std::cout << "ping-pong: " << rounds << " round trips;  sparse: " << messages
+            << " messages every " << gap_us << " us\n";
+  std::cout << "                     rtt avg  rtt p99     cpu  |  lat avg  lat p99  "
+               "idle cpu\n";
+  std::cout << "                        (us)     (us)  (2 thr) |     (us)     (us)  "
+               "(consumer)\n";
+  row<busy_spin_wait>("busy_spin_wait", rounds, messages, gap_us, single_core);
+  row<spin_yield_wait>("spin_yield_wait", rounds, messages, gap_us);
+  row<spin_park_wait>("spin_park_wait", rounds, messages, gap_us);
+  row<timed_sleep_wait<50>>("timed_sleep_wait<50>", rounds, messages, gap_us);
+  return 0;
+}
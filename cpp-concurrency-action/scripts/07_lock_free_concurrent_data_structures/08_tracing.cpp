@@ -0,0 +1,197 @@
+/**
+ * @file 08_tracing.cpp
+ * @brief 每线程无锁环形缓冲的事件追踪（utils/trace.hpp），导出 Chrome trace / Perfetto JSON
+ * 1) 单事件开销：记录一个瞬时事件 / 一对 scope 事件的耗时，环满丢弃时的耗时，
+ *    以及没有会话（运行期关闭）时的耗时；编译期关闭时宏展开为空，开销为零；
+ * 2) 追踪一段混合负载并写入文件：LockFreeQueue 的入队 / 出队与 event_count 睡眠、
+ *    EBR 纪元推进与回收、风险指针扫描、自旋锁等待。同一负载在不记录时再跑一遍，
+ *    对比整体耗时。
+ *    每线程的环按整段负载的事件量设定（CMakeLists.txt 里的 TRACE_RING_CAPACITY），
+ *    收集线程排不上 CPU 时也不丢事件，丢弃数与开销一起报告。
+ * 本示例总是以 TRACE_ENABLED=1 编译；其余示例需要 cmake -DENABLE_TRACE=ON。
+ * 用法：08_tracing [trace_file] [ops]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "epoch_manager.hpp"
+#include "hazard_pointers.hpp"
+#include "lock_free_queue.hpp"
+#include "trace.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+double ns_since(Clock::time_point t0) {
+  return std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+}
+
+// 每轮最多写半个环，然后立即倒空，保证测到的是“环未满”的记录路径
+void bench_event_cost() {
+  constexpr int BATCH = std::min(TRACE_RING_CAPACITY / 2, 4096);
+  constexpr int ROUNDS = 200;
+  std::cout << "[Per-event cost]\n" << std::fixed << std::setprecision(1);
+
+  trace::session s("/dev/null");
+  double instant_ns = 0, scope_ns = 0;
+  for (int r = 0; r < ROUNDS; ++r) {
+    auto t0 = Clock::now();
+    for (int i = 0; i < BATCH; ++i) trace::instant("bench.instant", i);
+    instant_ns += ns_since(t0);
+    s.flush();
+
+    t0 = Clock::now();
+    for (int i = 0; i < BATCH / 2; ++i) trace::scope sc("bench.scope");
+    scope_ns += ns_since(t0);
+    s.flush();
+  }
+  std::cout << "  instant event           " << std::setw(6)
+            << instant_ns / (ROUNDS * BATCH) << " ns\n";
+  std::cout << "  scope (begin + end)     " << std::setw(6)
+            << scope_ns / (ROUNDS * BATCH / 2) << " ns\n";
+
+  // 先写满环再继续写：之后的每个事件都走丢弃路径
+  for (int i = 0; i < TRACE_RING_CAPACITY; ++i) trace::instant("bench.fill");
+  const std::uint64_t dropped_before = s.events_dropped();
+  auto t0 = Clock::now();
+  for (int i = 0; i < BATCH; ++i) trace::instant("bench.dropped");
+  const double dropped_ns = ns_since(t0) / BATCH;
+  std::cout << "  ring full (dropped)     " << std::setw(6) << dropped_ns << " ns  ("
+            << s.events_dropped() - dropped_before << " dropped)\n";
+  s.flush();
+
+  // 运行期关闭：与没有会话时相同，只剩一次 relaxed load
+  trace::recording.store(false);
+  t0 = Clock::now();
+  for (int i = 0; i < BATCH * ROUNDS; ++i) trace::instant("bench.off", i);
+  std::cout << "  no session (runtime off)" << std::setw(6) << ns_since(t0) / (BATCH * ROUNDS)
+            << " ns\n";
+  trace::recording.store(true);
+}
+
+struct Config {
+  long value;
+};
+
+// 混合负载，返回耗时（毫秒）
+double run_workload(int ops) {
+  auto t0 = Clock::now();
+  std::vector<std::thread> threads;
+
+  // 1. MPMC 队列：消费者在队列空时睡在 event_count 上
+  LockFreeQueue<int> queue;
+  for (int p = 0; p < 2; ++p)
+    threads.emplace_back([&] {
+      TRACE_THREAD_NAME("lfq producer");
+      for (int i = 0; i < ops; ++i) queue.enqueue(i);
+    });
+  for (int c = 0; c < 2; ++c)
+    threads.emplace_back([&] {
+      TRACE_THREAD_NAME("lfq consumer");
+      for (int i = 0; i < ops; ++i) queue.dequeue_wait();
+    });
+
+  // 2. EBR：读者在临界区内读配置，写者替换配置并退休旧对象
+  EpochManager ebr;
+  std::atomic<Config*> ebr_cfg{new Config{0}};
+  std::atomic<bool> ebr_done{false};
+  threads.emplace_back([&] {
+    TRACE_THREAD_NAME("ebr writer");
+    for (int i = 1; i <= ops / 10; ++i) {
+      ebr.enter();
+      ebr.retire(ebr_cfg.exchange(new Config{i}));
+      ebr.exit();
+    }
+    ebr_done = true;
+  });
+  threads.emplace_back([&] {
+    TRACE_THREAD_NAME("ebr reader");
+    long sum = 0;
+    while (!ebr_done.load()) {
+      ebr.enter();
+      sum += ebr_cfg.load(std::memory_order_acquire)->value;
+      ebr.exit();
+    }
+    (void)sum;
+  });
+
+  // 3. 风险指针：发布后复查，保证读到的对象尚未被退休
+  HazardPointerManager hp;
+  std::atomic<Config*> hp_cfg{new Config{0}};
+  std::atomic<bool> hp_done{false};
+  threads.emplace_back([&] {
+    TRACE_THREAD_NAME("hp writer");
+    hp.registerThread();
+    for (int i = 1; i <= ops / 10; ++i) hp.retire(hp_cfg.exchange(new Config{i}));
+    hp_done = true;
+  });
+  threads.emplace_back([&] {
+    TRACE_THREAD_NAME("hp reader");
+    hp.registerThread();
+    long sum = 0;
+    while (!hp_done.load()) {
+      Config* c;
+      do {
+        c = hp_cfg.load(std::memory_order_acquire);
+        hp.acquire(0, c);
+      } while (c != hp_cfg.load(std::memory_order_acquire));
+      sum += c->value;
+      hp.release(0);
+    }
+    (void)sum;
+  });
+
+  // 4. 自旋锁：只有竞争时才记录等待区间
+  std::atomic_flag lock = ATOMIC_FLAG_INIT;
+  long counter = 0;
+  for (int t = 0; t < 2; ++t)
+    threads.emplace_back([&] {
+      TRACE_THREAD_NAME("spinlock");
+      for (int i = 0; i < ops / 10; ++i) {
+        if (lock.test_and_set(std::memory_order_acquire)) {
+          TRACE_SCOPE("spinlock.wait");
+          while (lock.test_and_set(std::memory_order_acquire)) std::this_thread::yield();
+        }
+        ++counter;
+        lock.clear(std::memory_order_release);
+      }
+    });
+
+  for (auto& t : threads) t.join();
+  delete ebr_cfg.load();
+  delete hp_cfg.load();
+  return ns_since(t0) / 1e6;
+}
+
+int main(int argc, char* argv[]) {
+  const std::string path = argc > 1 ? argv[1] : "08_tracing.trace.json";
+  const int ops = argc > 2 ? std::atoi(argv[2]) : 20000;
+
+  bench_event_cost();
+
+  std::cout << "\n[Workload] " << ops << " queue ops per thread, traced into " << path << "\n";
+  double untraced_ms = run_workload(ops);  // 预热，同时作为不记录时的基线
+  untraced_ms = std::min(untraced_ms, run_workload(ops));
+  double traced_ms;
+  std::uint64_t written, dropped;
+  {
+    trace::session s(path, std::chrono::milliseconds(1));
+    TRACE_THREAD_NAME("main");
+    traced_ms = run_workload(ops);
+    s.flush();
+    written = s.events_written();
+    dropped = s.events_dropped();
+  }
+  std::cout << "  untraced " << untraced_ms << " ms, traced " << traced_ms << " ms (+"
+            << (traced_ms / untraced_ms - 1) * 100 << "%), " << written << " events written, "
+            << dropped << " dropped\n"
+            << "  open the file in chrome://tracing or https://ui.perfetto.dev\n";
+  return 0;
+}
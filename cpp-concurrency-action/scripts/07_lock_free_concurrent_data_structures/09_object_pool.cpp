@@ -0,0 +1,277 @@
+/**
+ * @file 09_object_pool.cpp
+ * @brief 线程缓存的定长对象池（utils/object_pool.hpp）对比 new / delete（glibc malloc）
+ * 1) 本线程分配、本线程释放：每个线程反复申请一批 64 字节节点，再全部释放；
+ * 2) 跨线程释放：生产者分配、经 SPSCQueue 交给消费者释放，对象经仓库回流给生产者；
+ * 3) LockFreeQueue<int> 与 LockFreeQueue<int, pool_allocator<int>> 的多生产者多消费者吞吐；
+ * 4) 回收：池里分配的对象经 EBR / 风险指针退休，释放函数把它还给池，池的占用不再增长；
+ * 5) 线程退出：大量短命线程各退休一批节点后退出，线程退出时的最后一次扫描发生在本线程的
+ *    弹匣析构之后，对象经仓库回到池里，池的占用同样不增长。
+ * 每组配置在 fork 出的子进程里运行（fork 时还没有任何线程），峰值 RSS 互不影响；
+ * 报告的 RSS 为子进程结束时的 VmHWM 减去开始时的 VmRSS。
+ * 用法：09_object_pool [threads]
+ */
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "epoch_manager.hpp"
+#include "hazard_pointers.hpp"
+#include "lock_free_queue.hpp"
+#include "object_pool.hpp"
+#include "spsc_queue.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+double seconds_since(Clock::time_point t0) {
+  return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+struct node {
+  node* next;
+  long payload[7];
+};  // 64 字节，与链表 / 队列节点的量级相当
+
+struct heap_policy {
+  static constexpr const char* name = "new/delete    ";
+  static node* make() { return new node; }
+  static void destroy(node* n) { delete n; }
+  static std::size_t reserved() { return 0; }
+};
+
+struct pool_policy {
+  static constexpr const char* name = "pool_allocator";
+  using pool = pool_allocator<node>::pool;
+  static node* make() { return new (pool::instance().allocate()) node; }
+  static void destroy(node* n) { pool::instance().deallocate(n); }
+  static void release(void* p) { destroy(static_cast<node*>(p)); }  // 给 EBR / HP 的释放函数
+  static std::size_t reserved() { return pool::instance().bytes_reserved(); }
+};
+
+long status_kb(const char* key) {
+  std::ifstream f("/proc/self/status");
+  std::string line;
+  while (std::getline(f, line))
+    if (line.rfind(key, 0) == 0) return std::atol(line.c_str() + std::strlen(key));
+  return 0;
+}
+
+// 在子进程里运行 f（返回结果描述），附上峰值 RSS 增量
+template <typename F>
+void isolated(const std::string& label, F f) {
+  std::cout << std::flush;
+  pid_t pid = fork();
+  if (pid == 0) {
+    const long base_kb = status_kb("VmRSS:");
+    std::string result = f();
+    const long peak_kb = status_kb("VmHWM:") - base_kb;
+    std::cout << "  " << label << "  " << result << ", peak RSS +" << std::setprecision(1)
+              << peak_kb / 1024.0 << " MB" << std::endl;
+    std::_Exit(0);
+  }
+  int status = 0;
+  waitpid(pid, &status, 0);
+  if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) std::cerr << "  " << label << " failed\n";
+}
+
+std::string mops(double ops, double secs) {
+  char buf[64];
+  std::snprintf(buf, sizeof(buf), "%7.2f Mops/s", ops / secs / 1e6);
+  return buf;
+}
+
+std::string reserved_mb(std::size_t bytes) {
+  if (!bytes) return "";
+  char buf[64];
+  std::snprintf(buf, sizeof(buf), ", pool reserved %.1f MB", bytes / 1048576.0);
+  return buf;
+}
+
+// 1) 每个线程：申请 BATCH 个节点，再全部释放，重复 rounds 次
+template <typename Policy>
+std::string local_churn(int threads, int rounds) {
+  constexpr int BATCH = 256;
+  auto t0 = Clock::now();
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t)
+    workers.emplace_back([&] {
+      std::vector<node*> batch(BATCH);
+      for (int r = 0; r < rounds; ++r) {
+        for (int i = 0; i < BATCH; ++i) {
+          batch[i] = Policy::make();
+          batch[i]->payload[0] = i;
+        }
+        for (int i = 0; i < BATCH; ++i) Policy::destroy(batch[i]);
+      }
+    });
+  for (auto& w : workers) w.join();
+  return mops(1.0 * threads * rounds * BATCH, seconds_since(t0)) + reserved_mb(Policy::reserved());
+}
+
+// 2) pairs 对生产者 / 消费者：生产者分配，消费者释放
+template <typename Policy>
+std::string cross_thread(int pairs, long count) {
+  using handoff = SPSCQueue<node*, 1024>;
+  std::vector<std::unique_ptr<handoff>> queues;
+  for (int p = 0; p < pairs; ++p) queues.push_back(std::make_unique<handoff>());
+  std::atomic<long> sum{0};
+
+  auto t0 = Clock::now();
+  std::vector<std::thread> workers;
+  for (int p = 0; p < pairs; ++p) {
+    handoff& q = *queues[p];
+    workers.emplace_back([&q, count] {
+      for (long i = 0; i < count; ++i) {
+        node* n = Policy::make();
+        n->payload[0] = i;
+        q.push_wait(n);
+      }
+    });
+    workers.emplace_back([&q, &sum, count] {
+      long local = 0;
+      for (long i = 0; i < count; ++i) {
+        node* n = q.pop_wait();
+        local += n->payload[0];
+        Policy::destroy(n);
+      }
+      sum += local;
+    });
+  }
+  for (auto& w : workers) w.join();
+  const double secs = seconds_since(t0);
+  if (sum != pairs * (count * (count - 1) / 2)) std::cerr << "checksum mismatch\n";
+  return mops(1.0 * pairs * count, secs) + reserved_mb(Policy::reserved());
+}
+
+// 3) threads 个生产者 + threads 个消费者，每个 ops 次
+template <typename Queue>
+std::string queue_throughput(int threads, int ops) {
+  Queue q;
+  auto t0 = Clock::now();
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&] {
+      for (int i = 0; i < ops; ++i) q.enqueue(i);
+    });
+    workers.emplace_back([&] {
+      for (int i = 0; i < ops; ++i) q.dequeue_wait();
+    });
+  }
+  for (auto& w : workers) w.join();
+  return mops(1.0 * threads * ops, seconds_since(t0));
+}
+
+// 4) 读者读当前对象，写者不断替换并退休旧对象；退休的对象回到池里被再次分配
+std::string reclaim_ebr(long updates) {
+  EpochManager ebr;
+  std::atomic<node*> current{pool_policy::make()};
+  std::atomic<bool> done{false};
+  std::thread reader([&] {
+    long sum = 0;
+    while (!done.load()) {
+      ebr.enter();
+      sum += current.load(std::memory_order_acquire)->payload[0];
+      ebr.exit();
+    }
+    (void)sum;
+  });
+  for (long i = 1; i <= updates; ++i) {
+    node* n = pool_policy::make();
+    n->payload[0] = i;
+    ebr.enter();
+    ebr.retire(current.exchange(n), &pool_policy::release);
+    ebr.exit();
+  }
+  done = true;
+  reader.join();
+  pool_policy::destroy(current.load());
+  return std::to_string(ebr.reclaimed()) + " reclaimed" + reserved_mb(pool_policy::reserved());
+}
+
+std::string reclaim_hp(long updates) {
+  HazardPointerManager hp;
+  std::atomic<node*> current{pool_policy::make()};
+  std::atomic<bool> done{false};
+  std::thread reader([&] {
+    hp.registerThread();
+    long sum = 0;
+    while (!done.load()) {
+      node* n;
+      do {
+        n = current.load(std::memory_order_acquire);
+        hp.acquire(0, n);
+      } while (n != current.load(std::memory_order_acquire));
+      sum += n->payload[0];
+      hp.release(0);
+    }
+    (void)sum;
+  });
+  hp.registerThread();
+  std::size_t freed = 0;
+  for (long i = 1; i <= updates; ++i) {
+    node* n = pool_policy::make();
+    n->payload[0] = i;
+    const std::size_t before = hp.pending();
+    hp.retire(current.exchange(n), &pool_policy::release);
+    if (hp.pending() < before) freed += before + 1 - hp.pending();
+  }
+  done = true;
+  reader.join();
+  freed += hp.scan();
+  pool_policy::destroy(current.load());
+  return std::to_string(freed) + " reclaimed" + reserved_mb(pool_policy::reserved());
+}
+
+// 5) 每个线程先注册风险指针、再从池里分配：线程退出时弹匣先析构，
+//    风险指针的最后一次扫描把节点还给池时只能走仓库
+std::string thread_exit_hp(int rounds) {
+  constexpr int PER_THREAD = 32;  // 少于扫描阈值，全部留到线程退出时处理
+  for (int r = 0; r < rounds; ++r)
+    std::thread([] {
+      HazardPointerManager hp;
+      hp.registerThread();
+      for (int i = 0; i < PER_THREAD; ++i) hp.retire(pool_policy::make(), &pool_policy::release);
+    }).join();
+  return std::to_string(rounds) + " threads x " + std::to_string(PER_THREAD) + " retired" +
+         reserved_mb(pool_policy::reserved());
+}
+
+int main(int argc, char* argv[]) {
+  const int threads = argc > 1 ? std::atoi(argv[1]) : 4;
+  std::cout << std::fixed << std::setprecision(2);
+
+  std::cout << "[Local alloc/free] " << threads << " threads, 64-byte nodes\n";
+  isolated(heap_policy::name, [&] { return local_churn<heap_policy>(threads, 4000); });
+  isolated(pool_policy::name, [&] { return local_churn<pool_policy>(threads, 4000); });
+
+  std::cout << "[Cross-thread free] " << threads << " producer/consumer pairs\n";
+  isolated(heap_policy::name, [&] { return cross_thread<heap_policy>(threads, 500000); });
+  isolated(pool_policy::name, [&] { return cross_thread<pool_policy>(threads, 500000); });
+
+  std::cout << "[LockFreeQueue] " << threads << " producers + " << threads << " consumers\n";
+  isolated("std::allocator", [&] { return queue_throughput<LockFreeQueue<int>>(threads, 100000); });
+  isolated("pool_allocator", [&] {
+    return queue_throughput<LockFreeQueue<int, pool_allocator<int>>>(threads, 100000);
+  });
+
+  std::cout << "[Reclamation] 1 writer + 1 reader, retired objects go back to the pool\n";
+  isolated("EBR           ", [] { return reclaim_ebr(1000000); });
+  isolated("hazard ptrs   ", [] { return reclaim_hp(1000000); });
+
+  std::cout << "[Thread exit] short-lived threads retire pool objects, then exit\n";
+  isolated("hazard ptrs   ", [] { return thread_exit_hp(2000); });
+  return 0;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file 10_async_logger.cpp
+ * @brief 异步日志（utils/async_logger.hpp）对比 std::cout + 互斥量：调用方延迟的分位数
+ * 多个线程各写 N 条日志（三个参数：整数、浮点、整数），逐次测量调用本身的耗时：
+ * 1) std::cout + std::mutex：格式化与写入都在调用线程、锁内完成；
+ * 2) async_logger，block 策略：调用只写环，环满时等待写线程；
+ * 3) async_logger，drop 策略：环满时直接丢弃，调用方延迟有上界，代价是丢日志。
+ * 两者写到同一个目标（默认 /dev/null，只比较调用方开销；传入文件路径可看真实 I/O）。
+ * 用法：10_async_logger [output] [threads] [records_per_thread]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "async_logger.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+struct latency_report {
+  std::vector<std::uint32_t> ns;  // 每次调用的耗时
+  double seconds = 0;
+};
+
+template <typename Log>
+latency_report measure(int threads, int per_thread, Log&& log_one) {
+  std::vector<std::vector<std::uint32_t>> samples(threads);
+  auto t0 = Clock::now();
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t)
+    workers.emplace_back([&, t] {
+      auto& out = samples[t];
+      out.reserve(per_thread);
+      for (int i = 0; i < per_thread; ++i) {
+        auto begin = Clock::now();
+        log_one(t, i);
+        out.push_back(static_cast<std::uint32_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin).count()));
+      }
+    });
+  for (auto& w : workers) w.join();
+
+  latency_report r;
+  r.seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+  for (auto& s : samples) r.ns.insert(r.ns.end(), s.begin(), s.end());
+  std::sort(r.ns.begin(), r.ns.end());
+  return r;
+}
+
+void print(const char* name, const latency_report& r, const std::string& extra = "") {
+  auto pct = [&](double p) { return r.ns[static_cast<std::size_t>(p * (r.ns.size() - 1))]; };
+  std::cout << "  " << name << "  p50 " << std::setw(6) << pct(0.50) << " ns  p99 " << std::setw(7)
+            << pct(0.99) << " ns  p99.9 " << std::setw(8) << pct(0.999) << " ns  max "
+            << std::setw(9) << r.ns.back() << " ns  " << std::setprecision(2)
+            << r.ns.size() / r.seconds / 1e6 << " M/s" << extra << "\n";
+}
+
+int main(int argc, char* argv[]) {
+  const std::string path = argc > 1 ? argv[1] : "/dev/null";
+  const int threads = argc > 2 ? std::atoi(argv[2]) : 4;
+  const int per_thread = argc > 3 ? std::atoi(argv[3]) : 100000;
+  std::cout << std::fixed << "[Caller latency] " << threads << " threads x " << per_thread
+            << " records -> " << path << "\n";
+
+  {
+    // 把 std::cout 重定向到目标文件，保持“std::cout + 锁”的写法不变
+    std::ofstream target(path, std::ios::app);
+    std::streambuf* saved = std::cout.rdbuf(target.rdbuf());
+    std::mutex m;
+    latency_report r = measure(threads, per_thread, [&](int t, int i) {
+      std::lock_guard<std::mutex> lk(m);
+      std::cout << "thread " << t << " order " << i << " price " << 100.0 + i * 0.01 << " qty "
+                << 7L * i << '\n';
+    });
+    std::cout.flush();
+    std::cout.rdbuf(saved);
+    print("std::cout + mutex   ", r);
+  }
+
+  for (overflow_policy policy : {overflow_policy::block, overflow_policy::drop}) {
+    std::uint64_t dropped;
+    latency_report r;
+    {
+      async_logger log(path, policy);
+      r = measure(threads, per_thread, [&](int t, int i) {
+        log.log("thread %d order %d price %.2f qty %ld", t, i, 100.0 + i * 0.01, 7L * i);
+      });
+      log.flush();
+      dropped = log.records_dropped();
+    }
+    print(policy == overflow_policy::block ? "async_logger (block)" : "async_logger (drop) ", r,
+          policy == overflow_policy::drop ? "  " + std::to_string(dropped) + " dropped" : "");
+  }
+
+  // 顺带演示输出格式（先把 std::cout 的缓冲写出，两者共用 stdout）
+  std::cout.flush();
+  async_logger log;
+  log.log("done: %d threads, %s", threads, "see notes.md for the design");
+  return 0;
+}
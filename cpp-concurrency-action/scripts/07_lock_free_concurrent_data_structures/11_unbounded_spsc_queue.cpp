@@ -0,0 +1,147 @@
+/**
+ * @file 11_unbounded_spsc_queue.cpp
+ * @brief 无界分段 SPSC 队列（utils/unbounded_spsc_queue.hpp）对比 SPSCQueue 与 LockFreeQueue
+ * 1) 突发吸收：生产者一次性写入一批数据后歇一会儿，消费者每个元素做一点计算、跟不上突发。
+ *    有界的 SPSCQueue 写满后生产者只能失败重试（stalls），交接一批的耗时被拉长到消费者的
+ *    速度；LockFreeQueue 与分段队列都能立刻收下整批，分段队列在第一批之后不再分配段；
+ * 2) 吞吐：一个生产者、一个消费者全速传递整数，不可用时 yield。
+ * 用法：11_unbounded_spsc_queue [burst_size] [work_per_item]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "lock_free_queue.hpp"
+#include "spsc_queue.hpp"
+#include "unbounded_spsc_queue.hpp"
+
+using Clock = std::chrono::steady_clock;
+using bounded_queue = SPSCQueue<long, 1024>;
+using mpmc_queue = LockFreeQueue<long>;
+using segmented_queue = unbounded_spsc_queue<long, 1024>;
+
+bool try_push(bounded_queue& q, long v) { return q.push(v); }
+bool try_push(mpmc_queue& q, long v) {
+  q.enqueue(v);
+  return true;
+}
+bool try_push(segmented_queue& q, long v) {
+  q.push(v);
+  return true;
+}
+
+bool try_pop(bounded_queue& q, long& v) {
+  auto r = q.pop();
+  return r ? (v = *r, true) : false;
+}
+bool try_pop(mpmc_queue& q, long& v) {
+  auto r = q.dequeue();
+  return r ? (v = *r, true) : false;
+}
+bool try_pop(segmented_queue& q, long& v) {
+  auto r = q.pop();
+  return r ? (v = *r, true) : false;
+}
+
+template <typename Q>
+std::size_t segments(const Q&) {
+  return 0;
+}
+std::size_t segments(const segmented_queue& q) { return q.segments_allocated(); }
+
+// 模拟消费者处理每个元素的开销
+void work(int n) {
+  for (volatile int i = 0; i < n; i = i + 1) {
+  }
+}
+
+template <typename Q>
+void burst(const char* name, int bursts, int burst_size, int work_per_item) {
+  Q q;
+  const long total = static_cast<long>(bursts) * burst_size;
+  std::thread consumer([&] {
+    long v, expected = 0;
+    while (expected < total) {
+      if (!try_pop(q, v)) {
+        std::this_thread::yield();
+        continue;
+      }
+      if (v != expected++) {
+        std::cerr << "Order check failed!\n";
+        std::exit(1);
+      }
+      work(work_per_item);
+    }
+  });
+
+  long stalls = 0;
+  std::size_t segments_first_burst = 0;  // 第一次突发结束时已分配的段数
+  std::vector<double> handoff_us;
+  for (int b = 0; b < bursts; ++b) {
+    auto t0 = Clock::now();
+    for (int i = 0; i < burst_size; ++i)
+      while (!try_push(q, static_cast<long>(b) * burst_size + i)) {
+        ++stalls;
+        std::this_thread::yield();
+      }
+    handoff_us.push_back(std::chrono::duration<double, std::micro>(Clock::now() - t0).count());
+    if (b == 0) segments_first_burst = segments(q);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));  // 突发之间留时间给消费者追上
+  }
+  consumer.join();
+
+  double sum = 0;
+  for (double us : handoff_us) sum += us;
+  std::cout << "  " << name << "  handoff avg " << std::setw(8) << sum / bursts << " us  max "
+            << std::setw(8) << *std::max_element(handoff_us.begin(), handoff_us.end())
+            << " us  producer stalls " << std::setw(8) << stalls;
+  if (segments(q))
+    std::cout << "  segments " << segments(q) << " (" << segments_first_burst
+              << " by the end of the first burst, " << segments(q) - segments_first_burst
+              << " allocated later)";
+  std::cout << "\n";
+}
+
+template <typename Q>
+void throughput(const char* name, long count) {
+  Q q;
+  auto t0 = Clock::now();
+  std::thread producer([&] {
+    for (long i = 0; i < count; ++i)
+      while (!try_push(q, i)) std::this_thread::yield();
+  });
+  long v, sum = 0;
+  for (long i = 0; i < count; ++i) {
+    while (!try_pop(q, v)) std::this_thread::yield();
+    sum += v;
+  }
+  producer.join();
+  const double secs = std::chrono::duration<double>(Clock::now() - t0).count();
+  if (sum != count * (count - 1) / 2) std::cerr << "checksum mismatch\n";
+  std::cout << "  " << name << "  " << std::setw(7) << count / secs / 1e6 << " Mops/s";
+  if (segments(q)) std::cout << "  segments " << segments(q);
+  std::cout << "\n";
+}
+
+int main(int argc, char* argv[]) {
+  const int burst_size = argc > 1 ? std::atoi(argv[1]) : 20000;
+  const int work_per_item = argc > 2 ? std::atoi(argv[2]) : 50;
+  std::cout << std::fixed << std::setprecision(1);
+
+  std::cout << "[Burst absorption] 20 bursts of " << burst_size << " items, consumer work "
+            << work_per_item << " per item\n";
+  burst<bounded_queue>("SPSCQueue<1024>           ", 20, burst_size, work_per_item);
+  burst<mpmc_queue>("LockFreeQueue             ", 20, burst_size, work_per_item);
+  burst<segmented_queue>("unbounded_spsc_queue<1024>", 20, burst_size, work_per_item);
+
+  std::cout << "[Throughput] 1 producer, 1 consumer\n" << std::setprecision(2);
+  throughput<bounded_queue>("SPSCQueue<1024>           ", 5000000);
+  throughput<mpmc_queue>("LockFreeQueue             ", 1000000);
+  throughput<segmented_queue>("unbounded_spsc_queue<1024>", 5000000);
+  return 0;
+}
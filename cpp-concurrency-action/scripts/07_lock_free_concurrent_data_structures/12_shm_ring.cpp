@@ -0,0 +1,334 @@
+/**
+ * @file 12_shm_ring.cpp
+ * @brief 共享内存消息环（utils/shm_ring.hpp）对比 Unix 域套接字：进程间传递变长消息
+ * 生产者、消费者是 fork 出来的独立进程（故障隔离），环建在 memfd 上：
+ * 1) 吞吐：不同消息大小下每秒消息数与带宽。环：生产者原地写、消费者原地读；
+ *    套接字（SOCK_SEQPACKET）：send / recv 各拷贝一次并陷入内核；
+ * 2) 往返延迟：两个进程来回传一条 64 字节消息（p50 / p99）；
+ * 3) 多生产者：3 个生产者进程写同一个环，消费者校验每个生产者的消息顺序；
+ * 4) 崩溃检测：生产者在 claim 之后、commit 之前被 SIGKILL；消费者在 claim 阻塞的环上
+ *    被 SIGKILL——对端都会得到 peer_crashed，而不是永远等下去。
+ * 用法：12_shm_ring [megabytes_per_size]
+ */
+
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "shm_ring.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+const char* to_string(shm_status s) {
+  switch (s) {
+    case shm_status::ok:
+      return "ok";
+    case shm_status::timeout:
+      return "timeout";
+    case shm_status::closed:
+      return "closed";
+    case shm_status::peer_crashed:
+      return "peer_crashed";
+  }
+  return "?";
+}
+
+double seconds_since(Clock::time_point t0) {
+  return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+// 在子进程里运行 f，然后直接退出（不执行父进程的析构与 atexit）
+template <typename F>
+pid_t spawn(F f) {
+  std::cout << std::flush;
+  pid_t pid = fork();
+  if (pid == 0) {
+    f();
+    std::_Exit(0);
+  }
+  return pid;
+}
+
+void fill(void* p, std::size_t size, std::uint64_t seq) {
+  std::memcpy(p, &seq, sizeof(seq));
+  std::memset(static_cast<char*>(p) + sizeof(seq), static_cast<int>(seq), size - sizeof(seq));
+}
+
+void report(const char* name, long count, std::size_t size, double secs) {
+  std::cout << "  " << name << std::setw(6) << size << " B  " << std::setw(8)
+            << count / secs / 1e6 << " M msg/s  " << std::setw(8)
+            << count * static_cast<double>(size) / secs / 1048576 << " MB/s\n";
+}
+
+void ring_throughput(std::size_t size, long count) {
+  int fd = shm_ring::create(4 << 20);
+  pid_t producer = spawn([&] {
+    shm_ring ring(fd);
+    ring.attach_producer();
+    for (long i = 0; i < count; ++i) {
+      void* p;
+      if (ring.claim_wait(size, p) != shm_status::ok) return;
+      fill(p, size, i);
+      ring.commit(p);
+    }
+  });
+
+  shm_ring ring(fd);
+  ring.attach_consumer();
+  auto t0 = Clock::now();
+  for (long i = 0; i < count; ++i) {
+    const void* msg;
+    std::size_t n;
+    if (ring.peek_wait(msg, n) != shm_status::ok) break;
+    std::uint64_t seq;
+    std::memcpy(&seq, msg, sizeof(seq));
+    if (seq != static_cast<std::uint64_t>(i) || n != size) {
+      std::cerr << "ring: order check failed\n";
+      std::exit(1);
+    }
+    ring.release();
+  }
+  report("shm_ring     ", count, size, seconds_since(t0));
+  waitpid(producer, nullptr, 0);
+  close(fd);
+}
+
+void socket_throughput(std::size_t size, long count) {
+  int sv[2];
+  socketpair(AF_UNIX, SOCK_SEQPACKET, 0, sv);
+  pid_t producer = spawn([&] {
+    close(sv[0]);
+    std::vector<char> buf(size);
+    for (long i = 0; i < count; ++i) {
+      fill(buf.data(), size, i);
+      if (send(sv[1], buf.data(), size, 0) < 0) return;
+    }
+  });
+  close(sv[1]);
+
+  std::vector<char> buf(size);
+  auto t0 = Clock::now();
+  for (long i = 0; i < count; ++i) {
+    const ssize_t n = recv(sv[0], buf.data(), size, 0);
+    std::uint64_t seq;
+    std::memcpy(&seq, buf.data(), sizeof(seq));
+    if (n != static_cast<ssize_t>(size) || seq != static_cast<std::uint64_t>(i)) {
+      std::cerr << "socket: order check failed\n";
+      std::exit(1);
+    }
+  }
+  report("unix socket  ", count, size, seconds_since(t0));
+  waitpid(producer, nullptr, 0);
+  close(sv[0]);
+}
+
+void print_latency(const char* name, std::vector<double>& rtt_us) {
+  std::sort(rtt_us.begin(), rtt_us.end());
+  std::cout << "  " << name << "p50 " << std::setw(7) << rtt_us[rtt_us.size() / 2] << " us  p99 "
+            << std::setw(7) << rtt_us[rtt_us.size() * 99 / 100] << " us\n";
+}
+
+void ring_ping_pong(int rounds) {
+  int to_child = shm_ring::create(64 << 10), to_parent = shm_ring::create(64 << 10);
+  pid_t echo = spawn([&] {
+    shm_ring in(to_child), out(to_parent);
+    in.attach_consumer();
+    out.attach_producer();
+    for (int i = 0; i < rounds; ++i) {
+      const void* msg;
+      std::size_t n;
+      if (in.peek_wait(msg, n) != shm_status::ok) return;
+      void* p;
+      if (out.claim_wait(n, p) != shm_status::ok) return;
+      std::memcpy(p, msg, n);
+      in.release();
+      out.commit(p);
+    }
+  });
+
+  shm_ring out(to_child), in(to_parent);
+  out.attach_producer();
+  in.attach_consumer();
+  std::vector<double> rtt_us;
+  char payload[64] = {};
+  for (int i = 0; i < rounds; ++i) {
+    auto t0 = Clock::now();
+    out.send(payload, sizeof(payload));
+    const void* msg;
+    std::size_t n;
+    if (in.peek_wait(msg, n) != shm_status::ok) break;
+    in.release();
+    rtt_us.push_back(seconds_since(t0) * 1e6);
+  }
+  print_latency("shm_ring     ", rtt_us);
+  waitpid(echo, nullptr, 0);
+  close(to_child);
+  close(to_parent);
+}
+
+void socket_ping_pong(int rounds) {
+  int sv[2];
+  socketpair(AF_UNIX, SOCK_SEQPACKET, 0, sv);
+  pid_t echo = spawn([&] {
+    close(sv[0]);
+    char buf[64];
+    for (int i = 0; i < rounds; ++i) {
+      const ssize_t n = recv(sv[1], buf, sizeof(buf), 0);
+      if (n <= 0 || send(sv[1], buf, n, 0) < 0) return;
+    }
+  });
+  close(sv[1]);
+
+  std::vector<double> rtt_us;
+  char payload[64] = {};
+  for (int i = 0; i < rounds; ++i) {
+    auto t0 = Clock::now();
+    send(sv[0], payload, sizeof(payload), 0);
+    if (recv(sv[0], payload, sizeof(payload), 0) <= 0) break;
+    rtt_us.push_back(seconds_since(t0) * 1e6);
+  }
+  print_latency("unix socket  ", rtt_us);
+  waitpid(echo, nullptr, 0);
+  close(sv[0]);
+}
+
+void multi_producer(int producers, long per_producer) {
+  struct message {
+    std::uint32_t producer;
+    std::uint32_t pad;
+    std::uint64_t seq;
+    char body[48];
+  };
+  int fd = shm_ring::create(1 << 20);
+  std::vector<pid_t> pids;
+  for (int id = 0; id < producers; ++id)
+    pids.push_back(spawn([&, id] {
+      shm_ring ring(fd);
+      ring.attach_producer();
+      for (long i = 0; i < per_producer; ++i) {
+        void* p;
+        if (ring.claim_wait(sizeof(message), p) != shm_status::ok) return;
+        auto* m = static_cast<message*>(p);
+        m->producer = id;
+        m->seq = i;
+        ring.commit(p);
+      }
+    }));
+
+  shm_ring ring(fd);
+  ring.attach_consumer();
+  std::vector<std::uint64_t> next(producers, 0);
+  long received = 0;
+  auto t0 = Clock::now();
+  const void* msg;
+  std::size_t n;
+  shm_status s;
+  while ((s = ring.peek_wait(msg, n)) == shm_status::ok) {
+    auto* m = static_cast<const message*>(msg);
+    if (m->seq != next[m->producer]++) {
+      std::cerr << "mpsc: order check failed\n";
+      std::exit(1);
+    }
+    ++received;
+    ring.release();
+  }
+  const double secs = seconds_since(t0);
+  std::cout << "  " << producers << " producers: " << received << " messages, " << std::setw(6)
+            << received / secs / 1e6 << " M msg/s, ended with " << to_string(s) << "\n";
+  for (pid_t pid : pids) waitpid(pid, nullptr, 0);
+  close(fd);
+}
+
+void crash_detection() {
+  // 生产者在 claim 之后、commit 之前被杀：这条记录永远不会提交
+  {
+    int fd = shm_ring::create(64 << 10);
+    pid_t producer = spawn([&] {
+      shm_ring ring(fd);
+      ring.attach_producer();
+      for (int i = 0; i < 5; ++i) ring.send("hello", 6);
+      void* p;
+      ring.claim_wait(64, p);
+      raise(SIGKILL);
+    });
+    shm_ring ring(fd);
+    ring.attach_consumer();
+    int received = 0;
+    const void* msg;
+    std::size_t n;
+    shm_status s;
+    auto t0 = Clock::now();
+    while ((s = ring.peek_wait(msg, n)) == shm_status::ok) {
+      ++received;
+      ring.release();
+      t0 = Clock::now();
+    }
+    std::cout << "  consumer: " << received << " messages, then " << to_string(s)
+              << " after " << seconds_since(t0) * 1e3 << " ms\n";
+    waitpid(producer, nullptr, 0);
+    close(fd);
+  }
+  // 消费者读了几条后被杀：生产者在满的环上等待，检测到对端崩溃后返回
+  {
+    int fd = shm_ring::create(4 << 10);
+    pid_t consumer = spawn([&] {
+      shm_ring ring(fd);
+      ring.attach_consumer();
+      for (int i = 0; i < 3; ++i) {
+        const void* msg;
+        std::size_t n;
+        ring.peek_wait(msg, n);
+        ring.release();
+      }
+      raise(SIGKILL);
+    });
+    shm_ring ring(fd);
+    ring.attach_producer();
+    char payload[256] = {};
+    int sent = 0;
+    shm_status s;
+    auto t0 = Clock::now();
+    while ((s = ring.send(payload, sizeof(payload))) == shm_status::ok) {
+      ++sent;
+      t0 = Clock::now();
+    }
+    std::cout << "  producer: " << sent << " messages, then " << to_string(s) << " after "
+              << seconds_since(t0) * 1e3 << " ms\n";
+    waitpid(consumer, nullptr, 0);
+    close(fd);
+  }
+}
+
+int main(int argc, char* argv[]) {
+  const long megabytes = argc > 1 ? std::atol(argv[1]) : 64;
+  std::cout << std::fixed << std::setprecision(2);
+
+  std::cout << "[Throughput] " << megabytes << " MB per message size, 1 producer process\n";
+  for (std::size_t size : {64, 1024, 16384}) {
+    const long count = megabytes * 1048576 / static_cast<long>(size);
+    ring_throughput(size, count);
+    socket_throughput(size, count);
+  }
+
+  std::cout << "[Round trip] 64-byte message, 20000 rounds\n";
+  ring_ping_pong(20000);
+  socket_ping_pong(20000);
+
+  std::cout << "[Multiple producers] 64-byte messages into one ring\n";
+  multi_producer(3, 200000);
+
+  std::cout << "[Crash detection] liveness checked every " << shm_ring::LIVENESS_CHECK.count()
+            << " ms while waiting\n";
+  crash_detection();
+  return 0;
+}
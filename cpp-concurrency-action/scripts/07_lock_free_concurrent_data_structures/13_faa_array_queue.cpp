@@ -0,0 +1,115 @@
+/**
+ * @file 13_faa_array_queue.cpp
+ * @brief fetch_add 分段队列（utils/faa_array_queue.hpp）对比 Michael-Scott 队列 LockFreeQueue
+ * 1) 入队-出队对：每个线程交替 enqueue / dequeue，线程数 1 到 64，总操作数固定。
+ *    LockFreeQueue 的入队都在同一个 tail->next 上 CAS，线程越多失败重试越多，且每个元素
+ *    分配一个节点（外加 shared_ptr 的控制块）；分段队列用 fetch_add 领槽，
+ *    每段才分配一次；
+ * 2) 生产者-消费者：一半线程只入队、一半只出队，校验每个元素恰好出队一次（求和）。
+ * 用法：13_faa_array_queue [pairs_total] [max_threads]
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "faa_array_queue.hpp"
+#include "lock_free_queue.hpp"
+
+using Clock = std::chrono::steady_clock;
+using ms_queue = LockFreeQueue<long>;
+using faa_queue = faa_array_queue<long>;
+
+bool try_pop(ms_queue& q, long& v) {
+  auto r = q.dequeue();
+  return r ? (v = *r, true) : false;
+}
+bool try_pop(faa_queue& q, long& v) {
+  auto r = q.dequeue();
+  return r ? (v = *r, true) : false;
+}
+
+template <typename Q>
+double pairs(int threads, long total) {
+  Q q;
+  const long per_thread = total / threads;
+  std::atomic<bool> go{false};
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t)
+    workers.emplace_back([&, t] {
+      while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+      long v;
+      for (long i = 0; i < per_thread; ++i) {
+        q.enqueue(t * per_thread + i);
+        while (!try_pop(q, v)) std::this_thread::yield();  // 别的线程可能先取走了
+      }
+    });
+  auto t0 = Clock::now();
+  go.store(true, std::memory_order_release);
+  for (auto& w : workers) w.join();
+  const double secs = std::chrono::duration<double>(Clock::now() - t0).count();
+  return 2.0 * per_thread * threads / secs / 1e6;
+}
+
+template <typename Q>
+void producer_consumer(const char* name, int threads, long per_producer) {
+  Q q;
+  const int producers = threads / 2, consumers = threads - producers;
+  const long total = producers * per_producer;
+  std::atomic<long> taken{0}, sum{0};
+  auto t0 = Clock::now();
+  std::vector<std::thread> workers;
+  for (int p = 0; p < producers; ++p)
+    workers.emplace_back([&, p] {
+      for (long i = 0; i < per_producer; ++i) q.enqueue(p * per_producer + i);
+    });
+  for (int c = 0; c < consumers; ++c)
+    workers.emplace_back([&] {
+      long v, local = 0;
+      while (taken.load(std::memory_order_relaxed) < total) {
+        if (!try_pop(q, v)) {
+          std::this_thread::yield();
+          continue;
+        }
+        local += v;
+        taken.fetch_add(1, std::memory_order_relaxed);
+      }
+      sum.fetch_add(local);
+    });
+  for (auto& w : workers) w.join();
+  const double secs = std::chrono::duration<double>(Clock::now() - t0).count();
+  const bool ok = sum.load() == total * (total - 1) / 2;
+  std::cout << "  " << name << "  " << std::setw(7) << total / secs / 1e6 << " M items/s  "
+            << (ok ? "sum ok" : "SUM MISMATCH") << "\n";
+  if (!ok) std::exit(1);
+}
+
+int main(int argc, char* argv[]) {
+  const long total = argc > 1 ? std::atol(argv[1]) : 1000000;
+  const int max_threads = argc > 2 ? std::atoi(argv[2]) : 64;
+  std::cout << std::fixed << std::setprecision(2);
+
+  std::cout << "[Enqueue-dequeue pairs] " << total << " pairs in total\n"
+            << "  threads  LockFreeQueue  faa_array_queue  (Mops/s)\n";
+  for (int threads = 1; threads <= max_threads; threads *= 2) {
+    const double ms = pairs<ms_queue>(threads, total);
+    const double faa = pairs<faa_queue>(threads, total);
+    std::cout << "  " << std::setw(7) << threads << "  " << std::setw(13) << ms << "  "
+              << std::setw(15) << faa << "  x" << faa / ms << "\n";
+  }
+
+  std::cout << "[Producers / consumers] 4 + 4 threads, 250000 items per producer\n";
+  producer_consumer<ms_queue>("LockFreeQueue  ", 8, 250000);
+  producer_consumer<faa_queue>("faa_array_queue", 8, 250000);
+
+  // 段只在写满时分配：一百万个元素只需要约一千个段
+  faa_queue q;
+  for (long i = 0; i < 1000000; ++i) q.enqueue(i);
+  std::cout << "[Allocation] 1000000 enqueues -> " << q.segments_allocated()
+            << " segments of 1024 slots\n";
+  return 0;
+}
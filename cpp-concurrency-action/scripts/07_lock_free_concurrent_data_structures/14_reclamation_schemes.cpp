@@ -0,0 +1,196 @@
+/**
+ * @file 14_reclamation_schemes.cpp
+ * @brief 三种内存回收策略（utils/reclaimer.hpp）对比：风险指针、EBR、QSBR
+ * 场景：读者不断读取一个共享的 config 指针，写者定期换上新 config 并退休旧的。
+ * 1) 读侧开销：每次读取的平均耗时。风险指针每次读都要 seq_cst 发布并重读确认，
+ *    EBR 每次进入临界区做一次 seq_cst store，QSBR 读侧什么都不做，
+ *    只在每 1000 次读取的循环边界宣告一次静止状态；
+ * 2) 回收延迟：从 retire 到节点真正释放的平均 / 最大耗时，以及积压的最大节点数；
+ * 3) QSBR 的离线：一个读者在阻塞调用（sleep）里待 100 ms，不离线时所有退休节点都要
+ *    等它回来，离线后回收不受影响；
+ * 4) 同一个 LockFreeQueue 换用三种策略（模板参数）的吞吐。
+ * 用法：14_reclamation_schemes [readers] [milliseconds]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "lock_free_queue.hpp"
+#include "reclaimer.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+long now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch())
+      .count();
+}
+
+struct config {
+  long value;
+  int run = 0;
+  long retired_at = 0;  // retire 时刻，释放时据此统计回收延迟
+};
+
+// 释放统计（deleter 只能是函数指针，所以用全局量）。上一轮留在退休列表里的节点
+// 可能在这一轮才释放，不计入统计
+std::atomic<int> current_run{0};
+std::atomic<long> freed{0}, latency_sum_ns{0}, latency_max_ns{0};
+
+void destroy_config(void* p) {
+  auto* c = static_cast<config*>(p);
+  if (c->run != current_run.load(std::memory_order_relaxed)) {
+    delete c;
+    return;
+  }
+  const long latency = now_ns() - c->retired_at;
+  latency_sum_ns.fetch_add(latency, std::memory_order_relaxed);
+  long max = latency_max_ns.load(std::memory_order_relaxed);
+  while (latency > max && !latency_max_ns.compare_exchange_weak(max, latency)) {
+  }
+  freed.fetch_add(1, std::memory_order_relaxed);
+  delete c;
+}
+
+struct run_result {
+  double read_ns;  // 每次读取的平均耗时
+  long retired;
+  long max_backlog;  // 已退休未释放的最大节点数
+};
+
+enum class sleeper { none, online, offline };
+
+template <typename R>
+run_result run(int readers, int millis, bool writer_enabled, sleeper with_sleeper = sleeper::none) {
+  R reclaimer;
+  std::atomic<config*> current{new config{0}};
+  std::atomic<bool> stop{false};
+  std::atomic<long> reads{0}, checksum{0};
+  const int run_id = ++current_run;
+  freed = 0;
+  latency_sum_ns = 0;
+  latency_max_ns = 0;
+
+  auto read_once = [&] {
+    typename R::guard g(reclaimer);
+    config* c = reclaimer.protect(0, current);
+    const long v = c->value;
+    reclaimer.release(0);
+    return v;
+  };
+
+  std::vector<std::thread> threads;
+  for (int r = 0; r < readers; ++r)
+    threads.emplace_back([&] {
+      long n = 0, sum = 0;
+      while (!stop.load(std::memory_order_relaxed)) {
+        for (int i = 0; i < 1000; ++i) sum += read_once();
+        n += 1000;
+        reclaimer.quiescent_state();  // 工作循环的边界
+      }
+      reclaimer.thread_offline();
+      reads.fetch_add(n, std::memory_order_relaxed);
+      checksum.fetch_add(sum, std::memory_order_relaxed);
+    });
+  if (with_sleeper != sleeper::none)
+    threads.emplace_back([&] {
+      while (!stop.load(std::memory_order_relaxed)) {
+        read_once();
+        reclaimer.quiescent_state();
+        if (with_sleeper == sleeper::offline) reclaimer.thread_offline();
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));  // 模拟阻塞调用
+        if (with_sleeper == sleeper::offline) reclaimer.thread_online();
+      }
+      reclaimer.thread_offline();
+    });
+
+  long retired = 0, max_backlog = 0;
+  auto t0 = Clock::now();
+  const auto deadline = t0 + std::chrono::milliseconds(millis);
+  while (Clock::now() < deadline) {
+    if (writer_enabled) {
+      typename R::guard g(reclaimer);
+      config* old = current.exchange(new config{retired + 1, run_id});
+      old->retired_at = now_ns();
+      reclaimer.retire(old, destroy_config);
+      ++retired;
+      max_backlog = std::max(max_backlog, retired - freed.load(std::memory_order_relaxed));
+    }
+    reclaimer.quiescent_state();
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+  }
+  stop = true;
+  for (auto& t : threads) t.join();
+  const double secs = std::chrono::duration<double>(Clock::now() - t0).count();
+  reclaimer.thread_offline();
+  delete current.load();  // 未释放的节点留在各策略的退休列表里
+  return {secs * 1e9 * readers / std::max(1L, reads.load()), retired, max_backlog};
+}
+
+template <typename R>
+void read_side(const char* name, int readers, int millis) {
+  run_result r = run<R>(readers, millis, false);
+  std::cout << "  " << name << "  " << std::setw(6) << r.read_ns << " ns/read\n";
+}
+
+template <typename R>
+void latency(const char* name, int readers, int millis, sleeper s = sleeper::none) {
+  run_result r = run<R>(readers, millis, true, s);
+  const long n = std::max(1L, freed.load());
+  std::cout << "  " << name << "  avg " << std::setw(9) << latency_sum_ns / n / 1e3 << " us  max "
+            << std::setw(9) << latency_max_ns / 1e3 << " us  backlog max " << std::setw(5)
+            << r.max_backlog << "  freed " << freed << "/" << r.retired << "\n";
+}
+
+template <typename R>
+void queue_pairs(const char* name, int threads, long per_thread) {
+  LockFreeQueue<long, std::allocator<long>, R> q;
+  R reclaimer;  // 与队列内部的实例共享同一个进程级域，用来宣告静止状态
+  auto t0 = Clock::now();
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t)
+    workers.emplace_back([&] {
+      for (long i = 0; i < per_thread; ++i) {
+        q.enqueue(i);
+        while (!q.dequeue()) std::this_thread::yield();
+        if (i % 64 == 0) reclaimer.quiescent_state();
+      }
+      reclaimer.thread_offline();
+    });
+  for (auto& w : workers) w.join();
+  const double secs = std::chrono::duration<double>(Clock::now() - t0).count();
+  std::cout << "  " << name << "  " << std::setw(6) << 2.0 * threads * per_thread / secs / 1e6
+            << " Mops/s\n";
+}
+
+int main(int argc, char* argv[]) {
+  const int readers = argc > 1 ? std::atoi(argv[1]) : 2;
+  const int millis = argc > 2 ? std::atoi(argv[2]) : 300;
+  std::cout << std::fixed << std::setprecision(2);
+
+  std::cout << "[Read-side overhead] " << readers << " readers, no writer, " << millis << " ms\n";
+  read_side<hp_reclaimer>("hazard pointers", readers, millis);
+  read_side<ebr_reclaimer>("EBR            ", readers, millis);
+  read_side<qsbr_reclaimer>("QSBR           ", readers, millis);
+
+  std::cout << "[Reclamation latency] " << readers << " readers, writer retires every ~50 us\n";
+  latency<hp_reclaimer>("hazard pointers", readers, millis);
+  latency<ebr_reclaimer>("EBR            ", readers, millis);
+  latency<qsbr_reclaimer>("QSBR           ", readers, millis);
+
+  std::cout << "[QSBR offline] plus one reader that blocks for 100 ms at a time\n";
+  latency<qsbr_reclaimer>("stays online   ", readers, millis, sleeper::online);
+  latency<qsbr_reclaimer>("goes offline   ", readers, millis, sleeper::offline);
+
+  std::cout << "[LockFreeQueue<long, std::allocator<long>, Reclaimer>] 4 threads, enqueue-dequeue pairs\n";
+  queue_pairs<hp_reclaimer>("hp_reclaimer   ", 4, 200000);
+  queue_pairs<ebr_reclaimer>("ebr_reclaimer  ", 4, 200000);
+  queue_pairs<qsbr_reclaimer>("qsbr_reclaimer ", 4, 200000);
+  return 0;
+}
@@ -0,0 +1,181 @@
+/**
+ * @file 15_triple_buffer.cpp
+ * @brief 最新值发布（utils/triple_buffer.hpp）对比互斥量保护的拷贝
+ * 写者不停发布一个 4 KB～1 MB 的状态对象（每次整体改写为新的序号），读者不停读取最新版本：
+ * 1) 互斥量 + 拷贝：写者在锁内把暂存区拷进共享对象，读者在锁内拷出一份；
+ * 2) triple_buffer（一个读者）/ multi_reader_buffer（三个读者）：写者原地写好后一次
+ *    exchange / store 发布，读者原地读，不拷贝。
+ * 分别统计发布与读取这一步本身的耗时（p50 / p99），并校验读到的快照首尾一致、序号不回退。
+ * 02_release_acquire.cpp 用一个标志只能交接一次；这里是可以无限次发布的版本。
+ * 用法：15_triple_buffer [milliseconds_per_case]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "triple_buffer.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+struct state {
+  std::uint64_t seq = 0;
+  std::vector<std::uint64_t> words;
+};
+
+class mutex_copy {
+  std::mutex m;
+  state shared;
+  state staging;  // 写者在锁外准备
+
+ public:
+  explicit mutex_copy(const state& initial) : shared(initial), staging(initial) {}
+
+  state& write_buffer() { return staging; }
+  void publish() {
+    std::lock_guard<std::mutex> lk(m);
+    shared = staging;  // 大小相同，只拷贝不分配
+  }
+
+  class reader {
+    mutex_copy& c;
+    state copy;
+
+   public:
+    explicit reader(mutex_copy& owner) : c(owner) {}
+    const state& read() {
+      std::lock_guard<std::mutex> lk(c.m);
+      copy = c.shared;
+      return copy;
+    }
+  };
+};
+
+class spsc_buffer {
+  triple_buffer<state> tb;
+
+ public:
+  explicit spsc_buffer(const state& initial) : tb(initial) {}
+
+  state& write_buffer() { return tb.write_buffer(); }
+  void publish() { tb.publish(); }
+
+  class reader {
+    triple_buffer<state>& tb;
+
+   public:
+    explicit reader(spsc_buffer& owner) : tb(owner.tb) {}
+    const state& read() { return tb.read(); }
+  };
+};
+
+class mpmc_buffer {
+  using buffer = multi_reader_buffer<state, 3>;
+  buffer b;
+
+ public:
+  explicit mpmc_buffer(const state& initial) : b(initial) {}
+
+  state& write_buffer() { return b.write_buffer(); }
+  void publish() { b.publish(); }
+
+  class reader {
+    buffer& b;
+    buffer::snapshot held;
+
+   public:
+    explicit reader(mpmc_buffer& owner) : b(owner.b) {}
+    const state& read() {
+      held.reset();  // 先归还旧快照：每个读者同一时刻只持有一块
+      held = b.read();
+      return *held;
+    }
+  };
+};
+
+struct percentiles {
+  double p50, p99;
+};
+
+percentiles summarize(std::vector<std::uint32_t>& ns) {
+  if (ns.empty()) return {0, 0};
+  std::sort(ns.begin(), ns.end());
+  return {ns[ns.size() / 2] / 1e3, ns[ns.size() * 99 / 100] / 1e3};
+}
+
+std::uint32_t elapsed_ns(Clock::time_point t0) {
+  return static_cast<std::uint32_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count());
+}
+
+template <typename Channel>
+void run(const char* name, std::size_t bytes, int readers, int millis) {
+  state initial;
+  initial.words.assign(bytes / sizeof(std::uint64_t), 0);
+  Channel channel(initial);
+  std::atomic<bool> stop{false};
+  std::vector<std::vector<std::uint32_t>> read_ns(readers);
+  std::vector<std::uint32_t> publish_ns;
+
+  std::vector<std::thread> threads;
+  for (int r = 0; r < readers; ++r)
+    threads.emplace_back([&, r] {
+      typename Channel::reader reader(channel);
+      std::uint64_t last = 0;
+      while (!stop.load(std::memory_order_relaxed)) {
+        auto t0 = Clock::now();
+        const state& s = reader.read();
+        read_ns[r].push_back(elapsed_ns(t0));
+        if (s.seq < last || s.words.front() != s.seq || s.words.back() != s.seq) {
+          std::cerr << name << ": torn or stale snapshot\n";
+          std::exit(1);
+        }
+        last = s.seq;
+      }
+    });
+
+  const auto deadline = Clock::now() + std::chrono::milliseconds(millis);
+  for (std::uint64_t seq = 1; Clock::now() < deadline; ++seq) {
+    state& s = channel.write_buffer();
+    s.seq = seq;
+    std::fill(s.words.begin(), s.words.end(), seq);  // 整体改写，两种方式相同，不计时
+    auto t0 = Clock::now();
+    channel.publish();
+    publish_ns.push_back(elapsed_ns(t0));
+  }
+  stop = true;
+  for (auto& t : threads) t.join();
+
+  std::vector<std::uint32_t> all_reads;
+  for (auto& v : read_ns) all_reads.insert(all_reads.end(), v.begin(), v.end());
+  const percentiles p = summarize(publish_ns), r = summarize(all_reads);
+  std::cout << "  " << std::setw(7) << bytes / 1024 << " KB  " << name << "  publish p50 "
+            << std::setw(8) << p.p50 << " us  p99 " << std::setw(8) << p.p99 << " us   read p50 "
+            << std::setw(8) << r.p50 << " us  p99 " << std::setw(8) << r.p99 << " us\n";
+}
+
+int main(int argc, char* argv[]) {
+  const int millis = argc > 1 ? std::atoi(argv[1]) : 200;
+  std::cout << std::fixed << std::setprecision(3);
+  const std::size_t sizes[] = {4 << 10, 64 << 10, 1 << 20};
+
+  std::cout << "[1 writer, 1 reader]\n";
+  for (std::size_t bytes : sizes) {
+    run<mutex_copy>("mutex + copy       ", bytes, 1, millis);
+    run<spsc_buffer>("triple_buffer      ", bytes, 1, millis);
+  }
+
+  std::cout << "[1 writer, 3 readers]\n";
+  for (std::size_t bytes : sizes) {
+    run<mutex_copy>("mutex + copy       ", bytes, 3, millis);
+    run<mpmc_buffer>("multi_reader_buffer", bytes, 3, millis);
+  }
+  return 0;
+}
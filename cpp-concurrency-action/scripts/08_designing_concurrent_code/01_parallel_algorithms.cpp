@@ -0,0 +1,243 @@
+/**
+ * @file 01_parallel_algorithms.cpp
+ * @brief 基于线程池的并行算法（utils/parallel_algorithms.hpp）
+ * 1) 用 stop_token 取消一次耗时的 parallel_any_of；
+ * 2) 基准：for / reduce / inclusive_scan / sort / find / any_of 的加速比曲线，
+ *    对照组为串行 std:: 算法与 std::execution::par（需要 TBB，CMake 找到时启用）。
+ * 每个数据取 3 次中的最好成绩；结果都与串行版本核对。
+ * 用法：01_parallel_algorithms [elements] [max_threads]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef WITH_STD_EXECUTION
+#include <execution>
+#endif
+
+#include "thread_pool.hpp"
+#include "utils/parallel_algorithms.hpp"
+
+using Clock = std::chrono::steady_clock;
+using value_type = std::int64_t;
+
+template <typename F>
+double best_ms(F&& f, int reps = 3) {
+  double best = 1e300;
+  for (int r = 0; r < reps; ++r) {
+    auto t0 = Clock::now();
+    f();
+    best = std::min(
+        best, std::chrono::duration<double, std::milli>(Clock::now() - t0).count());
+  }
+  return best;
+}
+
+void check(bool ok, const std::string& what) {
+  if (!ok) {
+    std::cerr << what << ": result mismatch\n";
+    std::exit(1);
+  }
+}
+
+value_type transform_op(value_type x) { return x * x % 1000003; }
+
+// 各算法的串行结果，用于核对
+struct expected {
+  value_type sum;
+  std::vector<value_type> transformed, scanned, sorted;
+  std::size_t found;
+};
+
+// 每行：一个算法在各种执行方式下的耗时（ms）
+struct timing_row {
+  std::string name;
+  std::vector<double> ms;
+};
+
+void print_header(const std::vector<unsigned>& threads) {
+  std::cout << std::left << std::setw(16) << "algorithm" << std::right
+            << std::setw(10) << "seq";
+#ifdef WITH_STD_EXECUTION
+  std::cout << std::setw(16) << "std::par";
+#endif
+  for (unsigned t : threads)
+    std::cout << std::setw(16) << ("pool(" + std::to_string(t) + ")");
+  std::cout << "\n";
+}
+
+void print_row(const timing_row& row) {
+  std::cout << std::left << std::setw(16) << row.name << std::right
+            << std::setw(10) << row.ms[0];
+  for (std::size_t i = 1; i < row.ms.size(); ++i) {
+    std::ostringstream cell;
+    cell << std::fixed << std::setprecision(1) << row.ms[i] << " (x"
+         << std::setprecision(2) << row.ms[0] / row.ms[i] << ")";
+    std::cout << std::setw(16) << cell.str();
+  }
+  std::cout << "\n";
+}
+
+int main(int argc, char* argv[]) {
+  const std::size_t N = argc > 1 ? std::atol(argv[1]) : 10000000;
+  const unsigned max_threads =
+      argc > 2 ? std::atoi(argv[2])
+               : std::max(1u, std::thread::hardware_concurrency());
+
+  // 1. 取消：谓词很慢，且永远不成立；另一个线程 20ms 后 request_stop
+  {
+    thread_pool pool(2);
+    std::vector<int> data(1 << 20);
+    std::stop_source cancel;
+    std::thread canceller([&cancel] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      cancel.request_stop();
+    });
+    auto t0 = Clock::now();
+    bool any = parallel_any_of(
+        pool, data.begin(), data.end(),
+        [](int x) {
+          std::this_thread::sleep_for(std::chrono::microseconds(10));
+          return x == 1;
+        },
+        cancel.get_token());
+    auto ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+    canceller.join();
+    std::cout << "[Cancel] parallel_any_of over " << data.size()
+              << " slow elements -> " << std::boolalpha << any
+              << ", cancelled after " << ms << " ms\n\n";
+  }
+
+  // 2. 基准
+  std::mt19937_64 rng(42);
+  std::uniform_int_distribution<value_type> dist(0, 1000000);
+  std::vector<value_type> in(N), out(N), scratch(N);
+  for (auto& x : in) x = dist(rng);
+  const value_type target = -1;  // 只在 0.9n 处出现一次，find/any_of 需要扫描大部分数据
+  in[N / 10 * 9] = target;
+
+  expected exp;
+  std::vector<timing_row> rows = {{"for (transform)", {}}, {"reduce", {}},
+                                  {"inclusive_scan", {}},  {"sort", {}},
+                                  {"find", {}},            {"any_of", {}}};
+
+  // 串行
+  exp.transformed.resize(N);
+  rows[0].ms.push_back(best_ms([&] {
+    std::transform(in.begin(), in.end(), exp.transformed.begin(), transform_op);
+  }));
+  rows[1].ms.push_back(best_ms([&] {
+    exp.sum = std::accumulate(in.begin(), in.end(), value_type(0));
+  }));
+  exp.scanned.resize(N);
+  rows[2].ms.push_back(best_ms([&] {
+    std::inclusive_scan(in.begin(), in.end(), exp.scanned.begin());
+  }));
+  rows[3].ms.push_back(best_ms([&] {
+    exp.sorted = in;
+    std::sort(exp.sorted.begin(), exp.sorted.end());
+  }, 1));
+  rows[4].ms.push_back(best_ms([&] {
+    exp.found = std::find(in.begin(), in.end(), target) - in.begin();
+  }));
+  rows[5].ms.push_back(best_ms([&] {
+    check(std::any_of(in.begin(), in.end(),
+                      [&](value_type x) { return x == target; }),
+          "any_of");
+  }));
+
+#ifdef WITH_STD_EXECUTION
+  {
+    namespace ex = std::execution;
+    rows[0].ms.push_back(best_ms([&] {
+      std::transform(ex::par, in.begin(), in.end(), out.begin(), transform_op);
+    }));
+    check(out == exp.transformed, "std::par transform");
+    value_type sum = 0;
+    rows[1].ms.push_back(best_ms([&] {
+      sum = std::reduce(ex::par, in.begin(), in.end(), value_type(0));
+    }));
+    check(sum == exp.sum, "std::par reduce");
+    rows[2].ms.push_back(best_ms([&] {
+      std::inclusive_scan(ex::par, in.begin(), in.end(), out.begin());
+    }));
+    check(out == exp.scanned, "std::par inclusive_scan");
+    rows[3].ms.push_back(best_ms([&] {
+      scratch = in;
+      std::sort(ex::par, scratch.begin(), scratch.end());
+    }, 1));
+    check(scratch == exp.sorted, "std::par sort");
+    std::size_t found = 0;
+    rows[4].ms.push_back(best_ms([&] {
+      found = std::find(ex::par, in.begin(), in.end(), target) - in.begin();
+    }));
+    check(found == exp.found, "std::par find");
+    bool any = false;
+    rows[5].ms.push_back(best_ms([&] {
+      any = std::any_of(ex::par, in.begin(), in.end(),
+                        [&](value_type x) { return x == target; });
+    }));
+    check(any, "std::par any_of");
+  }
+#endif
+
+  std::vector<unsigned> thread_counts;
+  for (unsigned t = 1; t < max_threads; t *= 2) thread_counts.push_back(t);
+  thread_counts.push_back(max_threads);
+
+  for (unsigned t : thread_counts) {
+    thread_pool pool(t);
+    rows[0].ms.push_back(best_ms([&] {
+      parallel_for(pool, std::size_t(0), N,
+                   [&](std::size_t i) { out[i] = transform_op(in[i]); }, 4096);
+    }));
+    check(out == exp.transformed, "parallel_for");
+    value_type sum = 0;
+    rows[1].ms.push_back(best_ms([&] {
+      sum = parallel_reduce(pool, in.begin(), in.end(), value_type(0));
+    }));
+    check(sum == exp.sum, "parallel_reduce");
+    rows[2].ms.push_back(best_ms([&] {
+      parallel_inclusive_scan(pool, in.begin(), in.end(), out.begin());
+    }));
+    check(out == exp.scanned, "parallel_inclusive_scan");
+    rows[3].ms.push_back(best_ms([&] {
+      scratch = in;
+      parallel_sort(pool, scratch.begin(), scratch.end());
+    }, 1));
+    check(scratch == exp.sorted, "parallel_sort");
+    std::size_t found = 0;
+    rows[4].ms.push_back(best_ms([&] {
+      found = parallel_find(pool, in.begin(), in.end(),
+                            [&](value_type x) { return x == target; }) -
+              in.begin();
+    }));
+    check(found == exp.found, "parallel_find");
+    bool any = false;
+    rows[5].ms.push_back(best_ms([&] {
+      any = parallel_any_of(pool, in.begin(), in.end(),
+                            [&](value_type x) { return x == target; });
+    }));
+    check(any, "parallel_any_of");
+  }
+
+  std::cout << N << " int64 elements, time in ms (speedup vs seq), "
+            << "hardware threads: " << std::thread::hardware_concurrency()
+            << "\n";
+  std::cout << std::fixed << std::setprecision(1);
+  print_header(thread_counts);
+  for (const auto& row : rows) print_row(row);
+  return 0;
+}
@@ -0,0 +1,223 @@
+/**
+ * @file parallel_algorithms.hpp
+ * @brief 基于线程池的并行算法：for / reduce / inclusive_scan / sort / find / any_of
+ *
+ * 所有算法都把工作投递到调用者提供的 thread_pool（不临时创建线程），调用线程自己处理第 0 块，
+ * 并在等待期间帮线程池执行排队任务（见 task_group.hpp）。
+ * - 划分：块数约为 (线程数 + 1) * 4，以吸收负载不均；每块至少 grain 个元素，避免任务开销压过计算。
+ * - parallel_reduce / parallel_inclusive_scan 要求运算满足结合律（与 std::reduce 相同）。
+ * - parallel_sort：三路划分的并行快排，递归深度超限或区间小于 cutoff 时退回 std::sort。
+ * - parallel_find 返回第一个匹配（与 std::find 语义一致）；parallel_any_of 找到任意一个就通过
+ *   stop_source 通知其余块提前退出。两者都接受外部 std::stop_token，取消时返回“未找到”。
+ */
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <stop_token>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "task_group.hpp"
+#include "thread_pool.hpp"
+
+namespace detail {
+
+struct chunk_layout {
+  std::size_t size;   // 每块元素数（最后一块可能更少）
+  std::size_t count;  // 块数
+};
+
+inline chunk_layout split(const thread_pool& pool, std::size_t n,
+                          std::size_t grain) {
+  if (n == 0) return {0, 0};
+  std::size_t target = (pool.size() + 1) * 4;
+  std::size_t size = std::max<std::size_t>({grain, (n + target - 1) / target, 1});
+  return {size, (n + size - 1) / size};
+}
+
+// f(chunk_index, begin, end)：第 0 块在调用线程上执行，其余投递到线程池
+template <typename F>
+void for_each_chunk(thread_pool& pool, chunk_layout layout, std::size_t n,
+                    F& f) {
+  if (layout.count == 0) return;
+  if (layout.count == 1) {
+    f(std::size_t(0), std::size_t(0), n);
+    return;
+  }
+  task_group group(pool);
+  for (std::size_t c = 1; c < layout.count; ++c) {
+    std::size_t b = c * layout.size;
+    std::size_t e = std::min(n, b + layout.size);
+    group.run([&f, c, b, e] { f(c, b, e); });
+  }
+  f(std::size_t(0), std::size_t(0), std::min(n, layout.size));
+  group.wait();
+}
+
+// 查找类算法按块扫描，每 SCAN_BLOCK 个元素检查一次是否该提前退出
+constexpr std::size_t SCAN_BLOCK = 1024;
+
+template <typename It, typename Compare>
+void quick_sort(thread_pool& pool, It first, It last, Compare& comp,
+                std::size_t cutoff, int depth) {
+  const auto n = static_cast<std::size_t>(last - first);
+  if (n <= cutoff || depth == 0) {
+    std::sort(first, last, comp);
+    return;
+  }
+  // 三数取中，拷贝出枢轴值（划分过程中元素会移动）
+  auto a = *first, b = *(first + n / 2), c = *(last - 1);
+  if (comp(b, a)) std::swap(a, b);
+  if (comp(c, b)) std::swap(b, c);
+  if (comp(b, a)) std::swap(a, b);
+  const auto pivot = b;
+
+  // 三路划分：[< pivot][== pivot][> pivot]，大量重复元素时中段无需再排
+  It mid1 = std::partition(first, last,
+                           [&](const auto& x) { return comp(x, pivot); });
+  It mid2 = std::partition(mid1, last,
+                           [&](const auto& x) { return !comp(pivot, x); });
+
+  task_group group(pool);
+  group.run([&pool, first, mid1, &comp, cutoff, depth] {
+    quick_sort(pool, first, mid1, comp, cutoff, depth - 1);
+  });
+  quick_sort(pool, mid2, last, comp, cutoff, depth - 1);
+  group.wait();
+}
+
+}  // namespace detail
+
+template <typename Index, typename F>
+void parallel_for(thread_pool& pool, Index first, Index last, F f,
+                  std::size_t grain = 1) {
+  static_assert(std::is_integral<Index>::value, "parallel_for needs an index range");
+  if (last <= first) return;
+  const auto n = static_cast<std::size_t>(last - first);
+  auto body = [&](std::size_t, std::size_t b, std::size_t e) {
+    for (std::size_t i = b; i < e; ++i) f(static_cast<Index>(first + i));
+  };
+  detail::for_each_chunk(pool, detail::split(pool, n, grain), n, body);
+}
+
+template <typename It, typename T, typename BinaryOp = std::plus<>>
+T parallel_reduce(thread_pool& pool, It first, It last, T init,
+                  BinaryOp op = {}, std::size_t grain = 4096) {
+  const auto n = static_cast<std::size_t>(last - first);
+  const auto layout = detail::split(pool, n, grain);
+  std::vector<T> partials(layout.count, init);  // 每块只写一次，不会伪共享
+  auto body = [&](std::size_t c, std::size_t b, std::size_t e) {
+    T acc = first[b];
+    for (std::size_t i = b + 1; i < e; ++i) acc = op(std::move(acc), first[i]);
+    partials[c] = std::move(acc);
+  };
+  detail::for_each_chunk(pool, layout, n, body);
+  for (auto& p : partials) init = op(std::move(init), std::move(p));
+  return init;
+}
+
+// 两趟扫描：1) 各块并行求和；2) 串行求块前缀（块数很少）；3) 各块带偏移并行扫描写出。
+// 支持原地扫描（d_first == first）
+template <typename InIt, typename OutIt, typename BinaryOp = std::plus<>>
+OutIt parallel_inclusive_scan(thread_pool& pool, InIt first, InIt last,
+                              OutIt d_first, BinaryOp op = {},
+                              std::size_t grain = 4096) {
+  using T = typename std::iterator_traits<InIt>::value_type;
+  const auto n = static_cast<std::size_t>(last - first);
+  const auto layout = detail::split(pool, n, grain);
+  if (layout.count <= 1) return std::inclusive_scan(first, last, d_first, op);
+
+  std::vector<T> sums(layout.count, first[0]);
+  auto reduce_chunk = [&](std::size_t c, std::size_t b, std::size_t e) {
+    if (c + 1 == layout.count) return;  // 最后一块的总和用不到
+    T acc = first[b];
+    for (std::size_t i = b + 1; i < e; ++i) acc = op(std::move(acc), first[i]);
+    sums[c] = std::move(acc);
+  };
+  detail::for_each_chunk(pool, layout, n, reduce_chunk);
+
+  for (std::size_t c = 1; c + 1 < layout.count; ++c)
+    sums[c] = op(sums[c - 1], sums[c]);  // sums[c] = 前 c+1 块的总和
+
+  auto scan_chunk = [&](std::size_t c, std::size_t b, std::size_t e) {
+    T acc = c == 0 ? T(first[b]) : op(sums[c - 1], first[b]);
+    d_first[b] = acc;
+    for (std::size_t i = b + 1; i < e; ++i) {
+      acc = op(std::move(acc), first[i]);
+      d_first[i] = acc;
+    }
+  };
+  detail::for_each_chunk(pool, layout, n, scan_chunk);
+  return d_first + n;
+}
+
+// cutoff = 0 时按线程数自动选择：区间小于它就不再拆分任务
+template <typename It, typename Compare = std::less<>>
+void parallel_sort(thread_pool& pool, It first, It last, Compare comp = {},
+                   std::size_t cutoff = 0) {
+  const auto n = static_cast<std::size_t>(last - first);
+  if (cutoff == 0)
+    cutoff = std::max<std::size_t>(2048, n / ((pool.size() + 1) * 8));
+  int depth = 0;  // 与 introsort 相同的深度上限 2*log2(n)，防止退化到 O(n^2)
+  for (std::size_t m = n; m > 1; m >>= 1) depth += 2;
+  detail::quick_sort(pool, first, last, comp, cutoff, depth);
+}
+
+template <typename It, typename Pred>
+It parallel_find(thread_pool& pool, It first, It last, Pred pred,
+                 std::stop_token stop = {}, std::size_t grain = 4096) {
+  const auto n = static_cast<std::size_t>(last - first);
+  // 目前找到的最小下标；下标更大的块/段可以直接放弃，更小的必须继续扫描
+  std::atomic<std::size_t> best{n};
+  auto body = [&](std::size_t, std::size_t b, std::size_t e) {
+    for (std::size_t i = b; i < e; i += detail::SCAN_BLOCK) {
+      if (i >= best.load(std::memory_order_relaxed) || stop.stop_requested())
+        return;
+      std::size_t end = std::min(e, i + detail::SCAN_BLOCK);
+      for (std::size_t j = i; j < end; ++j) {
+        if (pred(first[j])) {
+          std::size_t cur = best.load(std::memory_order_relaxed);
+          while (j < cur && !best.compare_exchange_weak(cur, j, std::memory_order_relaxed)) {
+          }
+          return;
+        }
+      }
+    }
+  };
+  detail::for_each_chunk(pool, detail::split(pool, n, grain), n, body);
+  if (stop.stop_requested()) return last;
+  return first + best.load();
+}
+
+template <typename It, typename Pred>
+bool parallel_any_of(thread_pool& pool, It first, It last, Pred pred,
+                     std::stop_token stop = {}, std::size_t grain = 4096) {
+  const auto n = static_cast<std::size_t>(last - first);
+  std::stop_source found;
+  // 外部取消也转发到内部 stop_source，各块只需检查一个 token
+  std::stop_callback forward(stop, [&found] { found.request_stop(); });
+  std::stop_token token = found.get_token();
+  std::atomic<bool> hit{false};
+
+  auto body = [&](std::size_t, std::size_t b, std::size_t e) {
+    for (std::size_t i = b; i < e; i += detail::SCAN_BLOCK) {
+      if (token.stop_requested()) return;
+      std::size_t end = std::min(e, i + detail::SCAN_BLOCK);
+      for (std::size_t j = i; j < end; ++j) {
+        if (pred(first[j])) {
+          hit.store(true, std::memory_order_relaxed);
+          found.request_stop();
+          return;
+        }
+      }
+    }
+  };
+  detail::for_each_chunk(pool, detail::split(pool, n, grain), n, body);
+  return hit.load() && !stop.stop_requested();
+}
@@ -0,0 +1,335 @@
+/**
+ * @file pipeline.hpp
+ * @brief 分阶段数据流流水线：每个阶段独占一个线程，阶段之间用按批传递的 SPSC 通道连接
+ *
+ * - stage      : 一个线程 + 一个 event_count（本阶段所有等待都睡在它上面）+ 统计
+ * - channel<T> : 一条 from → to 的边，内部是两条 SPSCQueue<batch*>：
+ *                full（满批次，生产者 → 消费者）与 recycled（空批次回收，消费者 → 生产者）。
+ *                批次预先分配 Depth 个并循环使用，热路径上没有内存分配；
+ *                生产者拿不到空批次 = 下游积压，于是阻塞，反压逐级传回上游。
+ * - 扇出：一个阶段连多条输出通道；扇入：consume_any 轮流从多条输入通道取批次。
+ *   每条边仍然只有一个生产者和一个消费者，所以都能用 SPSC 队列。
+ * - 延迟：批次带源头时间戳，下游阶段产生的批次继承当前输入批次的时间戳，
+ *   每个阶段取到批次时记录“源头 → 本阶段”的延迟，最后一个阶段即端到端延迟。
+ * 阶段线程由 thread_group 管理（可绑核、按阶段名命名）。
+ * 阶段函数返回后自动关闭它的所有输出通道，下游读完剩余批次后 consume 返回 false。
+ */
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "event_count.hpp"
+#include "spin_wait.hpp"
+#include "spsc_queue.hpp"
+#include "thread_group.hpp"
+
+inline std::uint64_t pipeline_now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+struct stage_stats {
+  std::uint64_t records_in = 0;
+  std::uint64_t records_out = 0;
+  std::uint64_t batches_in = 0;
+  std::uint64_t starved_ns = 0;  // 等输入
+  std::uint64_t blocked_ns = 0;  // 等输出空间（被反压）
+  std::vector<std::uint64_t> latency_ns;  // 每个输入批次：源头 → 本阶段
+};
+
+class channel_base {
+ public:
+  virtual ~channel_base() = default;
+  virtual void close() = 0;
+  virtual void report(std::ostream& os) const = 0;
+};
+
+class stage {
+ public:
+  stage(std::string name_, int cpu_) : name(std::move(name_)), cpu(cpu_) {}
+  stage(const stage&) = delete;
+  stage& operator=(const stage&) = delete;
+
+  const std::string& get_name() const { return name; }
+
+  template <typename F>
+  void set_body(F&& f) {
+    body = std::forward<F>(f);
+  }
+
+  // 先自旋，再睡在本阶段的 event_count 上，直到 ready()（可带副作用，如“尝试取批次”）成立
+  template <typename Ready>
+  void wait(Ready&& ready, std::uint64_t& wait_ns) {
+    for (int i = 0; i < default_spin_limit(); ++i) {
+      if (ready()) return;
+      cpu_relax();
+    }
+    const std::uint64_t t0 = pipeline_now_ns();
+    while (!ready()) {
+      auto key = wakeup.prepare_wait();
+      if (ready()) {
+        wakeup.cancel_wait();
+        break;
+      }
+      wakeup.commit_wait(key);
+    }
+    wait_ns += pipeline_now_ns() - t0;
+  }
+
+  void notify() { wakeup.notify(); }
+
+  stage_stats stats;
+  std::uint64_t current_stamp = 0;  // 正在处理的输入批次的源头时间戳（源头阶段为 0）
+
+ private:
+  friend class pipeline;
+  template <typename T, std::size_t Depth>
+  friend class channel;
+
+  std::string name;
+  int cpu;
+  event_count wakeup;
+  std::function<void()> body;
+  std::vector<channel_base*> outputs;
+};
+
+template <typename T>
+struct batch {
+  std::vector<T> items;
+  std::uint64_t stamp_ns = 0;
+};
+
+enum class poll_result { consumed, empty, finished };
+
+template <typename T, std::size_t Depth = 64>
+class channel : public channel_base {
+ public:
+  channel(std::string name_, stage& from, stage& to, std::size_t batch_size_)
+      : name(std::move(name_)), producer(from), consumer(to),
+        batch_size(batch_size_) {
+    for (std::size_t i = 0; i < Depth; ++i) {
+      storage.push_back(std::make_unique<batch<T>>());
+      storage.back()->items.reserve(batch_size);
+      recycled.push(storage.back().get());
+    }
+    producer.outputs.push_back(this);
+  }
+
+  // ---- 生产者端（只能由 from 阶段调用）----
+  void push(const T& item) {
+    if (!filling) acquire();
+    filling->items.push_back(item);
+    ++producer.stats.records_out;
+    if (filling->items.size() == batch_size) flush();
+  }
+
+  void flush() {
+    if (!filling || filling->items.empty()) return;
+    full.push(filling);  // 批次总数 = 队列容量，一定放得下
+    filling = nullptr;
+    consumer.notify();
+  }
+
+  void close() override {
+    if (closed.load(std::memory_order_relaxed)) return;
+    flush();
+    closed.store(true, std::memory_order_release);
+    consumer.notify();
+  }
+
+  // ---- 消费者端（只能由 to 阶段调用）----
+  // 非阻塞地取一个满批次；取到后必须交给 process 处理并归还
+  poll_result try_pop(batch<T>*& out) {
+    // 先读 closed 再 pop：若关闭后队列仍为空，才是真正读完
+    const bool was_closed = closed.load(std::memory_order_acquire);
+    auto b = full.pop();
+    if (!b) return was_closed ? poll_result::finished : poll_result::empty;
+    out = *b;
+    const std::size_t occupancy = full.size() + 1;
+    occupancy_sum += occupancy;
+    occupancy_max = std::max(occupancy_max, occupancy);
+    ++batches;
+    return poll_result::consumed;
+  }
+
+  // f(const std::vector<T>&)；处理完后批次回收给生产者
+  template <typename F>
+  void process(batch<T>* bt, F&& f) {
+    consumer.current_stamp = bt->stamp_ns;
+    consumer.stats.latency_ns.push_back(pipeline_now_ns() - bt->stamp_ns);
+    consumer.stats.records_in += bt->items.size();
+    ++consumer.stats.batches_in;
+
+    f(static_cast<const std::vector<T>&>(bt->items));
+
+    bt->items.clear();
+    recycled.push(bt);
+    producer.notify();
+  }
+
+  // 阻塞取一批并处理；流结束返回 false
+  template <typename F>
+  bool consume(F&& f) {
+    batch<T>* bt = nullptr;
+    poll_result r = try_pop(bt);
+    if (r == poll_result::empty)
+      consumer.wait([&] { return (r = try_pop(bt)) != poll_result::empty; },
+                    consumer.stats.starved_ns);
+    if (r == poll_result::finished) return false;
+    process(bt, f);
+    return true;
+  }
+
+  void report(std::ostream& os) const override {
+    os << "  " << std::left << std::setw(24) << name << std::right
+       << "  batches " << std::setw(9) << batches << "  avg occupancy "
+       << std::setw(5) << std::setprecision(1)
+       << (batches ? double(occupancy_sum) / batches : 0.0) << " / " << Depth
+       << "  max " << occupancy_max << "  producer waits " << producer_waits
+       << "\n";
+  }
+
+ private:
+  std::string name;
+  stage& producer;
+  stage& consumer;
+  const std::size_t batch_size;
+  std::vector<std::unique_ptr<batch<T>>> storage;
+  // 存指针的 SPSC 队列只作存储；等待统一由阶段的 event_count 负责，所以用不通知的策略
+  SPSCQueue<batch<T>*, Depth, busy_spin_wait> full;
+  SPSCQueue<batch<T>*, Depth, busy_spin_wait> recycled;
+  std::atomic<bool> closed{false};
+
+  batch<T>* filling = nullptr;  // 生产者正在填充的批次
+  std::uint64_t producer_waits = 0;
+  std::uint64_t batches = 0;    // 以下为消费者端统计
+  std::uint64_t occupancy_sum = 0;
+  std::size_t occupancy_max = 0;
+
+  void acquire() {
+    auto take = [&] {
+      auto b = recycled.pop();
+      if (b) filling = *b;
+      return static_cast<bool>(b);
+    };
+    if (!take()) {
+      ++producer_waits;  // 下游积压：反压
+      producer.wait(take, producer.stats.blocked_ns);
+    }
+    filling->stamp_ns =
+        producer.current_stamp ? producer.current_stamp : pipeline_now_ns();
+  }
+};
+
+// 扇入：轮流从多条输入通道取批次（取到的通道移到队尾，保证公平）；全部读完返回 false
+template <typename T, std::size_t Depth, typename F>
+bool consume_any(stage& self, std::vector<channel<T, Depth>*>& inputs, F&& f) {
+  channel<T, Depth>* from = nullptr;
+  batch<T>* bt = nullptr;
+  auto poll = [&] {
+    for (std::size_t i = 0; i < inputs.size();) {
+      poll_result r = inputs[i]->try_pop(bt);
+      if (r == poll_result::consumed) {
+        from = inputs[i];
+        std::rotate(inputs.begin(), inputs.begin() + i + 1, inputs.end());
+        return true;
+      }
+      if (r == poll_result::finished) {
+        inputs.erase(inputs.begin() + i);
+        continue;
+      }
+      ++i;
+    }
+    return inputs.empty();
+  };
+  if (!poll()) self.wait(poll, self.stats.starved_ns);
+  if (!from) return false;
+  from->process(bt, f);
+  return true;
+}
+
+class pipeline {
+ public:
+  // cpu >= 0 时把阶段线程绑定到该核心
+  stage& add_stage(std::string name, int cpu = -1) {
+    stages.push_back(std::make_unique<stage>(std::move(name), cpu));
+    return *stages.back();
+  }
+
+  template <typename T, std::size_t Depth = 64>
+  channel<T, Depth>& connect(stage& from, stage& to, std::size_t batch_size = 256) {
+    auto ch = std::make_unique<channel<T, Depth>>(
+        from.get_name() + "->" + to.get_name(), from, to, batch_size);
+    auto& ref = *ch;
+    channels.push_back(std::move(ch));
+    return ref;
+  }
+
+  // 启动所有阶段并等待全部结束，返回墙钟时间（秒）
+  double run() {
+    auto t0 = std::chrono::steady_clock::now();
+    {
+      thread_group threads;
+      for (auto& s : stages) {
+        thread_options opts{s->name, {}};
+        if (s->cpu >= 0) opts.cpus = {s->cpu};
+        threads.create_thread(std::move(opts), [st = s.get()] {
+          st->body();
+          for (auto* out : st->outputs) out->close();
+        });
+      }
+    }  // thread_group 析构时 join
+    wall_seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return wall_seconds;
+  }
+
+  void report(std::ostream& os) {
+    os << std::fixed;
+    os << "stage             in(M)    out(M)  Mrec/s  starved  blocked"
+          "  lat p50(us)  lat p99(us)\n";
+    for (auto& s : stages) {
+      auto& st = s->stats;
+      const double records =
+          static_cast<double>(std::max(st.records_in, st.records_out));
+      os << std::left << std::setw(14) << s->name << std::right
+         << std::setprecision(2) << std::setw(9) << st.records_in / 1e6
+         << std::setw(10) << st.records_out / 1e6 << std::setw(8)
+         << records / wall_seconds / 1e6 << std::setprecision(1)
+         << std::setw(8) << percent(st.starved_ns) << "%" << std::setw(8)
+         << percent(st.blocked_ns) << "%";
+      if (st.latency_ns.empty()) {
+        os << std::setw(13) << "-" << std::setw(13) << "-";
+      } else {
+        auto& lat = st.latency_ns;
+        std::sort(lat.begin(), lat.end());
+        os << std::setw(13) << lat[lat.size() / 2] / 1e3 << std::setw(13)
+           << lat[lat.size() * 99 / 100] / 1e3;
+      }
+      os << "\n";
+    }
+    os << "channels:\n";
+    for (auto& c : channels) c->report(os);
+  }
+
+ private:
+  std::vector<std::unique_ptr<stage>> stages;
+  std::vector<std::unique_ptr<channel_base>> channels;
+  double wall_seconds = 0;
+
+  double percent(std::uint64_t ns) const {
+    return 100.0 * ns / 1e9 / wall_seconds;
+  }
+};
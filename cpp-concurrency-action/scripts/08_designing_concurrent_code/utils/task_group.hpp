@@ -0,0 +1,64 @@
+/**
+ * @file task_group.hpp
+ * @brief 一组投递到线程池的子任务 + “边等边帮”的汇合点
+ *
+ * - run(f) : 把 f 投递到线程池，组内未完成计数 +1
+ * - wait() : 等组内任务全部完成；等待期间通过 pool.run_pending_task() 执行排队中的任务，
+ *            因此可以在线程池的工作线程里递归地 run/wait（分治排序等），不会因互相等待而死锁
+ * 第一个抛出的异常被保存下来，由 wait() 重新抛出；析构时也会等待，子任务不会引用到已销毁的栈对象。
+ */
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "thread_pool.hpp"
+
+class task_group {
+  thread_pool& pool;
+  std::atomic<std::size_t> pending{0};
+  std::mutex error_mut;
+  std::exception_ptr error;
+
+  void help_until_done() {
+    while (pending.load(std::memory_order_acquire) != 0) {
+      if (!pool.run_pending_task()) std::this_thread::yield();
+    }
+  }
+
+ public:
+  explicit task_group(thread_pool& pool_) : pool(pool_) {}
+  ~task_group() { help_until_done(); }
+
+  task_group(const task_group&) = delete;
+  task_group& operator=(const task_group&) = delete;
+
+  template <typename F>
+  void run(F&& f) {
+    pending.fetch_add(1, std::memory_order_relaxed);
+    pool.post([this, f = std::forward<F>(f)]() mutable {
+      try {
+        f();
+      } catch (...) {
+        std::lock_guard<std::mutex> lk(error_mut);
+        if (!error) error = std::current_exception();
+      }
+      // 最后一步：减到 0 之后等待方可能立刻销毁本对象
+      pending.fetch_sub(1, std::memory_order_release);
+    });
+  }
+
+  void wait() {
+    help_until_done();
+    std::exception_ptr e;
+    {
+      std::lock_guard<std::mutex> lk(error_mut);
+      e = std::exchange(error, nullptr);
+    }
+    if (e) std::rethrow_exception(e);
+  }
+};
@@ -0,0 +1,183 @@
+/**
+ * @file atomic_shared_ptr.hpp
+ * @brief 无锁的原子共享指针：分离引用计数（外部计数 + 内部计数），C++17 可用
+ * 示例见 05_memory_model_and_atomics/05_atomic_shared_ptr.cpp
+ *
+ * libstdc++ 的 std::atomic<std::shared_ptr<T>>（以及 C++11 的 std::atomic_load(&sp)）
+ * 内部用锁实现。这里换成分离引用计数：
+ * - counted_ptr<T> 相当于 shared_ptr：控制块与对象一起分配（make_counted），
+ *   控制块里的 count 是内部计数；
+ * - atomic_shared_ptr<T> 只有一个 64 位原子字：低 48 位是控制块指针，高 16 位是外部计数。
+ *   load 先对整个字 fetch_add 一个外部计数“借用”当前对象（此时存进去的那份引用保证它活着），
+ *   再给内部计数加一得到自己的引用，最后把借用的外部计数还回去；
+ * - store / exchange / CAS 换下旧指针时把它剩余的外部计数并入内部计数。还借用时指针已经
+ *   换掉了，就改为从内部计数里减一，两笔账最终相抵；
+ * - 用指针高位而不是 16 字节 CAS：std::atomic 的 16 字节 CAS 在 GCC 上要走 libatomic，
+ *   并不保证无锁。前提是用户态地址只用到低 48 位（x86-64、AArch64 的常见配置），
+ *   同一时刻正在 load 的线程不超过 65535 个；
+ * - memory_order 参数只为与 std::atomic 的接口一致：借用、换下都是读-改-写，
+ *   一律按 seq_cst 执行（x86 上 RMW 本来就是全屏障），满足调用方要求的任何次序。
+ */
+
+#pragma once
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <utility>
+
+template <typename T>
+class atomic_shared_ptr;
+
+template <typename T>
+class counted_ptr {
+  struct control_block {
+    std::atomic<long> count{1};
+    T value;
+
+    template <typename... Args>
+    explicit control_block(Args&&... args) : value(std::forward<Args>(args)...) {}
+  };
+
+  control_block* cb = nullptr;
+
+  explicit counted_ptr(control_block* adopt) : cb(adopt) {}  // 接管一份已计入的引用
+
+  static void add_ref(control_block* c, long n) { c->count.fetch_add(n, std::memory_order_relaxed); }
+
+  static void release(control_block* c, long n = 1) {
+    if (c->count.fetch_sub(n, std::memory_order_acq_rel) == n) delete c;
+  }
+
+  template <typename U, typename... Args>
+  friend counted_ptr<U> make_counted(Args&&... args);
+  friend class atomic_shared_ptr<T>;
+
+ public:
+  counted_ptr() = default;
+  counted_ptr(std::nullptr_t) {}
+  ~counted_ptr() {
+    if (cb) release(cb);
+  }
+
+  counted_ptr(const counted_ptr& other) : cb(other.cb) {
+    if (cb) add_ref(cb, 1);
+  }
+  counted_ptr(counted_ptr&& other) noexcept : cb(std::exchange(other.cb, nullptr)) {}
+  counted_ptr& operator=(counted_ptr other) noexcept {
+    std::swap(cb, other.cb);
+    return *this;
+  }
+
+  void reset() { counted_ptr().swap(*this); }
+  void swap(counted_ptr& other) noexcept { std::swap(cb, other.cb); }
+
+  T* get() const { return cb ? &cb->value : nullptr; }
+  T& operator*() const { return cb->value; }
+  T* operator->() const { return &cb->value; }
+  explicit operator bool() const { return cb != nullptr; }
+  long use_count() const { return cb ? cb->count.load(std::memory_order_relaxed) : 0; }
+
+  friend bool operator==(const counted_ptr& a, const counted_ptr& b) { return a.cb == b.cb; }
+  friend bool operator!=(const counted_ptr& a, const counted_ptr& b) { return a.cb != b.cb; }
+};
+
+template <typename T, typename... Args>
+counted_ptr<T> make_counted(Args&&... args) {
+  using control_block = typename counted_ptr<T>::control_block;
+  return counted_ptr<T>(new control_block(std::forward<Args>(args)...));
+}
+
+template <typename T>
+class atomic_shared_ptr {
+  static_assert(sizeof(void*) == 8, "pointer tagging needs 64-bit pointers");
+
+  using pointer = counted_ptr<T>;
+  using control_block = typename pointer::control_block;
+
+  static constexpr int PTR_BITS = 48;
+  static constexpr std::uint64_t PTR_MASK = (std::uint64_t{1} << PTR_BITS) - 1;
+  static constexpr std::uint64_t ONE_EXTERNAL = std::uint64_t{1} << PTR_BITS;
+
+  mutable std::atomic<std::uint64_t> word{0};  // load 也要改外部计数
+
+  static std::uint64_t pack(control_block* cb) {
+    const auto bits = reinterpret_cast<std::uintptr_t>(cb);
+    assert((bits & ~PTR_MASK) == 0 && "address does not fit in 48 bits");
+    return bits;
+  }
+  static control_block* ptr_of(std::uint64_t w) {
+    return reinterpret_cast<control_block*>(static_cast<std::uintptr_t>(w & PTR_MASK));
+  }
+  static long external_of(std::uint64_t w) { return static_cast<long>(w >> PTR_BITS); }
+
+  // 换下旧值：剩余的外部计数并入内部计数，存进去的那份引用交给返回值
+  static pointer adopt_old(std::uint64_t old) {
+    control_block* cb = ptr_of(old);
+    if (cb && external_of(old)) pointer::add_ref(cb, external_of(old));
+    return pointer(cb);
+  }
+
+ public:
+  atomic_shared_ptr() = default;
+  explicit atomic_shared_ptr(pointer desired) : word(pack(std::exchange(desired.cb, nullptr))) {}
+  ~atomic_shared_ptr() { adopt_old(word.load(std::memory_order_acquire)); }  // 不得有并发操作
+
+  atomic_shared_ptr(const atomic_shared_ptr&) = delete;
+  atomic_shared_ptr& operator=(const atomic_shared_ptr&) = delete;
+
+  bool is_lock_free() const { return word.is_lock_free(); }
+
+  pointer load(std::memory_order = std::memory_order_seq_cst) const {
+    if (!ptr_of(word.load(std::memory_order_acquire))) return pointer();
+    // 借用：外部计数加一，此后换下这个指针的线程会替我们把这一笔记入内部计数
+    const std::uint64_t borrowed = word.fetch_add(ONE_EXTERNAL) + ONE_EXTERNAL;
+    control_block* cb = ptr_of(borrowed);
+    if (cb) pointer::add_ref(cb, 1);
+
+    // 还借用：指针没变就把外部计数减回去，否则这一笔已并入内部计数，从内部计数里减
+    std::uint64_t cur = borrowed;
+    while (ptr_of(cur) == cb && external_of(cur) > 0) {
+      if (word.compare_exchange_weak(cur, cur - ONE_EXTERNAL, std::memory_order_relaxed))
+        return pointer(cb);
+    }
+    if (cb) cb->count.fetch_sub(1, std::memory_order_relaxed);  // 不会归零：我们自己刚加过一份
+    return pointer(cb);
+  }
+
+  void store(pointer desired, std::memory_order = std::memory_order_seq_cst) {
+    exchange(std::move(desired));
+  }
+
+  pointer exchange(pointer desired, std::memory_order = std::memory_order_seq_cst) {
+    return adopt_old(word.exchange(pack(std::exchange(desired.cb, nullptr))));
+  }
+
+  // 失败时 expected 更新为当前值。失败只在当前值确实不等于 expected 时发生：
+  // 取当前值的 load() 若恰好读到又换回来的 expected，就重新尝试交换
+  bool compare_exchange_strong(pointer& expected, pointer desired,
+                               std::memory_order = std::memory_order_seq_cst) {
+    for (;;) {
+      std::uint64_t cur = word.load(std::memory_order_relaxed);
+      while (ptr_of(cur) == expected.cb) {
+        // 外部计数变了只说明有人在 load，指针相同就继续尝试
+        if (word.compare_exchange_weak(cur, pack(desired.cb), std::memory_order_seq_cst,
+                                       std::memory_order_relaxed)) {
+          desired.cb = nullptr;  // 引用转交给原子字
+          adopt_old(cur);        // 原子字持有的旧引用随之释放（expected 仍持有一份）
+          return true;
+        }
+      }
+      pointer current = load();
+      if (current != expected) {
+        expected = std::move(current);
+        return false;
+      }
+    }
+  }
+
+  pointer operator=(pointer desired) {
+    store(desired);
+    return desired;
+  }
+  operator pointer() const { return load(); }
+};
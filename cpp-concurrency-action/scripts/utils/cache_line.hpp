@@ -0,0 +1,13 @@
+/**
+ * @file cache_line.hpp
+ * @brief 缓存行大小常量（避免伪共享时用于 alignas）
+ *
+ * 头文件里直接用 std::hardware_destructive_interference_size 会因其值随编译选项
+ * 变化（ABI 不稳定）触发 GCC -Winterference-size 警告，这里固定为 64 字节，
+ * 与 x86-64 及多数 ARM 处理器一致。
+ */
+
+#pragma once
+#include <cstddef>
+
+constexpr std::size_t CACHE_LINE_SIZE = 64;
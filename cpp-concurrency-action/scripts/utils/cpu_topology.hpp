@@ -0,0 +1,195 @@
+/**
+ * @file cpu_topology.hpp
+ * @brief CPU 拓扑（/sys/devices/system/cpu）与线程亲和性
+ *
+ * 逻辑 CPU → 物理核（core_id）→ 插槽（physical_package_id）。同一物理核上的多个逻辑 CPU
+ * 是超线程兄弟（SMT siblings），共享 L1/L2；同一插槽共享 L3；跨插槽要走片间互联。
+ * - compact(n) : 紧凑放置，先占满一个物理核的兄弟，再同插槽的下一个核，最后换插槽（共享缓存多）
+ * - spread(n)  : 分散放置，轮流用不同插槽、不同物理核，物理核用完才用超线程兄弟（独占资源多）
+ * 只考虑当前进程 affinity 允许的 CPU（容器/taskset 限制下依然正确）；读不到 sysfs 时
+ * 退化为“每个逻辑 CPU 是一个独立物理核、都在 0 号插槽”。
+ */
+
+#pragma once
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+struct cpu_info {
+  int cpu;      // 逻辑 CPU 编号
+  int core;     // 物理核编号（插槽内）
+  int package;  // 插槽编号
+};
+
+class cpu_topology {
+ public:
+  static cpu_topology detect() {
+    cpu_topology topo;
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    const bool have_mask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+
+    std::vector<int> online = parse_cpu_list(read_line("/sys/devices/system/cpu/online"));
+    if (online.empty()) {
+      for (unsigned i = 0; i < std::max(1u, std::thread::hardware_concurrency()); ++i)
+        online.push_back(static_cast<int>(i));
+    }
+    for (int cpu : online) {
+      if (have_mask && !CPU_ISSET(cpu, &allowed)) continue;
+      const std::string dir =
+          "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/";
+      int core = read_int(dir + "core_id", cpu);
+      int package = read_int(dir + "physical_package_id", 0);
+      topo.list.push_back({cpu, core, package});
+    }
+    return topo;
+  }
+
+  const std::vector<cpu_info>& cpus() const { return list; }
+
+  int packages() const { return static_cast<int>(group_by_core().size()); }
+
+  int physical_cores() const {
+    int n = 0;
+    for (auto& pkg : group_by_core()) n += static_cast<int>(pkg.second.size());
+    return n;
+  }
+
+  // 与 cpu 同一物理核的其他逻辑 CPU
+  std::vector<int> smt_siblings(int cpu) const {
+    const cpu_info* self = find(cpu);
+    std::vector<int> out;
+    if (!self) return out;
+    for (auto& c : list)
+      if (c.cpu != cpu && c.package == self->package && c.core == self->core)
+        out.push_back(c.cpu);
+    return out;
+  }
+
+  // 同插槽、不同物理核的逻辑 CPU
+  std::vector<int> same_package_other_cores(int cpu) const {
+    const cpu_info* self = find(cpu);
+    std::vector<int> out;
+    if (!self) return out;
+    for (auto& c : list)
+      if (c.package == self->package && c.core != self->core) out.push_back(c.cpu);
+    return out;
+  }
+
+  std::vector<int> other_packages(int cpu) const {
+    const cpu_info* self = find(cpu);
+    std::vector<int> out;
+    if (!self) return out;
+    for (auto& c : list)
+      if (c.package != self->package) out.push_back(c.cpu);
+    return out;
+  }
+
+  // n 超过逻辑 CPU 数时循环复用
+  std::vector<int> compact(std::size_t n) const {
+    std::vector<int> order;
+    for (auto& pkg : group_by_core())
+      for (auto& core : pkg.second)
+        for (int cpu : core.second) order.push_back(cpu);
+    return take(order, n);
+  }
+
+  std::vector<int> spread(std::size_t n) const {
+    // 第 k 轮取每个物理核的第 k 个超线程；每轮内部在插槽之间轮转
+    auto groups = group_by_core();
+    std::vector<std::vector<std::vector<int>>> per_package;  // [插槽][核][超线程]
+    for (auto& pkg : groups) {
+      per_package.emplace_back();
+      for (auto& core : pkg.second) per_package.back().push_back(core.second);
+    }
+    std::vector<int> order;
+    for (std::size_t smt = 0;; ++smt) {
+      bool any = false;
+      std::size_t max_cores = 0;
+      for (auto& p : per_package) max_cores = std::max(max_cores, p.size());
+      for (std::size_t core = 0; core < max_cores; ++core) {
+        for (auto& p : per_package) {
+          if (core < p.size() && smt < p[core].size()) {
+            order.push_back(p[core][smt]);
+            any = true;
+          }
+        }
+      }
+      if (!any) break;
+    }
+    return take(order, n);
+  }
+
+ private:
+  std::vector<cpu_info> list;
+
+  const cpu_info* find(int cpu) const {
+    for (auto& c : list)
+      if (c.cpu == cpu) return &c;
+    return nullptr;
+  }
+
+  // 插槽 → 物理核 → 逻辑 CPU 列表（均按编号有序）
+  std::map<int, std::map<int, std::vector<int>>> group_by_core() const {
+    std::map<int, std::map<int, std::vector<int>>> groups;
+    for (auto& c : list) groups[c.package][c.core].push_back(c.cpu);
+    return groups;
+  }
+
+  static std::vector<int> take(const std::vector<int>& order, std::size_t n) {
+    std::vector<int> out;
+    for (std::size_t i = 0; i < n && !order.empty(); ++i)
+      out.push_back(order[i % order.size()]);
+    return out;
+  }
+
+  static std::string read_line(const std::string& path) {
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line);
+    return line;
+  }
+
+  static int read_int(const std::string& path, int fallback) {
+    std::ifstream in(path);
+    int v;
+    return in >> v ? v : fallback;
+  }
+
+  // "0-3,5,7-8" → {0,1,2,3,5,7,8}
+  static std::vector<int> parse_cpu_list(const std::string& s) {
+    std::vector<int> out;
+    std::stringstream ss(s);
+    std::string part;
+    while (std::getline(ss, part, ',')) {
+      if (part.empty()) continue;
+      auto dash = part.find('-');
+      int lo = std::stoi(part.substr(0, dash));
+      int hi = dash == std::string::npos ? lo : std::stoi(part.substr(dash + 1));
+      for (int c = lo; c <= hi; ++c) out.push_back(c);
+    }
+    return out;
+  }
+};
+
+// 把调用线程绑定到 cpus 中的任意一个；cpus 为空时不做限制
+inline bool pin_current_thread(const std::vector<int>& cpus) {
+  if (cpus.empty()) return true;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int c : cpus) CPU_SET(c, &set);
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+// 线程名会显示在 top -H、perf、gdb 中；Linux 限制为 15 个字符
+inline void set_current_thread_name(const std::string& name) {
+  pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+}
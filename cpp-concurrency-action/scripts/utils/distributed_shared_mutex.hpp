@@ -0,0 +1,162 @@
+/**
+ * @file distributed_shared_mutex.hpp
+ * @brief 分布式读写锁（big-reader lock）：读者计数按线程分散到各自的缓存行
+ *
+ * std::shared_mutex::lock_shared 要原子修改同一个读者计数，所有读者抢同一条缓存行，
+ * 核数一多读锁本身就成了瓶颈。这里每个线程固定映射到一个读者槽（各占一条缓存行，
+ * 槽数 >= 逻辑 CPU 数时互不共享），读者加锁只写自己的槽、只读写者标志：
+ *   读者：slot += 1；若 writer 为真则退回并等待，否则进入
+ *   写者：writer = true；等所有槽归零
+ * 两边都是“先写自己的、再读对方的”（seq_cst），构成 Dekker 式握手，至少一方能看到另一方。
+ * 写者代价随槽数线性增长（要扫描所有槽），适合读远多于写的场景。
+ *
+ * 公平性：写者之间用 mutex 排队；写者持有期间被挡下的读者登记在 blocked_readers，
+ * 下一个写者要等这批读者全部进场后才竖起标志，读阶段与写阶段交替，双方都不会被饿死。
+ * 等待先自旋 default_spin_limit() 次，再睡在 event_count 上。
+ * 满足 SharedMutex 要求，可直接用于 std::shared_lock / std::unique_lock / std::lock_guard。
+ */
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "cache_line.hpp"
+#include "event_count.hpp"
+#include "spin_wait.hpp"
+
+class distributed_shared_mutex {
+ public:
+  // 槽数取不小于逻辑 CPU 数的 2 的幂，上限 128
+  static std::size_t default_slots() {
+    std::size_t n = 1;
+    while (n < std::min<std::size_t>(std::thread::hardware_concurrency(), 128)) n <<= 1;
+    return n;
+  }
+
+  explicit distributed_shared_mutex(std::size_t slot_count = default_slots()) {
+    std::size_t n = 1;
+    while (n < slot_count) n <<= 1;
+    mask = n - 1;
+    slots = std::make_unique<reader_slot[]>(n);
+  }
+
+  distributed_shared_mutex(const distributed_shared_mutex&) = delete;
+  distributed_shared_mutex& operator=(const distributed_shared_mutex&) = delete;
+
+  void lock_shared() {
+    reader_slot& s = my_slot();
+    s.count.fetch_add(1, std::memory_order_seq_cst);
+    if (!writer.load(std::memory_order_seq_cst)) return;  // 快路径：只碰自己的缓存行
+    lock_shared_slow(s);
+  }
+
+  bool try_lock_shared() {
+    reader_slot& s = my_slot();
+    s.count.fetch_add(1, std::memory_order_seq_cst);
+    if (!writer.load(std::memory_order_seq_cst)) return true;
+    leave(s);
+    return false;
+  }
+
+  void unlock_shared() { leave(my_slot()); }
+
+  void lock() {
+    writer_mutex.lock();
+    // 先放上一个写阶段被挡下的读者进场
+    wait_until(readers_admitted,
+               [this] { return blocked_readers.load(std::memory_order_seq_cst) == 0; });
+    writer.store(true, std::memory_order_seq_cst);
+    wait_until(readers_drained, [this] { return no_readers(); });
+  }
+
+  bool try_lock() {
+    if (!writer_mutex.try_lock()) return false;
+    if (blocked_readers.load(std::memory_order_seq_cst) == 0) {
+      writer.store(true, std::memory_order_seq_cst);
+      if (no_readers()) return true;
+      writer.store(false, std::memory_order_seq_cst);
+      writer_done.notify_all();
+    }
+    writer_mutex.unlock();
+    return false;
+  }
+
+  void unlock() {
+    writer.store(false, std::memory_order_seq_cst);
+    writer_done.notify_all();
+    writer_mutex.unlock();
+  }
+
+  std::size_t slot_count() const { return mask + 1; }
+
+ private:
+  struct alignas(CACHE_LINE_SIZE) reader_slot {
+    std::atomic<std::uint32_t> count{0};
+  };
+
+  std::unique_ptr<reader_slot[]> slots;
+  std::size_t mask = 0;
+
+  // 读者只读不写（写者持锁时除外），与读者槽分开放
+  alignas(CACHE_LINE_SIZE) std::atomic<bool> writer{false};
+  std::atomic<std::uint32_t> blocked_readers{0};
+  std::mutex writer_mutex;
+  event_count writer_done;       // 读者等写者离开
+  event_count readers_drained;   // 写者等读者槽归零
+  event_count readers_admitted;  // 下一个写者等被挡下的读者进场
+
+  // 线程第一次加读锁时按轮转分配编号，之后固定；unlock_shared 依赖它找回同一个槽
+  static std::size_t thread_index() {
+    static std::atomic<std::size_t> next{0};
+    thread_local const std::size_t index = next.fetch_add(1, std::memory_order_relaxed);
+    return index;
+  }
+
+  reader_slot& my_slot() const { return slots[thread_index() & mask]; }
+
+  bool no_readers() const {
+    for (std::size_t i = 0; i <= mask; ++i)
+      if (slots[i].count.load(std::memory_order_seq_cst) != 0) return false;
+    return true;
+  }
+
+  void leave(reader_slot& s) {
+    s.count.fetch_sub(1, std::memory_order_seq_cst);
+    if (writer.load(std::memory_order_seq_cst)) readers_drained.notify();
+  }
+
+  void lock_shared_slow(reader_slot& s) {
+    blocked_readers.fetch_add(1, std::memory_order_seq_cst);  // 先登记，再让出槽位
+    leave(s);
+    for (;;) {
+      wait_until(writer_done, [this] { return !writer.load(std::memory_order_seq_cst); });
+      s.count.fetch_add(1, std::memory_order_seq_cst);
+      if (!writer.load(std::memory_order_seq_cst)) break;
+      // 下一个写者要等 blocked_readers 归零才竖旗，本线程仍计在其中，正常不会走到这里
+      leave(s);
+    }
+    if (blocked_readers.fetch_sub(1, std::memory_order_seq_cst) == 1)
+      readers_admitted.notify_all();
+  }
+
+  template <typename Pred>
+  static void wait_until(event_count& ec, Pred ready) {
+    for (int i = 0, limit = default_spin_limit(); i < limit; ++i) {
+      if (ready()) return;
+      cpu_relax();
+    }
+    while (!ready()) {
+      auto key = ec.prepare_wait();
+      if (ready()) {
+        ec.cancel_wait();
+        return;
+      }
+      ec.commit_wait(key);
+    }
+  }
+};
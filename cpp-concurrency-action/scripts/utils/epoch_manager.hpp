@@ -0,0 +1,112 @@
+/**
+ * @file epoch_manager.hpp
+ * @brief 基于纪元的内存回收（EBR）
+ * 示例见 07_lock_free_concurrent_data_structures/05_epoch_based_reclamation.cpp
+ *
+ * 读者用 enter()/exit() 包住对共享节点的访问；写者摘下节点后 retire()，节点进入
+ * 当前纪元的回收袋。所有活跃线程都追上全局纪元后纪元前进，两个纪元之前的袋子
+ * 里不可能还有读者引用，可以安全释放。
+ */
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <vector>
+
+#include "trace.hpp"
+
+const size_t EPOCH_COUNT = 3;
+const size_t NULL_EPOCH = 999;
+
+struct RetiredNode {
+  void* ptr;
+  void (*deleter)(void*);  // 函数指针而非 std::function：退休一个节点不再额外分配内存
+};
+
+struct ThreadControlBlock {
+  std::atomic<size_t> local_epoch{NULL_EPOCH};
+  std::atomic<bool> active{false};
+  std::vector<RetiredNode> retire_bags[EPOCH_COUNT];
+};
+
+class EpochManager {
+  std::atomic<size_t> global_epoch_{0};
+  std::atomic<size_t> reclaimed_{0};
+  std::list<ThreadControlBlock*> threads_;
+  std::mutex threads_mutex_;
+  static inline thread_local ThreadControlBlock* local_tcb_ = nullptr;
+
+ public:
+  void registerThread() {
+    if (local_tcb_) return;
+    std::lock_guard<std::mutex> lock(threads_mutex_);
+    local_tcb_ = new ThreadControlBlock();
+    local_tcb_->active = true;
+    threads_.push_back(local_tcb_);
+  }
+
+  void enter() {
+    if (!local_tcb_) registerThread();
+    size_t g = global_epoch_.load(std::memory_order_relaxed);
+    local_tcb_->local_epoch.store(g, std::memory_order_seq_cst);
+  }
+
+  void exit() {
+    local_tcb_->local_epoch.store(NULL_EPOCH, std::memory_order_release);
+  }
+
+  template <typename T>
+  void retire(T* ptr) {
+    retire(ptr, [](void* p) { delete static_cast<T*>(p); });
+  }
+
+  // 自定义释放函数，例如把节点还给分配器（对象池）
+  void retire(void* ptr, void (*deleter)(void*)) {
+    size_t current_epoch = global_epoch_.load(std::memory_order_relaxed);
+    local_tcb_->retire_bags[current_epoch % EPOCH_COUNT].push_back({ptr, deleter});
+    try_advance_epoch();
+  }
+
+  // 【新增】调试接口
+  size_t getSelfEpoch() const {
+    if (local_tcb_)
+      return local_tcb_->local_epoch.load(std::memory_order_relaxed);
+    return NULL_EPOCH;
+  }
+
+  size_t getGlobalEpoch() const {
+    return global_epoch_.load(std::memory_order_relaxed);
+  }
+
+  // 累计释放的节点数
+  size_t reclaimed() const { return reclaimed_.load(std::memory_order_relaxed); }
+
+ private:
+  void try_advance_epoch() {
+    size_t current_g = global_epoch_.load(std::memory_order_acquire);
+    std::lock_guard<std::mutex> lock(threads_mutex_);
+
+    for (auto* tcb : threads_) {
+      size_t local = tcb->local_epoch.load(std::memory_order_acquire);
+      if (local != NULL_EPOCH && local != current_g) return;
+    }
+
+    size_t new_g = (current_g + 1);
+    global_epoch_.store(new_g, std::memory_order_release);
+    TRACE_INSTANT("ebr.advance", new_g);
+    clean_local_bag((new_g + 1) % EPOCH_COUNT);
+  }
+
+  // 持有 threads_mutex_ 时调用：这里不做 I/O，只记录追踪事件
+  void clean_local_bag(size_t index) {
+    auto& bag = local_tcb_->retire_bags[index];
+    if (!bag.empty()) {
+      TRACE_INSTANT("ebr.reclaim", bag.size());
+      for (auto& node : bag) node.deleter(node.ptr);
+      reclaimed_.fetch_add(bag.size(), std::memory_order_relaxed);
+      bag.clear();
+    }
+  }
+};
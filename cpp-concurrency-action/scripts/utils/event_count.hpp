@@ -0,0 +1,132 @@
+/**
+ * @file event_count.hpp
+ * @brief 事件计数器（eventcount）：给无锁数据结构加上“阻塞等待”而不改动其算法
+ *
+ * 消费者：
+ *   auto key = ec.prepare_wait();       // 1. 登记为等待者，记下当前代数
+ *   if (再检查一次条件成立) ec.cancel_wait();
+ *   else ec.commit_wait(key);           // 2. 代数没变才真正睡眠
+ * 生产者：修改数据后调用 ec.notify()。没有人睡眠时只有一次 fence + relaxed load，
+ * 不进入内核（fence 不能省：它与 prepare_wait 的 RMW 构成 Dekker 式握手，
+ * 保证“生产者看到等待者”与“等待者看到数据”至少有一个成立）。
+ *
+ * 状态字（64 位）：高 32 位是代数（epoch），低 32 位是等待者数量；
+ * 睡眠直接 futex 在代数所在的 32 位上（非 Linux 平台退化为 mutex + 条件变量）。
+ * 用 event_count(true) 构造在共享内存里，可以跨进程等待 / 通知（仅限有 futex 的平台）。
+ */
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "futex.hpp"
+#include "trace.hpp"
+
+#ifndef HAS_FUTEX
+#include <condition_variable>
+#include <mutex>
+#endif
+
+class event_count {
+ public:
+  struct key {
+    std::uint32_t epoch;
+  };
+
+  event_count() = default;
+  explicit event_count(bool process_shared) : shared(process_shared) {}
+  event_count(const event_count&) = delete;
+  event_count& operator=(const event_count&) = delete;
+
+  key prepare_wait() {
+    std::uint64_t prev = val.fetch_add(1, std::memory_order_seq_cst);
+    return {static_cast<std::uint32_t>(prev >> EPOCH_SHIFT)};
+  }
+
+  void cancel_wait() { val.fetch_sub(1, std::memory_order_seq_cst); }
+
+  void commit_wait(key k) {
+    TRACE_SCOPE("event_count.wait");
+#ifdef HAS_FUTEX
+    while (epoch() == k.epoch) futex_wait(epoch_word(), k.epoch, shared);
+#else
+    {
+      std::unique_lock<std::mutex> lk(m);
+      cv.wait(lk, [&] { return epoch() != k.epoch; });
+    }
+#endif
+    val.fetch_sub(1, std::memory_order_seq_cst);
+  }
+
+  // 限时版本：到 deadline 代数仍未变化则返回 false（同样会注销等待者）
+  template <typename Clock, typename Duration>
+  bool commit_wait_until(key k,
+                         const std::chrono::time_point<Clock, Duration>& deadline) {
+    TRACE_SCOPE("event_count.wait");
+    bool woken = true;
+#ifdef HAS_FUTEX
+    while (epoch() == k.epoch) {
+      auto left = deadline - Clock::now();
+      if (left <= decltype(left)::zero()) {
+        woken = false;
+        break;
+      }
+      auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(left).count();
+      timespec ts{static_cast<time_t>(ns / 1000000000), static_cast<long>(ns % 1000000000)};
+      futex_wait(epoch_word(), k.epoch, shared, &ts);  // futex 的超时是相对时间
+    }
+#else
+    {
+      std::unique_lock<std::mutex> lk(m);
+      woken = cv.wait_until(lk, deadline, [&] { return epoch() != k.epoch; });
+    }
+#endif
+    val.fetch_sub(1, std::memory_order_seq_cst);
+    return woken;
+  }
+
+  void notify() { notify_impl(1); }
+  void notify_all() { notify_impl(INT32_MAX); }
+
+ private:
+  static constexpr int EPOCH_SHIFT = 32;
+  static constexpr std::uint64_t WAITER_MASK = 0xffffffffu;
+  static constexpr std::uint64_t EPOCH_INC = std::uint64_t(1) << EPOCH_SHIFT;
+
+  std::atomic<std::uint64_t> val{0};
+  bool shared = false;  // futex 是否用跨进程版本
+#ifndef HAS_FUTEX
+  std::mutex m;
+  std::condition_variable cv;
+#endif
+
+  std::uint32_t epoch() const {
+    return static_cast<std::uint32_t>(val.load(std::memory_order_acquire) >>
+                                      EPOCH_SHIFT);
+  }
+
+#ifdef HAS_FUTEX
+  // 代数所在的 32 位字（x86/ARM 小端序下是高地址的那一半）
+  std::atomic<std::uint32_t>* epoch_word() {
+    static_assert(sizeof(std::atomic<std::uint64_t>) == 8, "unexpected layout");
+    return reinterpret_cast<std::atomic<std::uint32_t>*>(&val) +
+           (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ ? 1 : 0);
+  }
+#endif
+
+  void notify_impl(int n) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if ((val.load(std::memory_order_relaxed) & WAITER_MASK) == 0) return;  // 快路径
+    val.fetch_add(EPOCH_INC, std::memory_order_seq_cst);
+#ifdef HAS_FUTEX
+    futex_wake(epoch_word(), n, shared);
+#else
+    { std::lock_guard<std::mutex> lk(m); }
+    if (n == 1)
+      cv.notify_one();
+    else
+      cv.notify_all();
+#endif
+  }
+};
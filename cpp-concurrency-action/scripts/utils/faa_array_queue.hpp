@@ -0,0 +1,170 @@
+/**
+ * @file faa_array_queue.hpp
+ * @brief 基于 fetch_add 的分段无锁队列（FAA array queue，多生产者-多消费者）
+ * 示例见 07_lock_free_concurrent_data_structures/13_faa_array_queue.cpp
+ *
+ * - 队列由定长数组段串成链表。入队、出队各自对段内的 enqidx / deqidx 做一次 fetch_add
+ *   领取槽位，fetch_add 总会成功，不会像 LockFreeQueue 那样在同一个 tail->next 上
+ *   反复 CAS 失败重试；只有段写满时才分配新段、CAS 接到链表尾部；
+ * - 元素直接构造在槽里，每 SegmentSize 个元素才分配一次内存；
+ * - 槽状态 EMPTY -> FULL（入队者）或 EMPTY -> TAKEN（出队者先到，槽作废）。出队者领到的
+ *   槽还没写入时直接作废它、换下一个槽，入队者发现自己的槽被作废就带着元素重试，
+ *   任何一方都不用等另一方；
+ * - 读完的段由出队者摘下，交给回收策略 Reclaimer（reclaimer.hpp）延迟释放，默认用风险指针：
+ *   入队保护 tail 段，出队保护 head 段，各用一个风险指针。
+ */
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <optional>
+#include <utility>
+
+#include "cache_line.hpp"
+#include "event_count.hpp"
+#include "reclaimer.hpp"
+#include "trace.hpp"
+
+template <typename T, std::size_t SegmentSize = 1024, typename Reclaimer = hp_reclaimer>
+class faa_array_queue {
+  static_assert(SegmentSize > 1, "segment must hold more than one element");
+
+  enum : unsigned char { EMPTY, FULL, TAKEN };
+
+  struct slot {
+    std::atomic<unsigned char> state{EMPTY};
+    alignas(T) unsigned char storage[sizeof(T)];
+
+    T* value() { return std::launder(reinterpret_cast<T*>(storage)); }
+  };
+
+  struct segment {
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> deqidx{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> enqidx{0};
+    std::atomic<segment*> next{nullptr};
+    alignas(CACHE_LINE_SIZE) slot slots[SegmentSize];
+  };
+
+  alignas(CACHE_LINE_SIZE) std::atomic<segment*> head;
+  alignas(CACHE_LINE_SIZE) std::atomic<segment*> tail;
+  alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> allocated{1};
+  event_count not_empty;
+  Reclaimer reclaimer;
+
+  static void destroy_segment(void* p) { delete static_cast<segment*>(p); }
+
+  // 当前段已写满：接上一个以 value 开头的新段，成功返回 true；别人先接上了就帮忙推进 tail
+  bool append_segment(segment* last, T& value) {
+    segment* next = last->next.load(std::memory_order_acquire);
+    if (next) {
+      tail.compare_exchange_strong(last, next);
+      return false;
+    }
+    segment* s = new segment;
+    ::new (s->slots[0].value()) T(std::move(value));
+    s->slots[0].state.store(FULL, std::memory_order_relaxed);
+    s->enqidx.store(1, std::memory_order_relaxed);
+    if (last->next.compare_exchange_strong(next, s)) {
+      allocated.fetch_add(1, std::memory_order_relaxed);
+      tail.compare_exchange_strong(last, s);
+      return true;
+    }
+    value = std::move(*s->slots[0].value());  // 没接上：取回元素，丢掉新段
+    s->slots[0].value()->~T();
+    delete s;
+    return false;
+  }
+
+ public:
+  faa_array_queue() {
+    segment* s = new segment;
+    head.store(s, std::memory_order_relaxed);
+    tail.store(s, std::memory_order_relaxed);
+  }
+
+  // 析构时不得有并发操作
+  ~faa_array_queue() {
+    while (dequeue()) {
+    }
+    delete head.load(std::memory_order_relaxed);
+  }
+
+  faa_array_queue(const faa_array_queue&) = delete;
+  faa_array_queue& operator=(const faa_array_queue&) = delete;
+
+  void enqueue(T value) {
+    TRACE_SCOPE("faa.enqueue");
+    typename Reclaimer::guard g(reclaimer);
+    for (;;) {
+      segment* s = reclaimer.protect(0, tail);
+      const std::size_t idx = s->enqidx.fetch_add(1, std::memory_order_relaxed);
+      if (idx >= SegmentSize) {
+        if (s != tail.load(std::memory_order_acquire)) continue;
+        if (append_segment(s, value)) break;
+        continue;
+      }
+      slot& sl = s->slots[idx];
+      ::new (sl.value()) T(std::move(value));
+      unsigned char expected = EMPTY;
+      if (sl.state.compare_exchange_strong(expected, FULL, std::memory_order_release,
+                                           std::memory_order_relaxed))
+        break;
+      value = std::move(*sl.value());  // 出队者已作废这个槽：带着元素换一个
+      sl.value()->~T();
+    }
+    reclaimer.release(0);
+    not_empty.notify();
+  }
+
+  std::optional<T> dequeue() {
+    TRACE_SCOPE("faa.dequeue");
+    typename Reclaimer::guard g(reclaimer);
+    std::optional<T> res;
+    for (;;) {
+      segment* s = reclaimer.protect(0, head);
+      // 先判空，避免在空队列上白白消耗下标（消耗掉的下标会让入队者的槽作废）
+      if (s->deqidx.load(std::memory_order_acquire) >= s->enqidx.load(std::memory_order_acquire) &&
+          s->next.load(std::memory_order_acquire) == nullptr)
+        break;
+      const std::size_t idx = s->deqidx.fetch_add(1, std::memory_order_relaxed);
+      if (idx >= SegmentSize) {
+        // 本段已读完：摘下它，别人可能还在读它，交给风险指针延迟释放
+        segment* next = s->next.load(std::memory_order_acquire);
+        if (next == nullptr) break;
+        if (head.compare_exchange_strong(s, next)) {
+          reclaimer.release(0);
+          reclaimer.retire(s, &faa_array_queue::destroy_segment);
+        }
+        continue;
+      }
+      slot& sl = s->slots[idx];
+      if (sl.state.exchange(TAKEN, std::memory_order_acquire) == FULL) {
+        res.emplace(std::move(*sl.value()));
+        sl.value()->~T();
+        break;
+      }
+      // 入队者还没写入：槽已作废，换下一个
+    }
+    reclaimer.release(0);
+    return res;
+  }
+
+  // 阻塞式出队：队列为空时睡眠，直到有生产者入队
+  T dequeue_wait() {
+    for (;;) {
+      if (auto res = dequeue()) return std::move(*res);
+      auto key = not_empty.prepare_wait();
+      if (auto res = dequeue()) {  // 登记之后再查一次，避免唤醒丢失
+        not_empty.cancel_wait();
+        return std::move(*res);
+      }
+      reclaimer.thread_offline();  // 睡眠期间不持有节点，不拖住 QSBR 的回收
+      not_empty.commit_wait(key);
+      reclaimer.thread_online();
+    }
+  }
+
+  // 累计分配过的段数
+  std::size_t segments_allocated() const { return allocated.load(std::memory_order_relaxed); }
+};
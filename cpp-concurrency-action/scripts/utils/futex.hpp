@@ -0,0 +1,41 @@
+/**
+ * @file futex.hpp
+ * @brief Linux futex 的薄封装（C++17 下没有 atomic::wait 时的阻塞原语）
+ *
+ * futex_wait(addr, expected)：仅当 *addr == expected 时睡眠，检查与睡眠由内核原子完成，
+ *                             因此不会丢失“检查之后、睡下之前”的唤醒。
+ * futex_wake(addr, n)       ：唤醒最多 n 个睡在 addr 上的线程。
+ * process_shared = true 时可用于共享内存中的跨进程等待。
+ */
+
+#pragma once
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <ctime>
+
+#define HAS_FUTEX 1
+
+// 返回 false 表示超时
+inline bool futex_wait(const std::atomic<std::uint32_t>* addr,
+                       std::uint32_t expected, bool process_shared = false,
+                       const struct timespec* timeout = nullptr) {
+  int op = process_shared ? FUTEX_WAIT : FUTEX_WAIT_PRIVATE;
+  long r = syscall(SYS_futex, reinterpret_cast<const std::uint32_t*>(addr), op,
+                   expected, timeout, nullptr, 0);
+  return !(r == -1 && errno == ETIMEDOUT);
+}
+
+inline void futex_wake(const std::atomic<std::uint32_t>* addr,
+                       int count = INT_MAX, bool process_shared = false) {
+  int op = process_shared ? FUTEX_WAKE : FUTEX_WAKE_PRIVATE;
+  syscall(SYS_futex, reinterpret_cast<const std::uint32_t*>(addr), op, count,
+          nullptr, nullptr, 0);
+}
+#endif
@@ -0,0 +1,178 @@
+/**
+ * @file hazard_pointers.hpp
+ * @brief 风险指针（Hazard Pointers）内存回收
+ * 示例见 07_lock_free_concurrent_data_structures/04_hazard_pointers.cpp
+ *
+ * 读者访问节点前把它的地址发布到自己的风险指针槽（acquire），用完清空（release）；
+ * 写者摘下节点后 retire()，攒够一批再 scan()：收集所有线程发布的风险指针，
+ * 不在其中的已退休节点即可释放。
+ *
+ * 线程的 HPRecord 是 thread_local 的，所以记录链表也是进程级的：所有
+ * HazardPointerManager 实例共享同一组风险指针，容器可以各自持有一个实例。
+ *
+ * 线程退出时清空自己的风险指针、交还 HPRecord 供后来的线程复用，并做最后一次扫描；
+ * 仍被别的线程保护的节点挂到全局孤儿链表，由之后任意线程的 scan() 接手。
+ */
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "trace.hpp"
+
+const int HP_PER_THREAD = 2;
+
+struct HPRecord {
+  std::atomic<void*> hp[HP_PER_THREAD]{};
+  std::atomic<bool> active{false};
+  HPRecord* next = nullptr;
+};
+
+struct HPRetired {
+  void* ptr;
+  void (*deleter)(void*);
+};
+
+// 线程退出的线程留下的、当时仍受保护的退休节点
+struct HPOrphans {
+  std::vector<HPRetired> nodes;
+  HPOrphans* next = nullptr;
+};
+
+// 线程本地状态；析构（线程退出）时交还记录并处理剩余的退休节点
+struct HPThreadState {
+  HPRecord* record = nullptr;
+  std::vector<HPRetired> retired;  // 垃圾链表
+  ~HPThreadState();
+};
+
+class HazardPointerManager {
+  using Retired = HPRetired;
+
+  static inline std::atomic<HPRecord*> head_{nullptr};
+  static inline std::atomic<HPOrphans*> orphans_{nullptr};
+  static inline thread_local HPThreadState local_;
+  static constexpr std::size_t SCAN_THRESHOLD = 64;  // 攒够这么多再扫描，摊薄扫描开销
+
+  // 把孤儿节点并入本线程的垃圾链表。整条链表一次 exchange 取走，没有 ABA 问题
+  static void adoptOrphans(std::vector<Retired>& retired) {
+    if (!orphans_.load(std::memory_order_relaxed)) return;
+    HPOrphans* batch = orphans_.exchange(nullptr, std::memory_order_acquire);
+    while (batch) {
+      retired.insert(retired.end(), batch->nodes.begin(), batch->nodes.end());
+      delete std::exchange(batch, batch->next);
+    }
+  }
+
+  // 释放不在任何风险指针里的节点，仍受保护的前移保留；返回释放数
+  static std::size_t reclaim(std::vector<Retired>& retired) {
+    adoptOrphans(retired);
+    // 与 acquire() 中的栅栏配对：节点在退休前已摘下，之后读到的风险指针不会漏掉
+    // 仍在重读确认的读者
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::vector<void*> hazard_ptrs;
+    HPRecord* p = head_.load(std::memory_order_acquire);
+    while (p) {
+      if (p->active.load()) {
+        for (int i = 0; i < HP_PER_THREAD; ++i) {
+          void* ptr = p->hp[i].load(std::memory_order_acquire);
+          if (ptr) hazard_ptrs.push_back(ptr);
+        }
+      }
+      p = p->next;
+    }
+    std::sort(hazard_ptrs.begin(), hazard_ptrs.end());
+
+    std::size_t kept = 0;
+    for (const Retired& r : retired) {
+      if (std::binary_search(hazard_ptrs.begin(), hazard_ptrs.end(), r.ptr))
+        retired[kept++] = r;
+      else
+        r.deleter(r.ptr);
+    }
+    const std::size_t freed = retired.size() - kept;
+    retired.resize(kept);
+    return freed;
+  }
+
+  // 线程退出：此时其他 thread_local（包括追踪用的环）可能已析构，不记录追踪事件
+  static void threadExit(HPThreadState& state) {
+    if (HPRecord* rec = state.record) {
+      for (auto& hp : rec->hp) hp.store(nullptr, std::memory_order_release);
+      rec->active.store(false, std::memory_order_release);
+    }
+    if (state.retired.empty()) return;
+    reclaim(state.retired);
+    if (state.retired.empty()) return;
+    auto* batch = new HPOrphans{std::move(state.retired)};
+    batch->next = orphans_.load(std::memory_order_relaxed);
+    while (!orphans_.compare_exchange_weak(batch->next, batch, std::memory_order_release,
+                                           std::memory_order_relaxed)) {
+    }
+  }
+
+  friend struct HPThreadState;
+
+ public:
+  void registerThread() {
+    if (local_.record) return;
+    HPRecord* p = head_.load(std::memory_order_acquire);
+    while (p) {
+      bool expected = false;
+      if (!p->active.load() &&  // 尝试复用空闲的 HPRecord
+          p->active.compare_exchange_strong(expected, true)) {
+        local_.record = p;
+        return;
+      }
+      p = p->next;
+    }
+    HPRecord* new_rec = new HPRecord();
+    new_rec->active = true;
+    HPRecord* old_head = head_.load();
+    do {
+      new_rec->next = old_head;
+    } while (!head_.compare_exchange_weak(old_head, new_rec));
+    local_.record = new_rec;
+  }
+
+  // 发布后调用者要重新读一次源指针确认未变。发布与重读之间是 store-load，acquire 重读
+  // 可能提前到发布之前，所以这里放一道 seq_cst 栅栏；它与 reclaim() 读风险指针之前的
+  // 栅栏配对：要么回收者看到这个风险指针，要么调用者的重读看到节点已被摘下。
+  // 发布本身仍用 seq_cst：ThreadSanitizer 不建模栅栏，relaxed 会被误报
+  void acquire(int index, void* ptr) {
+    local_.record->hp[index].store(ptr, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
+
+  void release(int index) {
+    local_.record->hp[index].store(nullptr, std::memory_order_release);
+  }
+
+  template <typename T>
+  void retire(T* ptr) {
+    retire(ptr, [](void* p) { delete static_cast<T*>(p); });
+  }
+
+  // 自定义释放函数，例如把节点还给分配器（对象池）
+  void retire(void* ptr, void (*deleter)(void*)) {
+    local_.retired.push_back({ptr, deleter});
+    if (local_.retired.size() >= SCAN_THRESHOLD) scan();
+  }
+
+  // 返回本次释放的节点数（含接手的孤儿节点）
+  std::size_t scan() {
+    TRACE_SCOPE("hp.scan");
+    const std::size_t freed = reclaim(local_.retired);
+    TRACE_INSTANT("hp.reclaim", freed, static_cast<std::uint32_t>(local_.retired.size()));
+    return freed;
+  }
+
+  // 本线程尚未释放的退休节点数
+  std::size_t pending() const { return local_.retired.size(); }
+};
+
+inline HPThreadState::~HPThreadState() { HazardPointerManager::threadExit(*this); }
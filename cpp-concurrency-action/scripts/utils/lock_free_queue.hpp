@@ -0,0 +1,138 @@
+/**
+ * @file lock_free_queue.hpp
+ * @brief Michael-Scott 无锁队列（多生产者-多消费者）
+ * 示例见 07_lock_free_concurrent_data_structures/02_lock_free_queue.cpp
+ *
+ * dequeue_wait 在队列为空时通过 event_count 睡眠，而不是空转重试。
+ * 出队摘下的哑节点交给回收策略 Reclaimer（reclaimer.hpp）延迟释放，默认用风险指针：
+ * 入队保护 tail，出队保护 head 与 head->next，正好用满每线程两个风险指针。
+ * Allocator 决定节点与元素的内存来源（例如 object_pool.hpp 的 pool_allocator），
+ * 须是无状态分配器。
+ */
+
+#pragma once
+#include <atomic>
+#include <memory>
+
+#include "event_count.hpp"
+#include "reclaimer.hpp"
+#include "trace.hpp"
+
+template <typename T, typename Allocator = std::allocator<T>, typename Reclaimer = hp_reclaimer>
+class LockFreeQueue {
+ private:
+  struct Node {
+    std::shared_ptr<T> data;
+    std::atomic<Node*> next;
+    Node() : next(nullptr) {}
+    Node(T val) : data(std::allocate_shared<T>(Allocator(), std::move(val))), next(nullptr) {}
+  };
+
+  using node_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+  using node_traits = std::allocator_traits<node_allocator>;
+
+  std::atomic<Node*> head;
+  std::atomic<Node*> tail;
+  event_count not_empty;
+  Reclaimer reclaimer;
+
+  template <typename... Args>
+  static Node* make_node(Args&&... args) {
+    node_allocator alloc;
+    Node* n = node_traits::allocate(alloc, 1);
+    node_traits::construct(alloc, n, std::forward<Args>(args)...);
+    return n;
+  }
+
+  static void destroy_node(void* p) {
+    node_allocator alloc;
+    node_traits::destroy(alloc, static_cast<Node*>(p));
+    node_traits::deallocate(alloc, static_cast<Node*>(p), 1);
+  }
+
+ public:
+  LockFreeQueue() {
+    Node* dummy = make_node();
+    head.store(dummy);
+    tail.store(dummy);
+  }
+
+  // 析构时不得有并发操作
+  ~LockFreeQueue() {
+    Node* curr = head.load();
+    while (curr) {
+      Node* next = curr->next.load();
+      destroy_node(curr);
+      curr = next;
+    }
+  }
+
+  void enqueue(T value) {
+    TRACE_SCOPE("lfq.enqueue");
+    typename Reclaimer::guard g(reclaimer);
+    Node* new_node = make_node(std::move(value));
+    Node* p_tail;
+    while (true) {
+      p_tail = reclaimer.protect(0, tail);
+      Node* next = p_tail->next.load(std::memory_order_acquire);
+
+      if (p_tail == tail.load(std::memory_order_acquire)) {
+        if (next == nullptr) {
+          if (p_tail->next.compare_exchange_weak(next, new_node)) {
+            tail.compare_exchange_strong(p_tail, new_node);
+            reclaimer.release(0);
+            not_empty.notify();
+            return;
+          }
+        } else {
+          tail.compare_exchange_strong(p_tail, next);  // Helping
+        }
+      }
+    }
+  }
+
+  std::shared_ptr<T> dequeue() {
+    TRACE_SCOPE("lfq.dequeue");
+    typename Reclaimer::guard g(reclaimer);
+    Node* p_head;
+    while (true) {
+      p_head = reclaimer.protect(0, head);
+      Node* p_tail = tail.load(std::memory_order_acquire);
+      Node* next = reclaimer.protect(1, p_head->next);
+
+      if (p_head == head.load(std::memory_order_acquire)) {  // next 仍是 head 的后继
+        if (p_head == p_tail) {
+          if (next == nullptr) {
+            reclaimer.release(0);
+            reclaimer.release(1);
+            return std::shared_ptr<T>();
+          }
+          tail.compare_exchange_strong(p_tail, next);  // Helping
+        } else {
+          std::shared_ptr<T> res = next->data;
+          if (head.compare_exchange_weak(p_head, next)) {
+            reclaimer.release(0);
+            reclaimer.release(1);
+            reclaimer.retire(p_head, &LockFreeQueue::destroy_node);  // 没人再引用时才释放
+            return res;
+          }
+        }
+      }
+    }
+  }
+
+  // 阻塞式出队：队列为空时睡眠，直到有生产者入队
+  std::shared_ptr<T> dequeue_wait() {
+    for (;;) {
+      if (auto res = dequeue()) return res;
+      auto key = not_empty.prepare_wait();
+      if (auto res = dequeue()) {  // 登记之后再查一次，避免唤醒丢失
+        not_empty.cancel_wait();
+        return res;
+      }
+      reclaimer.thread_offline();  // 睡眠期间不持有节点，不拖住 QSBR 的回收
+      not_empty.commit_wait(key);
+      reclaimer.thread_online();
+    }
+  }
+};
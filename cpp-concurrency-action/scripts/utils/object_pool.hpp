@@ -0,0 +1,281 @@
+/**
+ * @file object_pool.hpp
+ * @brief 定长对象池：线程本地弹匣（magazine）+ 无锁全局仓库（depot）
+ * 示例见 07_lock_free_concurrent_data_structures/09_object_pool.cpp
+ *
+ *   LockFreeQueue<int, pool_allocator<int>> q;   // 节点从池里分配
+ *   std::list<int, pool_allocator<int>> l;
+ *
+ * - 每个 (大小, 对齐) 一个进程级的池 fixed_pool<Size, Align>；
+ * - 每个线程持有两个弹匣（loaded / previous，各装 MAGAZINE 个空闲对象的指针），
+ *   分配和释放绝大多数时候只在本线程的弹匣里进出，不碰任何共享变量；
+ * - 两个弹匣都空（或都满）时，才与仓库整匣交换：仓库是两个无锁栈（满匣 / 空匣），
+ *   栈顶指针的高 16 位带版本号防 ABA；弹匣从不释放，出栈时读 next 不会访问已释放内存；
+ * - 仓库也没有满匣时，从新申请的大块内存（chunk）里切出一批对象，同时多备一倍空匣；
+ * - 释放路径不分配内存（deallocate 是 noexcept）：需要空匣而仓库里没有时，对象用自身的
+ *   首字链进一条散件链表（loose），分配路径缺货时再把它们装匣取走；
+ * - 跨线程释放：对象释放到释放者自己的弹匣里，满了整匣交给仓库，分配者再从仓库
+ *   取走，生产者分配、消费者释放的模式下对象经仓库回流，不需要额外处理；
+ * - 线程退出时把弹匣还给仓库；此后（其他 thread_local 的析构函数里）本线程的分配与释放
+ *   直接走仓库；池本身不析构，内存不归还操作系统。
+ * pool_allocator<T> 是无状态分配器：单个对象走池，数组走 ::operator new。
+ */
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <utility>
+
+#include "cache_line.hpp"
+
+template <std::size_t Size, std::size_t Align = alignof(std::max_align_t)>
+class fixed_pool {
+  static_assert(sizeof(void*) == 8, "tagged depot pointers assume a 64-bit address space");
+
+ public:
+  static constexpr std::size_t MAGAZINE = 64;  // 每个弹匣的对象数
+  static constexpr std::size_t OBJECT_SIZE =
+      ((Size < sizeof(void*) ? sizeof(void*) : Size) + Align - 1) / Align * Align;
+  static constexpr std::size_t CHUNK_OBJECTS =
+      OBJECT_SIZE * MAGAZINE * 4 >= 64 * 1024 ? MAGAZINE * 4 : 64 * 1024 / OBJECT_SIZE;
+
+ private:
+  struct magazine {
+    std::atomic<magazine*> next{nullptr};
+    std::size_t count = 0;
+    void* slots[MAGAZINE];
+  };
+
+  // 无锁栈：低 48 位是指针，高 16 位是版本号
+  class tagged_stack {
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> top{0};
+
+    static magazine* ptr(std::uint64_t v) {
+      return reinterpret_cast<magazine*>(v & ((std::uint64_t(1) << 48) - 1));
+    }
+    static std::uint64_t pack(magazine* m, std::uint64_t old) {
+      return reinterpret_cast<std::uint64_t>(m) | ((old >> 48) + 1) << 48;
+    }
+
+   public:
+    void push(magazine* m) {
+      std::uint64_t old = top.load(std::memory_order_relaxed);
+      do {
+        m->next.store(ptr(old), std::memory_order_relaxed);
+      } while (!top.compare_exchange_weak(old, pack(m, old), std::memory_order_release,
+                                          std::memory_order_relaxed));
+    }
+
+    magazine* pop() {
+      std::uint64_t old = top.load(std::memory_order_acquire);
+      for (;;) {
+        magazine* m = ptr(old);
+        if (!m) return nullptr;
+        // m 可能已被别人弹出并改写，读到的 next 作废，由版本号让下面的 CAS 失败
+        magazine* next = m->next.load(std::memory_order_relaxed);
+        if (top.compare_exchange_weak(old, pack(next, old), std::memory_order_acquire,
+                                      std::memory_order_acquire))
+          return m;
+      }
+    }
+  };
+
+  struct cache {
+    magazine* loaded = nullptr;
+    magazine* previous = nullptr;
+
+    ~cache() {
+      for (magazine* m : {loaded, previous})
+        if (m) (m->count ? instance().full : instance().empty).push(m);
+      loaded = previous = nullptr;
+      torn_down = true;
+    }
+  };
+
+  // 本线程的 cache 已析构。平凡类型的 thread_local 没有析构，整个线程生命期内都可读
+  static inline thread_local bool torn_down = false;
+
+  tagged_stack full;   // 装有对象的弹匣（不一定装满）
+  tagged_stack empty;  // 空弹匣
+  std::atomic<std::size_t> reserved{0};
+
+  // 散件链表：没有空匣可用时释放的对象，经对象自身的首字相连。少见路径，用自旋锁保护
+  std::atomic_flag loose_lock = ATOMIC_FLAG_INIT;
+  void* loose = nullptr;
+  std::atomic<std::size_t> loose_count{0};
+
+  fixed_pool() = default;
+
+  void lock_loose() noexcept {
+    while (loose_lock.test_and_set(std::memory_order_acquire)) std::this_thread::yield();
+  }
+  void unlock_loose() noexcept { loose_lock.clear(std::memory_order_release); }
+
+  void push_loose(void* p) noexcept {
+    lock_loose();
+    std::memcpy(p, &loose, sizeof loose);  // 对齐小于指针时对象首字可能未对齐
+    loose = p;
+    loose_count.fetch_add(1, std::memory_order_relaxed);
+    unlock_loose();
+  }
+
+  // 把散件装进一个弹匣取走；没有散件时返回 nullptr
+  magazine* take_loose() {
+    if (!loose_count.load(std::memory_order_relaxed)) return nullptr;
+    magazine* m = empty.pop();
+    if (!m) m = new magazine;
+    m->count = 0;
+    lock_loose();
+    while (loose && m->count < MAGAZINE) {
+      m->slots[m->count++] = loose;
+      std::memcpy(&loose, loose, sizeof loose);
+    }
+    loose_count.fetch_sub(m->count, std::memory_order_relaxed);
+    unlock_loose();
+    if (m->count) return m;
+    empty.push(m);
+    return nullptr;
+  }
+
+  // 分配路径缺满匣：先取仓库，再取散件，最后切新内存
+  magazine* take_full() {
+    magazine* m = full.pop();
+    if (!m) m = take_loose();
+    if (!m) m = refill();
+    return m;
+  }
+
+  // 线程退出途中 cache 已析构时返回 nullptr
+  static cache* local() {
+    if (torn_down) return nullptr;
+    thread_local cache c;
+    return &c;
+  }
+
+  // 没有 cache 可用：取一个满匣拿走一个对象，剩下的放回仓库
+  void* allocate_uncached() {
+    magazine* m = take_full();
+    void* p = m->slots[--m->count];
+    (m->count ? full : empty).push(m);
+    return p;
+  }
+
+  // 没有 cache 可用：对象单独装一匣交给仓库，没有空匣时放进散件链表
+  void deallocate_uncached(void* p) noexcept {
+    magazine* m = empty.pop();
+    if (!m) return push_loose(p);
+    m->count = 0;
+    m->slots[m->count++] = p;
+    full.push(m);
+  }
+
+  // 仓库里没有对象了：切一块新内存，第一匣直接返回，其余放进仓库；
+  // 再备同样数量的空匣，让释放路径尽量不落到散件链表
+  magazine* refill() {
+    auto* chunk = static_cast<unsigned char*>(::operator new(
+        OBJECT_SIZE * CHUNK_OBJECTS, std::align_val_t(Align < CACHE_LINE_SIZE ? CACHE_LINE_SIZE : Align)));
+    reserved.fetch_add(OBJECT_SIZE * CHUNK_OBJECTS, std::memory_order_relaxed);
+    magazine* first = nullptr;
+    for (std::size_t i = 0; i < CHUNK_OBJECTS; i += MAGAZINE) {
+      magazine* m = empty.pop();
+      if (!m) m = new magazine;
+      m->count = 0;
+      for (std::size_t j = i; j < i + MAGAZINE && j < CHUNK_OBJECTS; ++j)
+        m->slots[m->count++] = chunk + j * OBJECT_SIZE;
+      if (first)
+        full.push(m);
+      else
+        first = m;
+      empty.push(new magazine);
+    }
+    return first;
+  }
+
+ public:
+  static fixed_pool& instance() {
+    static fixed_pool* pool = new fixed_pool;  // 故意不析构：线程退出时还会归还弹匣
+    return *pool;
+  }
+
+  fixed_pool(const fixed_pool&) = delete;
+  fixed_pool& operator=(const fixed_pool&) = delete;
+
+  void* allocate() {
+    cache* cp = local();
+    if (!cp) return allocate_uncached();
+    cache& c = *cp;
+    if (c.loaded && c.loaded->count) return c.loaded->slots[--c.loaded->count];
+    if (c.previous && c.previous->count) {
+      std::swap(c.loaded, c.previous);
+      return c.loaded->slots[--c.loaded->count];
+    }
+    // 两个弹匣都空：交出一个空匣，换一个满匣
+    magazine* m = take_full();
+    if (c.previous) empty.push(c.previous);
+    c.previous = c.loaded;
+    c.loaded = m;
+    return m->slots[--m->count];
+  }
+
+  void deallocate(void* p) noexcept {
+    cache* cp = local();
+    if (!cp) return deallocate_uncached(p);
+    cache& c = *cp;
+    if (c.loaded && c.loaded->count < MAGAZINE) {
+      c.loaded->slots[c.loaded->count++] = p;
+      return;
+    }
+    if (c.previous && c.previous->count < MAGAZINE) {
+      std::swap(c.loaded, c.previous);
+      c.loaded->slots[c.loaded->count++] = p;
+      return;
+    }
+    // 两个弹匣都满：交出一个满匣，换一个空匣；仓库没有空匣时不分配，对象进散件链表
+    magazine* m = empty.pop();
+    if (!m) return push_loose(p);
+    m->count = 0;
+    if (c.previous) full.push(c.previous);
+    c.previous = c.loaded;
+    c.loaded = m;
+    m->slots[m->count++] = p;
+  }
+
+  // 已从系统申请的字节数（只增不减）
+  std::size_t bytes_reserved() const { return reserved.load(std::memory_order_relaxed); }
+};
+
+template <typename T>
+class pool_allocator {
+ public:
+  using value_type = T;
+  using pool = fixed_pool<sizeof(T), alignof(T)>;
+
+  pool_allocator() noexcept = default;
+  template <typename U>
+  pool_allocator(const pool_allocator<U>&) noexcept {}
+
+  T* allocate(std::size_t n) {
+    if (n == 1) return static_cast<T*>(pool::instance().allocate());
+    return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+  }
+
+  void deallocate(T* p, std::size_t n) noexcept {
+    if (n == 1)
+      pool::instance().deallocate(p);
+    else
+      ::operator delete(p, std::align_val_t(alignof(T)));
+  }
+
+  template <typename U>
+  bool operator==(const pool_allocator<U>&) const noexcept {
+    return true;
+  }
+  template <typename U>
+  bool operator!=(const pool_allocator<U>&) const noexcept {
+    return false;
+  }
+};
@@ -0,0 +1,260 @@
+/**
+ * @file perf_counters.hpp
+ * @brief Linux perf_event_open 封装：给基准测试的测量区间加上硬件性能计数器
+ *
+ *   perf_counters pc;                        // 在创建被测线程之前构造
+ *   perf_sample s = pc.measure([&] { run(); });
+ *   std::cout << pc.status() << "\n";           // 哪些事件可用（一次）
+ *   std::cout << perf_summary(s, ops) << "\n";  // 每次操作的 cycles / 缺失数等
+ *
+ * 事件：cycles、instructions、branch-misses、L1d 读缺失、LLC 读缺失；Intel 上额外
+ * 尝试 MEM_LOAD_L3_HIT_RETIRED.XSNP_HITM（load 命中了其他核心改过的缓存行，
+ * 即缓存行在核间迁移，是伪共享 / 真共享的直接证据）；另有 task-clock、
+ * context-switches、cpu-migrations 三个软件事件。
+ * - 每个事件单独打开，打不开的（虚拟机没有 PMU、perf_event_paranoid 不允许、CPU 不支持）
+ *   记为不可用并保留原因，其余照常计数；一个都打不开时 measure 照样执行 f；
+ * - 硬件事件只统计用户态，perf_event_paranoid <= 2 时普通用户即可使用；
+ * - inherit：计数覆盖构造之后由本线程创建的线程，读数是本线程与这些线程之和；
+ *   传 false 则只统计调用线程；
+ * - 事件多于硬件计数器时内核分时复用，读数按 time_enabled / time_running 折算。
+ * 非 Linux 平台所有事件都不可用。
+ */
+
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
+struct perf_value {
+  const char* name;
+  bool available;
+  bool hardware;
+  double value;        // 已按复用比例折算
+  std::string reason;  // 不可用的原因
+};
+
+struct perf_sample {
+  std::vector<perf_value> values;
+
+  std::optional<double> get(const std::string& name) const {
+    for (auto& v : values)
+      if (v.available && name == v.name) return v.value;
+    return std::nullopt;
+  }
+};
+
+class perf_counters {
+  struct counter {
+    const char* name;
+    bool hardware;
+    int fd = -1;
+    std::string reason;  // 打不开时的原因
+    // value, time_enabled, time_running。RESET 清不掉已退出子线程并入的计数，所以取差值
+    std::uint64_t raw[3] = {};
+    std::uint64_t base[3] = {};
+
+    counter(const char* name, bool hardware, std::string reason = {})
+        : name(name), hardware(hardware), reason(std::move(reason)) {}
+  };
+  std::vector<counter> counters;
+
+#ifdef __linux__
+  static bool is_intel() {
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line))
+      if (line.rfind("vendor_id", 0) == 0) return line.find("GenuineIntel") != std::string::npos;
+    return false;
+  }
+
+  static std::string paranoid_level() {
+    std::ifstream f("/proc/sys/kernel/perf_event_paranoid");
+    std::string level;
+    f >> level;
+    return level;
+  }
+
+  static std::string describe(int err) {
+    switch (err) {
+      case EACCES:
+      case EPERM:
+        return "permission denied (kernel.perf_event_paranoid = " + paranoid_level() + ")";
+      case ENOENT:
+      case ENODEV:
+      case EOPNOTSUPP:
+        return "not supported here (no PMU, e.g. in a VM?)";
+      default:
+        return std::strerror(err);
+    }
+  }
+
+  void open(const char* name, std::uint32_t type, std::uint64_t config, bool inherit) {
+    counter c{name, type != PERF_TYPE_SOFTWARE};
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.inherit = inherit ? 1 : 0;
+    attr.exclude_hv = 1;
+    attr.exclude_kernel = c.hardware ? 1 : 0;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    c.fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+    if (c.fd < 0 && !c.hardware && (errno == EACCES || errno == EPERM)) {
+      attr.exclude_kernel = 1;  // 不允许统计内核态时退回只统计用户态
+      c.fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+    }
+    if (c.fd < 0) c.reason = describe(errno);
+    counters.push_back(std::move(c));
+  }
+
+  static bool read_raw(counter& c) {
+    return ::read(c.fd, c.raw, sizeof(c.raw)) == static_cast<ssize_t>(sizeof(c.raw));
+  }
+
+  static constexpr std::uint64_t cache_event(std::uint64_t cache) {
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+  }
+#endif
+
+ public:
+  explicit perf_counters(bool inherit = true) {
+#ifdef __linux__
+    open("cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, inherit);
+    open("instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, inherit);
+    open("branch-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, inherit);
+    open("L1d-misses", PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_L1D), inherit);
+    open("LLC-misses", PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_LL), inherit);
+    if (is_intel()) {
+      open("hitm", PERF_TYPE_RAW, 0x04d2, inherit);  // event 0xd2, umask 0x04 (Skylake 及以后)
+    } else {
+      counters.emplace_back("hitm", true, "raw HITM event is only defined for Intel CPUs");
+    }
+    open("task-clock", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK, inherit);
+    open("context-switches", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES, inherit);
+    open("cpu-migrations", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS, inherit);
+#else
+    (void)inherit;
+    for (const char* name : {"cycles", "instructions", "branch-misses", "L1d-misses", "LLC-misses",
+                             "hitm", "task-clock", "context-switches", "cpu-migrations"})
+      counters.emplace_back(name, true, "perf_event_open is Linux-only");
+#endif
+  }
+
+  ~perf_counters() {
+#ifdef __linux__
+    for (auto& c : counters)
+      if (c.fd >= 0) close(c.fd);
+#endif
+  }
+
+  perf_counters(const perf_counters&) = delete;
+  perf_counters& operator=(const perf_counters&) = delete;
+
+  // 哪些事件可用、不可用的原因，基准开始时打印一次
+  std::string status() const {
+    std::string ok, missing;
+    for (auto& c : counters) {
+      std::string& out = c.fd >= 0 ? ok : missing;
+      if (!out.empty()) out += ", ";
+      out += c.name;
+      if (c.fd < 0 && missing.find(c.reason) == std::string::npos) out += " [" + c.reason + "]";
+    }
+    return "perf counters: " + (ok.empty() ? std::string("none") : ok) +
+           (missing.empty() ? "" : "; unavailable: " + missing);
+  }
+
+  bool any_hardware() const {
+    for (auto& c : counters)
+      if (c.hardware && c.fd >= 0) return true;
+    return false;
+  }
+
+  void start() {
+#ifdef __linux__
+    for (auto& c : counters)
+      if (c.fd >= 0) {
+        read_raw(c);
+        c.base[0] = c.raw[0], c.base[1] = c.raw[1], c.base[2] = c.raw[2];
+        ioctl(c.fd, PERF_EVENT_IOC_ENABLE, 0);
+      }
+#endif
+  }
+
+  perf_sample stop() {
+    perf_sample s;
+#ifdef __linux__
+    for (auto& c : counters)
+      if (c.fd >= 0) ioctl(c.fd, PERF_EVENT_IOC_DISABLE, 0);
+#endif
+    for (auto& c : counters) {
+      perf_value v{c.name, false, c.hardware, 0.0, c.reason};
+#ifdef __linux__
+      if (c.fd >= 0 && read_raw(c)) {
+        const std::uint64_t value = c.raw[0] - c.base[0];
+        const std::uint64_t enabled = c.raw[1] - c.base[1], running = c.raw[2] - c.base[2];
+        if (running > 0) {
+          v.available = true;
+          v.value = static_cast<double>(value) * enabled / running;
+        } else if (enabled > 0) {
+          v.reason = "never scheduled on a hardware counter";
+        } else {
+          v.available = true;  // 区间太短，计数为 0
+        }
+      }
+#endif
+      s.values.push_back(std::move(v));
+    }
+    return s;
+  }
+
+  template <typename F>
+  perf_sample measure(F&& f) {
+    start();
+    f();
+    return stop();
+  }
+};
+
+// 一行摘要：硬件事件按每次操作给出，软件事件给总量；不可用的事件不出现（原因见 status()）
+inline std::string perf_summary(const perf_sample& s, double ops) {
+  std::string hw, sw;
+  char buf[96];
+  auto append = [&buf](std::string& out) {
+    if (!out.empty()) out += ", ";
+    out += buf;
+  };
+  auto cycles = s.get("cycles"), instructions = s.get("instructions");
+  if (cycles && instructions && *cycles > 0) {
+    std::snprintf(buf, sizeof(buf), "IPC %.2f", *instructions / *cycles);
+    append(hw);
+  }
+  for (auto& v : s.values) {
+    if (!v.available) continue;
+    if (v.hardware) {
+      std::snprintf(buf, sizeof(buf), "%s %.3g/op", v.name, v.value / ops);
+      append(hw);
+    } else if (std::string(v.name) == "task-clock") {
+      std::snprintf(buf, sizeof(buf), "task-clock %.1f ms", v.value / 1e6);
+      append(sw);
+    } else {
+      std::snprintf(buf, sizeof(buf), "%s %.0f", v.name, v.value);
+      append(sw);
+    }
+  }
+  return "perf: " + (hw.empty() ? sw : sw.empty() ? hw : hw + "; " + sw);
+}
@@ -0,0 +1,157 @@
+/**
+ * @file qsbr_manager.hpp
+ * @brief 基于静止状态的内存回收（QSBR, quiescent-state-based reclamation）
+ * 示例见 07_lock_free_concurrent_data_structures/14_reclamation_schemes.cpp
+ *
+ * 读侧什么都不做：不发布风险指针，也不进出纪元。线程在不持有任何共享节点的位置
+ * （例如工作循环的每一轮末尾）调用 quiescent_state()，宣告“之前读到的指针我都不再用了”。
+ * 写者 retire() 时给节点打上全局计数器的当前值并把计数器加一；所有在线线程宣告过的
+ * 计数都超过这个值之后，节点即可释放。
+ *
+ * - 线程要阻塞（I/O、等锁、sleep）时先 thread_offline()，回来后 thread_online()，
+ *   离线线程不会拖住回收；
+ * - 代价转移给了使用者：在线线程长时间不宣告静止状态，所有线程的退休节点都无法释放；
+ * - 与风险指针一样，线程记录是进程级的（所有 qsbr_manager 实例共享），线程退出时
+ *   自动离线，记录与其中未释放的节点留给后来的线程复用。
+ */
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+#include "cache_line.hpp"
+#include "trace.hpp"
+
+const std::uint64_t QSBR_OFFLINE = 0;
+
+struct qsbr_record {
+  struct retired {
+    void* ptr;
+    void (*deleter)(void*);
+    std::uint64_t stamp;  // 退休时的全局计数
+  };
+
+  alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> announced{QSBR_OFFLINE};
+  std::atomic<bool> in_use{false};
+  qsbr_record* next = nullptr;
+  std::deque<retired> bag;  // 只由持有该记录的线程访问
+};
+
+// 线程退出时离线并归还记录
+struct qsbr_thread_handle {
+  qsbr_record* rec = nullptr;
+  ~qsbr_thread_handle() {
+    if (!rec) return;
+    rec->announced.store(QSBR_OFFLINE, std::memory_order_release);
+    rec->in_use.store(false, std::memory_order_release);
+  }
+};
+
+class qsbr_manager {
+  using record = qsbr_record;
+
+  static constexpr std::size_t SCAN_THRESHOLD = 64;  // 攒够这么多再扫描，摊薄扫描开销
+
+  static inline std::atomic<std::uint64_t> counter_{1};
+  static inline std::atomic<record*> head_{nullptr};
+  static inline std::atomic<std::size_t> reclaimed_{0};
+  static inline thread_local qsbr_thread_handle self_;
+
+  static record* acquire_record() {
+    for (record* p = head_.load(std::memory_order_acquire); p; p = p->next) {
+      bool expected = false;
+      if (!p->in_use.load(std::memory_order_relaxed) &&
+          p->in_use.compare_exchange_strong(expected, true))
+        return p;
+    }
+    record* rec = new record;
+    rec->in_use.store(true, std::memory_order_relaxed);
+    record* old_head = head_.load(std::memory_order_relaxed);
+    do {
+      rec->next = old_head;
+    } while (!head_.compare_exchange_weak(old_head, rec, std::memory_order_release,
+                                          std::memory_order_relaxed));
+    return rec;
+  }
+
+  // 所有在线线程宣告过的最小计数；比它小的退休节点已没有读者引用
+  static std::uint64_t grace_period_bound() {
+    std::uint64_t bound = counter_.load(std::memory_order_seq_cst);
+    // 与 thread_online() 中的栅栏配对：要么这里看到上线声明，要么上线的线程读不到
+    // 已摘下的节点
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    for (record* p = head_.load(std::memory_order_acquire); p; p = p->next) {
+      const std::uint64_t a = p->announced.load(std::memory_order_acquire);
+      if (a != QSBR_OFFLINE && a < bound) bound = a;
+    }
+    return bound;
+  }
+
+ public:
+  void register_thread() {
+    if (self_.rec) return;
+    self_.rec = acquire_record();
+    thread_online();
+  }
+
+  // 静止点：本线程不再持有任何之前读到的共享指针。有待回收的节点时顺便尝试回收
+  void quiescent_state() {
+    record* rec = self_.rec;
+    if (!rec) return register_thread();
+    rec->announced.store(counter_.load(std::memory_order_acquire), std::memory_order_release);
+    if (!rec->bag.empty()) scan();
+  }
+
+  // 阻塞调用之前离线，回来后上线；离线期间不得访问共享节点
+  void thread_offline() {
+    if (self_.rec) self_.rec->announced.store(QSBR_OFFLINE, std::memory_order_release);
+  }
+
+  void thread_online() {
+    if (!self_.rec) return register_thread();
+    self_.rec->announced.store(counter_.load(std::memory_order_acquire), std::memory_order_seq_cst);
+    // 上线声明须先于之后对共享节点的读取被回收者看到（store-load，需要全屏障），
+    // 与 grace_period_bound() 读 announced 之前的栅栏配对
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
+
+  template <typename T>
+  void retire(T* ptr) {
+    retire(ptr, [](void* p) { delete static_cast<T*>(p); });
+  }
+
+  // 节点须已从数据结构中摘下
+  void retire(void* ptr, void (*deleter)(void*)) {
+    register_thread();
+    const std::uint64_t stamp = counter_.fetch_add(1, std::memory_order_seq_cst);
+    self_.rec->bag.push_back({ptr, deleter, stamp});
+    if (self_.rec->bag.size() >= SCAN_THRESHOLD) scan();
+  }
+
+  // 释放本线程已过宽限期的退休节点，返回释放数。同一线程退休的计数单调递增，
+  // 只需从队头释放到第一个未过宽限期的节点
+  std::size_t scan() {
+    TRACE_SCOPE("qsbr.scan");
+    auto& bag = self_.rec->bag;
+    const std::uint64_t bound = grace_period_bound();
+    std::size_t freed = 0;
+    while (!bag.empty() && bag.front().stamp < bound) {
+      bag.front().deleter(bag.front().ptr);
+      bag.pop_front();
+      ++freed;
+    }
+    if (freed) {
+      reclaimed_.fetch_add(freed, std::memory_order_relaxed);
+      TRACE_INSTANT("qsbr.reclaim", freed);
+    }
+    return freed;
+  }
+
+  // 本线程尚未释放的退休节点数
+  std::size_t pending() const { return self_.rec ? self_.rec->bag.size() : 0; }
+
+  // 累计释放的节点数
+  std::size_t reclaimed() const { return reclaimed_.load(std::memory_order_relaxed); }
+};
@@ -0,0 +1,98 @@
+/**
+ * @file reclaimer.hpp
+ * @brief 内存回收策略的统一接口：风险指针、EBR、QSBR 三选一，编译期作为模板参数传给容器
+ * 示例见 07_lock_free_concurrent_data_structures/14_reclamation_schemes.cpp
+ *
+ * 每种策略都提供：
+ * - guard：RAII 读侧临界区，包住一次完整的容器操作（EBR 进出纪元，其余只确保线程已登记）；
+ * - protect(index, src)：读取共享指针，保证结果在 release(index) 或 guard 结束之前
+ *   不会被释放（风险指针发布后重读确认，其余只是 acquire 读）；
+ * - retire(p, deleter)：节点已从容器中摘下，没有读者引用后调用 deleter；
+ * - quiescent_state() / thread_offline() / thread_online()：只对 QSBR 有意义，其余为空操作。
+ *   通用代码在工作循环的边界、阻塞调用前后照常调用即可。
+ *
+ * 风险指针最多同时保护 HP_PER_THREAD 个指针；选用 qsbr_reclaimer 的容器，使用它的线程
+ * 必须定期调用 quiescent_state()，否则退休节点只会越积越多。
+ */
+
+#pragma once
+#include <atomic>
+
+#include "epoch_manager.hpp"
+#include "hazard_pointers.hpp"
+#include "qsbr_manager.hpp"
+
+class hp_reclaimer {
+  HazardPointerManager hp;
+
+ public:
+  class guard {
+   public:
+    explicit guard(hp_reclaimer& r) { r.hp.registerThread(); }
+  };
+
+  // 发布风险指针后重读，确认 src 仍指向它（否则节点可能已被摘下）
+  template <typename T>
+  T* protect(int index, const std::atomic<T*>& src) {
+    T* p = src.load(std::memory_order_acquire);
+    for (;;) {
+      hp.acquire(index, p);
+      T* again = src.load(std::memory_order_acquire);
+      if (again == p) return p;
+      p = again;
+    }
+  }
+
+  void release(int index) { hp.release(index); }
+  void retire(void* p, void (*deleter)(void*)) { hp.retire(p, deleter); }
+  void quiescent_state() {}
+  void thread_offline() {}
+  void thread_online() {}
+};
+
+class ebr_reclaimer {
+  // EpochManager 的线程控制块是 thread_local 的，一个线程只能登记到一个实例：
+  // 所有容器共用一个进程级的纪元域
+  static inline EpochManager ebr;
+
+ public:
+  class guard {
+   public:
+    explicit guard(ebr_reclaimer&) { ebr.enter(); }
+    ~guard() { ebr.exit(); }
+    guard(const guard&) = delete;
+    guard& operator=(const guard&) = delete;
+  };
+
+  template <typename T>
+  T* protect(int, const std::atomic<T*>& src) {
+    return src.load(std::memory_order_acquire);
+  }
+
+  void release(int) {}
+  void retire(void* p, void (*deleter)(void*)) { ebr.retire(p, deleter); }  // 须在 guard 内
+  void quiescent_state() {}
+  void thread_offline() {}
+  void thread_online() {}
+};
+
+class qsbr_reclaimer {
+  qsbr_manager qsbr;
+
+ public:
+  class guard {
+   public:
+    explicit guard(qsbr_reclaimer& r) { r.qsbr.register_thread(); }
+  };
+
+  template <typename T>
+  T* protect(int, const std::atomic<T*>& src) {
+    return src.load(std::memory_order_acquire);
+  }
+
+  void release(int) {}
+  void retire(void* p, void (*deleter)(void*)) { qsbr.retire(p, deleter); }
+  void quiescent_state() { qsbr.quiescent_state(); }
+  void thread_offline() { qsbr.thread_offline(); }
+  void thread_online() { qsbr.thread_online(); }
+};
@@ -0,0 +1,366 @@
+/**
+ * @file shm_ring.hpp
+ * @brief 共享内存中的变长消息环（单 / 多生产者、单消费者），用于进程间零拷贝传递
+ * 示例见 07_lock_free_concurrent_data_structures/12_shm_ring.cpp
+ *
+ *   int fd = shm_ring::create(1 << 20);          // memfd；传名字则用 shm_open
+ *   // 生产者进程（fork 继承 fd，或经 SCM_RIGHTS 传递，或 shm_ring::open(name)）
+ *   shm_ring ring(fd);
+ *   ring.attach_producer();
+ *   void* p;
+ *   if (ring.claim_wait(n, p) == shm_status::ok) { 直接写 p[0..n); ring.commit(p); }
+ *   // 消费者进程
+ *   shm_ring ring(fd);
+ *   ring.attach_consumer();
+ *   const void* msg; std::size_t n;
+ *   while (ring.peek_wait(msg, n) == shm_status::ok) { 直接读 msg; ring.release(); }
+ *
+ * - 区域里只有偏移量与 64 位递增的字节位置，没有指针，各进程可以映射到不同地址；
+ * - 消息 = 8 字节头（状态字 + 长度）+ 载荷，按 8 字节对齐。生产者 CAS 推进 reserve 抢占
+ *   一段连续空间（尾部放不下时先填一条 padding 记录绕回开头），原地写好后 commit
+ *   把状态字置为已提交；多个生产者可以乱序提交，消费者按位置顺序读，遇到未提交的就等；
+ * - 消费者读完后 release：把这段清零再推进 head。环里 [head, reserve) 之外的字节始终为 0，
+ *   所以任意位置上“状态字非 0”就意味着那里是一条已提交的记录；
+ * - 阻塞：头部里放两个跨进程的 event_count（futex），空 / 满时睡眠；
+ * - 对端崩溃：各方把 pid 登记在头部，等待时每 LIVENESS_CHECK 醒来一次检查对端是否还活着
+ *   （kill(pid, 0) 与 /proc/<pid>/stat 的僵尸状态），返回 peer_crashed 而不是永远等下去。
+ *   生产者在 claim 与 commit 之间崩溃时，这条记录永远不会提交，消费者只能报告崩溃。
+ *   正常退出的一方 detach（析构时自动），对端读完剩余消息后得到 closed。
+ */
+
+#pragma once
+#if !defined(__linux__)
+#error "shm_ring.hpp needs Linux (memfd_create / futex)"
+#endif
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include "cache_line.hpp"
+#include "event_count.hpp"
+
+enum class shm_status { ok, timeout, closed, peer_crashed };
+
+class shm_ring {
+ public:
+  static constexpr int MAX_PRODUCERS = 16;
+  static constexpr auto LIVENESS_CHECK = std::chrono::milliseconds(20);
+
+ private:
+  static constexpr std::uint64_t MAGIC = 0x676e69726d6873ull;  // "shmring"
+  static constexpr std::uint32_t COMMITTED = 1u << 31;
+  static constexpr std::uint32_t PADDING = 1u << 30;
+
+  struct header {
+    std::uint64_t magic;
+    std::uint64_t capacity;  // 数据区字节数，2 的幂
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> reserve{0};  // 生产者抢占到的位置
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> head{0};     // 消费者释放到的位置
+    alignas(CACHE_LINE_SIZE) event_count not_empty{true};
+    alignas(CACHE_LINE_SIZE) event_count not_full{true};
+    // 0：从未登记；-1：已正常退出；其余为 pid
+    alignas(CACHE_LINE_SIZE) std::atomic<std::int32_t> consumer_pid{0};
+    std::atomic<std::int32_t> producer_pids[MAX_PRODUCERS]{};
+    std::atomic<std::uint32_t> producers_attached{0};  // 累计登记过的生产者数
+  };
+  static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+                "shared-memory atomics must be lock-free");
+
+  struct record {
+    std::atomic<std::uint32_t> state;  // 0：未提交；COMMITTED [| PADDING]
+    std::uint32_t len;                 // 载荷字节数（padding 记录为整段长度）
+  };
+
+  static constexpr std::size_t DATA_OFFSET =
+      (sizeof(header) + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+
+  int fd = -1;
+  std::size_t map_size = 0;
+  header* h = nullptr;
+  unsigned char* data = nullptr;
+  std::uint64_t mask = 0;
+  int producer_slot = -1;
+  bool consumer = false;
+  std::uint64_t read_pos = 0;  // 消费者本地的 head
+
+  static std::uint64_t record_size(std::size_t payload) {
+    return (sizeof(record) + payload + 7) & ~std::uint64_t(7);
+  }
+
+  record* at(std::uint64_t pos) const { return reinterpret_cast<record*>(data + (pos & mask)); }
+
+  static bool process_alive(std::int32_t pid) {
+    if (::kill(pid, 0) == -1 && errno == ESRCH) return false;
+    std::ifstream stat("/proc/" + std::to_string(pid) + "/stat");
+    std::string line;
+    if (!std::getline(stat, line)) return true;  // 读不到就当作还活着
+    const std::size_t p = line.rfind(')');
+    return p == std::string::npos || p + 2 >= line.size() ||
+           (line[p + 2] != 'Z' && line[p + 2] != 'X');
+  }
+
+  // 消费者看生产者：有人崩溃 / 全部正常退出 / 还有人活着（ok）
+  shm_status producers_state() const {
+    bool any_alive = false, any_crashed = false;
+    for (auto& slot : h->producer_pids) {
+      const std::int32_t pid = slot.load(std::memory_order_acquire);
+      if (pid <= 0) continue;
+      if (process_alive(pid))
+        any_alive = true;
+      else
+        any_crashed = true;
+    }
+    if (any_crashed) return shm_status::peer_crashed;
+    if (any_alive || h->producers_attached.load(std::memory_order_acquire) == 0)
+      return shm_status::ok;
+    return shm_status::closed;
+  }
+
+  shm_status consumer_state() const {
+    const std::int32_t pid = h->consumer_pid.load(std::memory_order_acquire);
+    if (pid == 0) return shm_status::ok;  // 还没登记，继续等
+    if (pid < 0) return shm_status::closed;
+    return process_alive(pid) ? shm_status::ok : shm_status::peer_crashed;
+  }
+
+  // 等 try_op 成功；每个 LIVENESS_CHECK 周期检查一次对端
+  template <typename TryOp, typename PeerState>
+  shm_status wait(event_count& ec, TryOp&& try_op, PeerState&& peer_state,
+                  std::chrono::steady_clock::time_point deadline) {
+    for (;;) {
+      if (try_op()) return shm_status::ok;
+      auto key = ec.prepare_wait();
+      if (try_op()) {
+        ec.cancel_wait();
+        return shm_status::ok;
+      }
+      const auto now = std::chrono::steady_clock::now();
+      if (ec.commit_wait_until(key, std::min(deadline, now + LIVENESS_CHECK))) continue;
+      const shm_status peer = peer_state();
+      if (peer != shm_status::ok) return try_op() ? shm_status::ok : peer;
+      if (std::chrono::steady_clock::now() >= deadline) return shm_status::timeout;
+    }
+  }
+
+  static constexpr auto FOREVER = std::chrono::steady_clock::time_point::max();
+
+ public:
+  // 创建并初始化一个环，返回 fd：name 为空时用匿名 memfd（靠 fork 继承或 SCM_RIGHTS 传递），
+  // 否则用 shm_open(name)（其他进程可按名字 open，用完需 shm_unlink）
+  static int create(std::size_t capacity, const char* name = nullptr) {
+    if (capacity < 64 || (capacity & (capacity - 1)) != 0)
+      throw std::invalid_argument("shm_ring capacity must be a power of 2 (>= 64)");
+    int fd = name ? ::shm_open(name, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600)
+                  : ::memfd_create("shm_ring", MFD_CLOEXEC);
+    if (fd < 0) throw std::system_error(errno, std::generic_category(), "shm_ring create");
+    if (::ftruncate(fd, DATA_OFFSET + capacity) != 0) {
+      const int err = errno;
+      ::close(fd);
+      throw std::system_error(err, std::generic_category(), "shm_ring ftruncate");
+    }
+    void* p = ::mmap(nullptr, DATA_OFFSET, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+      const int err = errno;
+      ::close(fd);
+      throw std::system_error(err, std::generic_category(), "shm_ring mmap");
+    }
+    header* hdr = ::new (p) header;  // 新文件全是 0，数据区无需初始化
+    hdr->capacity = capacity;
+    hdr->magic = MAGIC;  // 其他进程拿到 fd 之前就已写好
+    ::munmap(p, DATA_OFFSET);
+    return fd;
+  }
+
+  static shm_ring open(const char* name) {
+    int fd = ::shm_open(name, O_RDWR | O_CLOEXEC, 0);
+    if (fd < 0) throw std::system_error(errno, std::generic_category(), "shm_ring open");
+    shm_ring ring(fd);
+    ::close(fd);
+    return ring;
+  }
+
+  // 映射 fd 指向的环（dup 一份，调用方仍可关闭自己的 fd）
+  explicit shm_ring(int ring_fd) : fd(::dup(ring_fd)) {
+    struct stat st;
+    if (fd < 0 || ::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < DATA_OFFSET) {
+      if (fd >= 0) ::close(fd);
+      throw std::runtime_error("shm_ring: not a ring fd");
+    }
+    map_size = static_cast<std::size_t>(st.st_size);
+    void* p = ::mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+      const int err = errno;
+      ::close(fd);
+      throw std::system_error(err, std::generic_category(), "shm_ring mmap");
+    }
+    h = static_cast<header*>(p);
+    data = static_cast<unsigned char*>(p) + DATA_OFFSET;
+    if (h->magic != MAGIC || DATA_OFFSET + h->capacity != map_size) {
+      ::munmap(p, map_size);
+      ::close(fd);
+      throw std::runtime_error("shm_ring: bad header");
+    }
+    mask = h->capacity - 1;
+  }
+
+  shm_ring(shm_ring&& o) noexcept
+      : fd(o.fd), map_size(o.map_size), h(o.h), data(o.data), mask(o.mask),
+        producer_slot(o.producer_slot), consumer(o.consumer), read_pos(o.read_pos) {
+    o.fd = -1;
+    o.h = nullptr;
+    o.producer_slot = -1;
+    o.consumer = false;
+  }
+
+  shm_ring(const shm_ring&) = delete;
+  shm_ring& operator=(const shm_ring&) = delete;
+  shm_ring& operator=(shm_ring&&) = delete;
+
+  ~shm_ring() {
+    if (!h) return;
+    detach();
+    ::munmap(h, map_size);
+    ::close(fd);
+  }
+
+  std::size_t capacity() const { return h->capacity; }
+
+  // 单条消息的最大载荷
+  std::size_t max_message() const { return h->capacity / 2 - sizeof(record); }
+
+  void attach_producer() {
+    const std::int32_t pid = ::getpid();
+    for (int i = 0; i < MAX_PRODUCERS; ++i) {
+      std::int32_t expected = 0;
+      if (h->producer_pids[i].compare_exchange_strong(expected, pid)) {
+        producer_slot = i;
+        h->producers_attached.fetch_add(1, std::memory_order_release);
+        return;
+      }
+    }
+    throw std::runtime_error("shm_ring: too many producers");
+  }
+
+  // 只能有一个消费者
+  void attach_consumer() {
+    std::int32_t expected = 0;
+    if (!h->consumer_pid.compare_exchange_strong(expected, ::getpid()))
+      throw std::runtime_error("shm_ring: consumer already attached");
+    consumer = true;
+    read_pos = h->head.load(std::memory_order_acquire);
+  }
+
+  // 正常退出：对端读完 / 不再等待后得到 closed
+  void detach() {
+    if (producer_slot >= 0) {
+      h->producer_pids[producer_slot].store(0, std::memory_order_release);
+      producer_slot = -1;
+      h->not_empty.notify();
+    }
+    if (consumer) {
+      h->consumer_pid.store(-1, std::memory_order_release);
+      consumer = false;
+      h->not_full.notify_all();
+    }
+  }
+
+  // ---- 生产者 ----
+
+  // 抢占 size 字节的连续空间，空间不足返回 nullptr；写好后必须 commit
+  void* try_claim(std::size_t size) {
+    if (size > max_message()) throw std::length_error("shm_ring: message too large");
+    const std::uint64_t need = record_size(size);
+    const std::uint64_t cap = h->capacity;
+    std::uint64_t pos = h->reserve.load(std::memory_order_relaxed);
+    for (;;) {
+      const std::uint64_t room = cap - (pos & mask);
+      const std::uint64_t pad = room < need ? room : 0;  // 尾部放不下：整段作废，绕回开头
+      if (pos + pad + need > h->head.load(std::memory_order_acquire) + cap) return nullptr;
+      if (h->reserve.compare_exchange_weak(pos, pos + pad + need, std::memory_order_relaxed)) {
+        if (pad) {
+          record* r = at(pos);
+          r->len = static_cast<std::uint32_t>(pad);
+          r->state.store(COMMITTED | PADDING, std::memory_order_release);
+        }
+        record* r = at(pos + pad);
+        r->len = static_cast<std::uint32_t>(size);
+        return r + 1;
+      }
+    }
+  }
+
+  shm_status claim_wait(std::size_t size, void*& out,
+                        std::chrono::steady_clock::time_point deadline = FOREVER) {
+    return wait(
+        h->not_full, [&] { return (out = try_claim(size)) != nullptr; },
+        [this] { return consumer_state(); }, deadline);
+  }
+
+  void commit(void* payload) {
+    record* r = static_cast<record*>(payload) - 1;
+    r->state.store(COMMITTED, std::memory_order_release);
+    h->not_empty.notify();
+  }
+
+  // 拷贝进环的便捷版本
+  shm_status send(const void* buf, std::size_t size) {
+    void* p;
+    shm_status s = claim_wait(size, p);
+    if (s != shm_status::ok) return s;
+    std::memcpy(p, buf, size);
+    commit(p);
+    return s;
+  }
+
+  // ---- 消费者 ----
+
+  // 队首已提交的消息（原地），没有则返回 nullptr；读完调用 release
+  const void* try_peek(std::size_t& size) {
+    for (;;) {
+      record* r = at(read_pos);
+      const std::uint32_t state = r->state.load(std::memory_order_acquire);
+      if (!(state & COMMITTED)) return nullptr;
+      if (!(state & PADDING)) {
+        size = r->len;
+        return r + 1;
+      }
+      release();  // 跳过 padding
+    }
+  }
+
+  shm_status peek_wait(const void*& out, std::size_t& size,
+                       std::chrono::steady_clock::time_point deadline = FOREVER) {
+    return wait(
+        h->not_empty, [&] { return (out = try_peek(size)) != nullptr; },
+        [this] { return producers_state(); }, deadline);
+  }
+
+  // 释放队首消息：清零后交还给生产者
+  void release() {
+    record* r = at(read_pos);
+    const std::uint32_t state = r->state.load(std::memory_order_relaxed);
+    const std::uint64_t n = (state & PADDING) ? r->len : record_size(r->len);
+    std::memset(reinterpret_cast<unsigned char*>(r) + sizeof(record), 0, n - sizeof(record));
+    r->len = 0;
+    r->state.store(0, std::memory_order_relaxed);
+    read_pos += n;
+    h->head.store(read_pos, std::memory_order_release);
+    h->not_full.notify_all();
+  }
+};
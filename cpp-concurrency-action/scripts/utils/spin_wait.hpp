@@ -0,0 +1,30 @@
+/**
+ * @file spin_wait.hpp
+ * @brief 自旋等待辅助：CPU pause 提示 + 自旋次数上限
+ *
+ * 自旋循环里插入 pause 指令可以降低功耗、避免退出循环时的内存序冲突惩罚，
+ * 并把流水线资源让给同一物理核上的超线程兄弟。
+ */
+
+#pragma once
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+  _mm_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield" ::: "memory");
+#else
+  std::this_thread::yield();
+#endif
+}
+
+// 单核机器上自旋毫无意义（等待的对方根本没在运行），直接进入阻塞等待
+inline int default_spin_limit() noexcept {
+  static const int limit = std::thread::hardware_concurrency() > 1 ? 4000 : 0;
+  return limit;
+}
@@ -0,0 +1,96 @@
+/**
+ * @file spsc_queue.hpp
+ * @brief 单生产者-单消费者无锁环形缓冲区
+ * 示例见 07_lock_free_concurrent_data_structures/03_spsc_ring_buffer.cpp
+ *
+ * head/tail 各占一条缓存行，避免生产者与消费者互相使对方的缓存行失效（伪共享）。
+ * push/pop 不阻塞；push_wait/pop_wait（及限时版本）在满/空时按 WaitStrategy 等待，
+ * 策略见 wait_strategy.hpp，默认 spin_park_wait：自旋一小段后通过 event_count 睡眠。
+ */
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#include "cache_line.hpp"
+#include "wait_strategy.hpp"
+
+template <typename T, size_t Capacity, typename WaitStrategy = spin_park_wait>
+class SPSCQueue {
+ private:
+  struct alignas(CACHE_LINE_SIZE) AlignedAtomic {
+    std::atomic<size_t> val;
+  };
+
+  std::vector<T> buffer;
+  AlignedAtomic head;
+  AlignedAtomic tail;
+  alignas(CACHE_LINE_SIZE) WaitStrategy not_empty;  // 消费者在此等待
+  alignas(CACHE_LINE_SIZE) WaitStrategy not_full;   // 生产者在此等待
+
+ public:
+  SPSCQueue() : buffer(Capacity + 1), head{0}, tail{0} {}
+
+  bool push(const T& item) {
+    const size_t current_tail = tail.val.load(std::memory_order_relaxed);
+    const size_t next_tail = (current_tail + 1) % (Capacity + 1);
+
+    if (next_tail == head.val.load(std::memory_order_acquire)) {
+      return false;
+    }
+    buffer[current_tail] = item;
+    tail.val.store(next_tail, std::memory_order_release);
+    not_empty.notify();  // 自旋类策略为空操作；park 策略无人睡眠时只是一次 fence + relaxed load
+    return true;
+  }
+
+  std::optional<T> pop() {
+    const size_t current_head = head.val.load(std::memory_order_relaxed);
+    if (current_head == tail.val.load(std::memory_order_acquire)) {
+      return std::nullopt;
+    }
+    T item = buffer[current_head];
+    head.val.store((current_head + 1) % (Capacity + 1),
+                   std::memory_order_release);
+    not_full.notify();
+    return item;
+  }
+
+  // 近似元素个数（另一端可能正在修改），用于统计队列占用
+  size_t size() const {
+    const size_t h = head.val.load(std::memory_order_acquire);
+    const size_t t = tail.val.load(std::memory_order_acquire);
+    return (t + Capacity + 1 - h) % (Capacity + 1);
+  }
+
+  // 阻塞式 push：队列满时按策略等待，直到消费者 pop
+  void push_wait(const T& item) {
+    not_full.wait([&] { return push(item); });
+  }
+
+  // 阻塞式 pop：队列为空时按策略等待，直到生产者 push
+  T pop_wait() {
+    std::optional<T> item;
+    not_empty.wait([&] { return static_cast<bool>(item = pop()); });
+    return std::move(*item);
+  }
+
+  template <typename Rep, typename Period>
+  bool push_wait_for(const T& item,
+                     const std::chrono::duration<Rep, Period>& timeout) {
+    return not_full.wait_until([&] { return push(item); },
+                               std::chrono::steady_clock::now() + timeout);
+  }
+
+  // 超时返回 std::nullopt
+  template <typename Rep, typename Period>
+  std::optional<T> pop_wait_for(const std::chrono::duration<Rep, Period>& timeout) {
+    std::optional<T> item;
+    not_empty.wait_until([&] { return static_cast<bool>(item = pop()); },
+                         std::chrono::steady_clock::now() + timeout);
+    return item;
+  }
+};
@@ -0,0 +1,90 @@
+/**
+ * @file thread_group.hpp
+ * @brief 一组线程的 RAII 容器：析构自动 join，可为每个线程指定 CPU 亲和性与线程名
+ *
+ * scoped_thread（02_thread_management/utils）只包装单个线程；thread_group 管理一批：
+ * - add_thread(std::move(t))                : 接管一个已创建的线程（如工厂函数的返回值）
+ * - create_thread(f, args...)               : 普通线程
+ * - create_thread(options, f, args...)      : 先绑核、命名，再执行 f（在新线程内部设置，没有启动窗口）
+ * - create_threads(n, placement, topo, name, f) : 按紧凑/分散策略批量放置，f(index)
+ * 添加线程的函数返回它在组内的下标，之后用 group[index] 访问：组内是 vector，
+ * 再添加线程可能扩容，不返回会失效的引用。
+ * 线程函数抛出的异常与 std::thread 一样会终止程序，由调用者在 f 内部处理。
+ */
+
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "cpu_topology.hpp"
+
+struct thread_options {
+  std::string name;       // 为空则不命名
+  std::vector<int> cpus;  // 为空则不绑核；多个 CPU 表示允许在这组核上迁移
+};
+
+enum class placement { none, compact, spread };
+
+class thread_group {
+  std::vector<std::thread> threads;
+
+ public:
+  thread_group() = default;
+  ~thread_group() { join_all(); }
+
+  thread_group(const thread_group&) = delete;
+  thread_group& operator=(const thread_group&) = delete;
+
+  std::size_t add_thread(std::thread t) {
+    threads.push_back(std::move(t));
+    return threads.size() - 1;
+  }
+
+  template <typename F, typename... Args,
+            typename = std::enable_if_t<
+                !std::is_same<std::decay_t<F>, thread_options>::value>>
+  std::size_t create_thread(F&& f, Args&&... args) {
+    threads.emplace_back(std::forward<F>(f), std::forward<Args>(args)...);
+    return threads.size() - 1;
+  }
+
+  template <typename F, typename... Args>
+  std::size_t create_thread(thread_options options, F&& f, Args&&... args) {
+    threads.emplace_back(
+        [opts = std::move(options), fn = std::forward<F>(f),
+         tup = std::make_tuple(std::forward<Args>(args)...)]() mutable {
+          pin_current_thread(opts.cpus);
+          if (!opts.name.empty()) set_current_thread_name(opts.name);
+          std::apply(fn, std::move(tup));
+        });
+    return threads.size() - 1;
+  }
+
+  // 线程 i 命名为 "name-i"，按 placement 绑定到拓扑中的一个逻辑 CPU
+  template <typename F>
+  void create_threads(std::size_t n, placement where, const cpu_topology& topo,
+                      const std::string& name, F f) {
+    std::vector<int> cpus;
+    if (where == placement::compact) cpus = topo.compact(n);
+    if (where == placement::spread) cpus = topo.spread(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      thread_options opts{name + "-" + std::to_string(i), {}};
+      if (i < cpus.size()) opts.cpus = {cpus[i]};
+      create_thread(std::move(opts), f, i);
+    }
+  }
+
+  void join_all() {
+    for (auto& t : threads)
+      if (t.joinable()) t.join();
+  }
+
+  std::thread& operator[](std::size_t index) { return threads[index]; }
+  std::size_t size() const { return threads.size(); }
+};
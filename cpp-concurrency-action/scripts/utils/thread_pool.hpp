@@ -0,0 +1,150 @@
+/**
+ * @file thread_pool.hpp
+ * @brief 固定大小线程池（共享任务队列 + 条件变量）
+ *
+ * 作为各章节示例共用的执行器（Executor）：
+ * - post(f)   : 只投递任务，不关心结果（执行器接口）
+ * - submit(f) : 投递任务并返回 std::future 结果通道
+ * - run_pending_task() : 在当前线程执行一个排队中的任务（等待子任务时“帮忙”而不是干等）
+ * 任务用 function_wrapper 擦除类型，支持 packaged_task 这类只可移动的可调用对象。
+ */
+
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// 只可移动的类型擦除包装（std::function 要求可拷贝，装不下 packaged_task）
+class function_wrapper {
+  struct impl_base {
+    virtual void call() = 0;
+    virtual ~impl_base() {}
+  };
+
+  template <typename F>
+  struct impl_type : impl_base {
+    F f;
+    impl_type(F&& f_) : f(std::move(f_)) {}
+    void call() override { f(); }
+  };
+
+  std::unique_ptr<impl_base> impl;
+
+ public:
+  function_wrapper() = default;
+
+  template <typename F, typename = std::enable_if_t<!std::is_same<
+                            std::decay_t<F>, function_wrapper>::value>>
+  function_wrapper(F&& f)
+      : impl(new impl_type<std::decay_t<F>>(std::forward<F>(f))) {}
+
+  function_wrapper(function_wrapper&&) = default;
+  function_wrapper& operator=(function_wrapper&&) = default;
+  function_wrapper(const function_wrapper&) = delete;
+  function_wrapper& operator=(const function_wrapper&) = delete;
+
+  void operator()() { impl->call(); }
+  explicit operator bool() const { return impl != nullptr; }
+};
+
+// 内联执行器：直接在调用线程上执行，不切换线程
+struct inline_executor {
+  template <typename F>
+  void post(F&& f) {
+    std::forward<F>(f)();
+  }
+};
+
+class thread_pool {
+  std::mutex mut;
+  std::condition_variable cond;
+  std::queue<function_wrapper> tasks;
+  bool done = false;
+  std::vector<std::thread> threads;  // 最后声明：保证析构 join 时其他成员仍有效
+
+  void worker_thread() {
+    for (;;) {
+      function_wrapper task;
+      {
+        std::unique_lock<std::mutex> lk(mut);
+        cond.wait(lk, [this] { return done || !tasks.empty(); });
+        if (tasks.empty()) return;  // done 且队列已排空
+        task = std::move(tasks.front());
+        tasks.pop();
+      }
+      task();
+    }
+  }
+
+ public:
+  explicit thread_pool(
+      unsigned thread_count = std::thread::hardware_concurrency()) {
+    if (thread_count == 0) thread_count = 1;
+    try {
+      for (unsigned i = 0; i < thread_count; ++i)
+        threads.emplace_back(&thread_pool::worker_thread, this);
+    } catch (...) {
+      {
+        std::lock_guard<std::mutex> lk(mut);
+        done = true;
+      }
+      cond.notify_all();
+      for (auto& t : threads) t.join();
+      throw;
+    }
+  }
+
+  // 析构时先执行完队列中剩余任务，再回收线程
+  ~thread_pool() {
+    {
+      std::lock_guard<std::mutex> lk(mut);
+      done = true;
+    }
+    cond.notify_all();
+    for (auto& t : threads) t.join();
+  }
+
+  thread_pool(const thread_pool&) = delete;
+  thread_pool& operator=(const thread_pool&) = delete;
+
+  template <typename F>
+  void post(F&& f) {
+    {
+      std::lock_guard<std::mutex> lk(mut);
+      tasks.push(function_wrapper(std::forward<F>(f)));
+    }
+    cond.notify_one();  // 锁外通知，避免被唤醒线程立刻阻塞在锁上
+  }
+
+  template <typename F>
+  std::future<std::invoke_result_t<F>> submit(F f) {
+    std::packaged_task<std::invoke_result_t<F>()> task(std::move(f));
+    auto res = task.get_future();
+    post(std::move(task));
+    return res;
+  }
+
+  // 递归分治时，若所有工作线程都阻塞等待自己投递的子任务，子任务就永远没人执行；
+  // 等待方改为循环调用它，既避免死锁，也把等待时间用在有用的工作上
+  bool run_pending_task() {
+    function_wrapper task;
+    {
+      std::lock_guard<std::mutex> lk(mut);
+      if (tasks.empty()) return false;
+      task = std::move(tasks.front());
+      tasks.pop();
+    }
+    task();
+    return true;
+  }
+
+  std::size_t size() const { return threads.size(); }
+};
@@ -0,0 +1,103 @@
+/**
+ * @file thread_safe_queue.hpp
+ * @brief 基于锁的线程安全队列实现
+ * 重点关注使用 condition_variable 解决 生产者-消费者 问题。
+ * 示例见 06_lock_based_concurrent_data_structures/02_thread_safe_queue.cpp
+ */
+
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+
+template <typename T>
+class thread_safe_queue {
+ private:
+  mutable std::mutex mut;
+  std::queue<T> data_queue;
+  std::condition_variable data_cond;
+
+ public:
+  thread_safe_queue() {}
+
+  void push(T new_value) {
+    std::lock_guard<std::mutex> lk(mut);
+    data_queue.push(std::move(new_value));
+    data_cond.notify_one();  // 唤醒一个等待者
+  }
+
+  // 阻塞式 pop
+  void wait_and_pop(T& value) {
+    std::unique_lock<std::mutex> lk(mut);
+    // 等待直到队列非空
+    data_cond.wait(lk, [this] { return !data_queue.empty(); });
+    value = std::move(data_queue.front());
+    data_queue.pop();
+  }
+
+  std::shared_ptr<T> wait_and_pop() {
+    std::unique_lock<std::mutex> lk(mut);
+    data_cond.wait(lk, [this] { return !data_queue.empty(); });
+    std::shared_ptr<T> res(std::make_shared<T>(std::move(data_queue.front())));
+    data_queue.pop();
+    return res;
+  }
+
+  // 限时 pop：超时仍为空则返回 false。内部统一换算成 steady_clock 截止时间，
+  // 虚假唤醒后重新等待也不会把总等待时间拉长
+  template <typename Rep, typename Period>
+  bool wait_for_and_pop(T& value,
+                        std::chrono::duration<Rep, Period> const& timeout) {
+    return wait_until_and_pop(value, std::chrono::steady_clock::now() + timeout);
+  }
+
+  template <typename Clock, typename Duration>
+  bool wait_until_and_pop(
+      T& value, std::chrono::time_point<Clock, Duration> const& deadline) {
+    std::unique_lock<std::mutex> lk(mut);
+    if (!data_cond.wait_until(lk, deadline,
+                              [this] { return !data_queue.empty(); }))
+      return false;
+    value = std::move(data_queue.front());
+    data_queue.pop();
+    return true;
+  }
+
+  template <typename Rep, typename Period>
+  std::shared_ptr<T> wait_for_and_pop(
+      std::chrono::duration<Rep, Period> const& timeout) {
+    std::unique_lock<std::mutex> lk(mut);
+    if (!data_cond.wait_until(lk, std::chrono::steady_clock::now() + timeout,
+                              [this] { return !data_queue.empty(); }))
+      return std::shared_ptr<T>();
+    std::shared_ptr<T> res(std::make_shared<T>(std::move(data_queue.front())));
+    data_queue.pop();
+    return res;
+  }
+
+  // 非阻塞式 pop (try_pop)
+  bool try_pop(T& value) {
+    std::lock_guard<std::mutex> lk(mut);
+    if (data_queue.empty()) return false;
+    value = std::move(data_queue.front());
+    data_queue.pop();
+    return true;
+  }
+
+  // 不要求 T 可默认构造、可移动赋值：队列空时返回 std::nullopt
+  std::optional<T> try_pop() {
+    std::lock_guard<std::mutex> lk(mut);
+    if (data_queue.empty()) return std::nullopt;
+    std::optional<T> res(std::move(data_queue.front()));
+    data_queue.pop();
+    return res;
+  }
+
+  bool empty() const {
+    std::lock_guard<std::mutex> lk(mut);
+    return data_queue.empty();
+  }
+};
@@ -0,0 +1,371 @@
+/**
+ * @file trace.hpp
+ * @brief 轻量级事件追踪：每线程无锁环形缓冲 + 后台收集线程导出 Chrome trace JSON
+ *
+ *   TRACE_SESSION("out.trace.json");     // main 里开启一次会话，析构时写完文件
+ *   TRACE_THREAD_NAME("producer");
+ *   { TRACE_SCOPE("enqueue"); ... }      // 'B'/'E' 成对事件
+ *   TRACE_INSTANT("ebr.advance", epoch); // 瞬时事件，最多两个整数参数
+ *   TRACE_COUNTER("queue.size", n);      // 计数器曲线
+ * 生成的文件用 chrome://tracing 或 https://ui.perfetto.dev 打开。
+ *
+ * - 编译期开关：定义 TRACE_ENABLED=1 时宏才展开，否则全部是空语句（参数不会被求值），
+ *   埋点可以放心留在热路径里；trace:: 下的函数和类始终可用；
+ * - 记录：事件是 32 字节的定长结构，写进本线程的 SPSC 环（单生产者是本线程，
+ *   单消费者是收集线程），不加锁、不分配、不格式化；环满时丢弃并计数，绝不阻塞；
+ * - 时间戳：x86 上读 TSC（会话开始时对 steady_clock 校准一次），其他平台用 steady_clock；
+ * - 收集：session 的后台线程周期性地把各线程的环倒空、格式化成 JSON 写入文件。
+ *   同一时刻只允许一个 session；没有 session 时事件直接丢弃（只有一次 relaxed load）。
+ * 事件名必须是静态存储期的字符串（字面量），记录的只是指针，且不做 JSON 转义。
+ */
+
+#pragma once
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED 0
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "cache_line.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define TRACE_USE_TSC 1
+#else
+#define TRACE_USE_TSC 0
+#endif
+
+#ifndef TRACE_RING_CAPACITY
+#define TRACE_RING_CAPACITY 8192  // 每线程事件数，必须是 2 的幂
+#endif
+
+namespace trace {
+
+struct event {
+  std::uint64_t ts;   // 时钟滴答（TSC 或纳秒）
+  const char* name;
+  std::uint64_t arg0;
+  std::uint32_t arg1;
+  char phase;         // 'B' 开始 / 'E' 结束 / 'i' 瞬时 / 'C' 计数器
+};
+static_assert(sizeof(event) == 32, "trace event should stay 32 bytes");
+
+inline std::uint64_t now() noexcept {
+#if TRACE_USE_TSC
+  return __rdtsc();
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+#endif
+}
+
+// 有会话时才记录
+inline std::atomic<bool> recording{false};
+
+class ring {
+  static constexpr std::uint64_t CAPACITY = TRACE_RING_CAPACITY;
+  static_assert((CAPACITY & (CAPACITY - 1)) == 0, "TRACE_RING_CAPACITY must be a power of 2");
+
+  alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> head{0};  // 本线程写
+  std::uint64_t cached_tail = 0;  // 本线程对 tail 的缓存，环没满时不读收集者的缓存行
+  std::atomic<std::uint64_t> dropped{0};
+  alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> tail{0};  // 收集线程写
+  std::unique_ptr<event[]> slots{new event[CAPACITY]};
+
+  friend class registry;
+  friend class session;
+
+ public:
+  const std::uint32_t tid;
+  std::string name;          // 受 registry 的互斥量保护
+  std::string emitted_name;  // 只有收集线程访问
+
+  explicit ring(std::uint32_t tid) : tid(tid) {}
+
+  // 环满时返回 nullptr 并计数（不读时钟）；否则返回空槽，填好后调用 publish()
+  event* claim() noexcept {
+    const std::uint64_t h = head.load(std::memory_order_relaxed);
+    if (h - cached_tail == CAPACITY) {
+      cached_tail = tail.load(std::memory_order_acquire);
+      if (h - cached_tail == CAPACITY) {
+        dropped.store(dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return nullptr;
+      }
+    }
+    return &slots[h & (CAPACITY - 1)];
+  }
+
+  void publish() noexcept {
+    head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  template <typename F>
+  std::size_t drain(F&& f) {
+    std::uint64_t t = tail.load(std::memory_order_relaxed);
+    const std::uint64_t h = head.load(std::memory_order_acquire);
+    const std::size_t n = h - t;
+    for (; t != h; ++t) f(slots[t & (CAPACITY - 1)]);
+    tail.store(h, std::memory_order_release);
+    return n;
+  }
+};
+
+// 所有线程的环。只在线程第一次记录事件和收集时加锁
+class registry {
+  std::mutex m;
+  std::vector<std::shared_ptr<ring>> rings;
+  std::uint32_t next_tid = 1;
+
+  friend class session;
+
+ public:
+  static registry& instance() {
+    static registry r;
+    return r;
+  }
+
+  std::shared_ptr<ring> attach() {
+    std::lock_guard<std::mutex> lk(m);
+    rings.push_back(std::make_shared<ring>(next_tid++));
+    return rings.back();
+  }
+
+  void set_name(ring& r, const char* name) {
+    std::lock_guard<std::mutex> lk(m);
+    r.name = name;
+  }
+};
+
+// 线程退出后环仍由 registry 持有，直到收集线程把剩余事件倒空
+inline ring& local_ring() {
+  thread_local std::shared_ptr<ring> r = registry::instance().attach();
+  return *r;
+}
+
+inline void emit(char phase, const char* name, std::uint64_t arg0 = 0,
+                 std::uint32_t arg1 = 0) noexcept {
+  if (!recording.load(std::memory_order_relaxed)) return;
+  ring& r = local_ring();
+  if (event* e = r.claim()) {
+    *e = {now(), name, arg0, arg1, phase};
+    r.publish();
+  }
+}
+
+inline void begin(const char* name) noexcept { emit('B', name); }
+inline void end(const char* name) noexcept { emit('E', name); }
+inline void instant(const char* name, std::uint64_t arg0 = 0, std::uint32_t arg1 = 0) noexcept {
+  emit('i', name, arg0, arg1);
+}
+inline void counter(const char* name, std::uint64_t value) noexcept { emit('C', name, value); }
+
+// 只在会话期间生效，避免没有会话时也为线程分配环
+inline void set_thread_name(const char* name) {
+  if (recording.load(std::memory_order_relaxed)) registry::instance().set_name(local_ring(), name);
+}
+
+class scope {
+  const char* name;
+
+ public:
+  explicit scope(const char* name) noexcept : name(name) { begin(name); }
+  ~scope() { end(name); }
+  scope(const scope&) = delete;
+  scope& operator=(const scope&) = delete;
+};
+
+// 追踪会话：构造时开始记录并启动收集线程，析构时停止记录、收尾并关闭文件
+class session {
+  std::ofstream out;
+  std::chrono::milliseconds period;
+  std::thread collector;
+  std::mutex m;  // 串行化收集（后台线程与 flush）
+  std::condition_variable cv;
+  bool stopping = false;
+  bool first = true;
+
+  // 滴答 → 微秒：ts_us = (ticks - tick0) * us_per_tick
+  std::uint64_t tick0 = 0;
+  double us_per_tick = 1e-3;
+
+  std::atomic<std::uint64_t> written{0};
+  std::atomic<std::uint64_t> lost{0};
+
+  void calibrate() {
+    using namespace std::chrono;
+    auto n0 = steady_clock::now();
+    tick0 = now();
+#if TRACE_USE_TSC
+    std::this_thread::sleep_for(milliseconds(10));
+    const std::uint64_t t1 = now();
+    const double us = duration<double, std::micro>(steady_clock::now() - n0).count();
+    us_per_tick = us / static_cast<double>(t1 - tick0);
+    tick0 = t1;  // 时间轴从会话开始记录时算起
+#endif
+  }
+
+  void write_line(const char* buf, int len) {
+    if (!first) out.put(',');
+    out.put('\n');
+    out.write(buf, len);
+    first = false;
+  }
+
+  void write_event(const ring& r, const event& e) {
+    char buf[256];
+    const double ts = static_cast<double>(static_cast<std::int64_t>(e.ts - tick0)) * us_per_tick;
+    int len;
+    switch (e.phase) {
+      case 'i':
+        len = std::snprintf(buf, sizeof(buf),
+                            "{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":1,"
+                            "\"tid\":%u,\"args\":{\"arg0\":%llu,\"arg1\":%u}}",
+                            e.name, ts, r.tid, static_cast<unsigned long long>(e.arg0), e.arg1);
+        break;
+      case 'C':
+        len = std::snprintf(buf, sizeof(buf),
+                            "{\"name\":\"%s\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"tid\":%u,"
+                            "\"args\":{\"value\":%llu}}",
+                            e.name, ts, r.tid, static_cast<unsigned long long>(e.arg0));
+        break;
+      default:
+        len = std::snprintf(buf, sizeof(buf),
+                            "{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%u}",
+                            e.name, e.phase, ts, r.tid);
+    }
+    write_line(buf, std::min<int>(len, sizeof(buf) - 1));
+  }
+
+  // 只在拷贝环列表和线程名时持有 registry 的锁，格式化与写文件都在锁外，
+  // 不会拖住第一次记录事件的线程
+  void collect() {
+    registry& reg = registry::instance();
+    std::vector<std::pair<std::shared_ptr<ring>, std::string>> rings;
+    {
+      std::lock_guard<std::mutex> lk(reg.m);
+      rings.reserve(reg.rings.size());
+      for (auto& r : reg.rings) rings.emplace_back(r, r->name);
+    }
+
+    std::vector<const ring*> exited_rings;
+    for (auto& [ptr, name] : rings) {
+      ring& r = *ptr;
+      if (r.emitted_name != name) {
+        char buf[256];
+        int len = std::snprintf(buf, sizeof(buf),
+                                "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                                "\"args\":{\"name\":\"%s\"}}",
+                                r.tid, name.c_str());
+        write_line(buf, std::min<int>(len, sizeof(buf) - 1));
+        r.emitted_name = name;
+      }
+      // 先看线程是否已退出再倒空：退出前写入的事件一定能被这次倒空看到。
+      // 只有这里会从 registry 删除环，剩下 registry 和本地拷贝两份引用即线程已退出
+      const bool exited = ptr.use_count() == 2;
+      std::atomic_thread_fence(std::memory_order_acquire);
+      written += r.drain([&](const event& e) { write_event(r, e); });
+      if (exited) {
+        lost += r.dropped.load(std::memory_order_relaxed);
+        exited_rings.push_back(&r);
+      }
+    }
+
+    if (exited_rings.empty()) return;
+    std::lock_guard<std::mutex> lk(reg.m);
+    reg.rings.erase(std::remove_if(reg.rings.begin(), reg.rings.end(),
+                                   [&](const std::shared_ptr<ring>& r) {
+                                     return std::find(exited_rings.begin(), exited_rings.end(),
+                                                      r.get()) != exited_rings.end();
+                                   }),
+                    reg.rings.end());
+  }
+
+ public:
+  explicit session(const std::string& path,
+                   std::chrono::milliseconds period = std::chrono::milliseconds(10))
+      : out(path), period(period) {
+    calibrate();
+    out << "[";
+    {
+      // 丢弃计数从本次会话算起。没有会话时线程不会记录，这里清零不会与线程的计数冲突
+      registry& reg = registry::instance();
+      std::lock_guard<std::mutex> lk(reg.m);
+      for (auto& r : reg.rings) r->dropped.store(0, std::memory_order_relaxed);
+    }
+    recording.store(true, std::memory_order_relaxed);
+    collector = std::thread([this] {
+      std::unique_lock<std::mutex> lk(m);
+      while (!stopping) {
+        cv.wait_for(lk, this->period, [this] { return stopping; });
+        collect();
+      }
+    });
+  }
+
+  ~session() {
+    recording.store(false, std::memory_order_relaxed);
+    {
+      std::lock_guard<std::mutex> lk(m);
+      stopping = true;
+    }
+    cv.notify_one();
+    collector.join();
+    collect();
+    out << "\n]\n";
+  }
+
+  session(const session&) = delete;
+  session& operator=(const session&) = delete;
+
+  // 立即把各线程环里的事件写出（不必等下一个收集周期）
+  void flush() {
+    std::lock_guard<std::mutex> lk(m);
+    collect();
+  }
+
+  std::uint64_t events_written() const { return written.load(); }
+
+  // 本次会话中因环满而丢弃的事件数（含仍在运行的线程）
+  std::uint64_t events_dropped() {
+    std::lock_guard<std::mutex> lk(registry::instance().m);
+    std::uint64_t n = lost.load();
+    for (auto& r : registry::instance().rings) n += r->dropped.load(std::memory_order_relaxed);
+    return n;
+  }
+};
+
+}  // namespace trace
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+
+#if TRACE_ENABLED
+#define TRACE_SESSION(path) ::trace::session TRACE_CONCAT(trace_session_, __LINE__)(path)
+#define TRACE_THREAD_NAME(name) ::trace::set_thread_name(name)
+#define TRACE_SCOPE(name) ::trace::scope TRACE_CONCAT(trace_scope_, __LINE__)(name)
+#define TRACE_BEGIN(name) ::trace::begin(name)
+#define TRACE_END(name) ::trace::end(name)
+#define TRACE_INSTANT(...) ::trace::instant(__VA_ARGS__)
+#define TRACE_COUNTER(name, value) ::trace::counter(name, value)
+#else
+#define TRACE_SESSION(path) ((void)0)
+#define TRACE_THREAD_NAME(name) ((void)0)
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_BEGIN(name) ((void)0)
+#define TRACE_END(name) ((void)0)
+#define TRACE_INSTANT(...) ((void)0)
+#define TRACE_COUNTER(name, value) ((void)0)
+#endif
@@ -0,0 +1,160 @@
+/**
+ * @file triple_buffer.hpp
+ * @brief 最新值发布：单写者三缓冲（triple_buffer）与多读者扩展（multi_reader_buffer）
+ * 示例见 07_lock_free_concurrent_data_structures/15_triple_buffer.cpp
+ *
+ * 写者不断发布一个大状态对象（传感器读数、行情快照），读者只关心最新的完整版本：
+ * - triple_buffer：三块缓冲分别归写者（back）、读者（front）与中间交接位（middle）。
+ *   写者在 back 里原地写好后 publish()，一次 exchange 把它与 middle 对调并打上“有新值”标记；
+ *   读者 update() 时若有新值，同样一次 exchange 把 middle 换成自己的 front。
+ *   两侧都是无等待的，写者从不等读者，中间没看过的版本直接被覆盖，读者原地读、不拷贝；
+ * - multi_reader_buffer<T, MaxReaders>：MaxReaders + 2 块缓冲，每块带读者计数。
+ *   读者 read() 拿到最新缓冲的只读句柄（计数加一后确认它仍是最新，否则重试，无锁），
+ *   写者挑一块既不是最新、也没有读者的缓冲原地写：读者最多占 MaxReaders 块，任何时刻
+ *   总有一块空闲，通常扫描一遍即可，写者从不等待读者读完。
+ *   前提：同一时刻持有句柄的读者不超过 MaxReaders 个，每个读者最多持有一个句柄
+ *   （换新句柄前先归还旧的），否则缓冲可能全被占住，写者的 publish() 会一直自旋。
+ *
+ * 写者拿到的缓冲里是几个版本之前的旧内容，必须整体覆盖（或只改确知过期的部分）。
+ */
+
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "cache_line.hpp"
+
+template <typename T>
+class triple_buffer {
+  static constexpr std::uint8_t INDEX_MASK = 0x3;
+  static constexpr std::uint8_t FRESH = 0x4;  // middle 里是读者还没看过的新版本
+
+  struct alignas(CACHE_LINE_SIZE) slot {
+    T value;
+  };
+
+  slot buffers[3];
+  alignas(CACHE_LINE_SIZE) std::atomic<std::uint8_t> middle{1};
+  alignas(CACHE_LINE_SIZE) std::uint8_t back = 0;  // 写者独占
+  alignas(CACHE_LINE_SIZE) std::uint8_t front = 2;  // 读者独占
+
+ public:
+  triple_buffer() = default;
+  explicit triple_buffer(const T& initial) : buffers{{initial}, {initial}, {initial}} {}
+
+  triple_buffer(const triple_buffer&) = delete;
+  triple_buffer& operator=(const triple_buffer&) = delete;
+
+  // 写者：原地填写，再 publish()
+  T& write_buffer() { return buffers[back].value; }
+
+  void publish() {
+    const std::uint8_t old = middle.exchange(back | FRESH, std::memory_order_acq_rel);
+    back = old & INDEX_MASK;
+  }
+
+  void publish(const T& value) {
+    write_buffer() = value;
+    publish();
+  }
+
+  // 读者：有新版本时换到最新版本，返回是否换了
+  bool update() {
+    if (!(middle.load(std::memory_order_relaxed) & FRESH)) return false;
+    const std::uint8_t old = middle.exchange(front, std::memory_order_acq_rel);
+    front = old & INDEX_MASK;
+    return true;
+  }
+
+  // 读者当前持有的版本，下次 update() 之前保持不变
+  const T& read_buffer() const { return buffers[front].value; }
+
+  const T& read() {
+    update();
+    return read_buffer();
+  }
+};
+
+template <typename T, std::size_t MaxReaders>
+class multi_reader_buffer {
+  // 每个读者一块、最新一块、写者一块。持有句柄的读者超过 MaxReaders 个时，
+  // find_free 可能找不到空闲缓冲而永远自旋
+  static constexpr std::size_t BUFFERS = MaxReaders + 2;
+
+  struct alignas(CACHE_LINE_SIZE) slot {
+    std::atomic<std::uint32_t> readers{0};
+    alignas(CACHE_LINE_SIZE) T value;
+  };
+
+  std::array<slot, BUFFERS> buffers;
+  alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> latest{0};
+  alignas(CACHE_LINE_SIZE) std::size_t back = 1;  // 写者独占
+
+  // 写者：找一块不是最新、也没有读者的缓冲
+  std::size_t find_free(std::size_t current) const {
+    for (std::size_t i = 0;; i = (i + 1) % BUFFERS)
+      if (i != current && buffers[i].readers.load(std::memory_order_seq_cst) == 0) return i;
+  }
+
+ public:
+  // 只读句柄，析构或 reset() 时归还缓冲；默认构造的句柄为空
+  class snapshot {
+    slot* s = nullptr;
+
+    explicit snapshot(slot* held) : s(held) {}
+    friend class multi_reader_buffer;
+
+   public:
+    snapshot() = default;
+    snapshot(snapshot&& other) noexcept : s(std::exchange(other.s, nullptr)) {}
+    snapshot& operator=(snapshot&& other) noexcept {
+      if (this != &other) {
+        reset();
+        s = std::exchange(other.s, nullptr);
+      }
+      return *this;
+    }
+    ~snapshot() { reset(); }
+
+    void reset() {
+      if (s) std::exchange(s, nullptr)->readers.fetch_sub(1, std::memory_order_release);
+    }
+    explicit operator bool() const { return s != nullptr; }
+
+    const T& operator*() const { return s->value; }
+    const T* operator->() const { return &s->value; }
+  };
+
+  multi_reader_buffer() = default;
+  explicit multi_reader_buffer(const T& initial) {
+    for (slot& s : buffers) s.value = initial;
+  }
+  multi_reader_buffer(const multi_reader_buffer&) = delete;
+  multi_reader_buffer& operator=(const multi_reader_buffer&) = delete;
+
+  T& write_buffer() { return buffers[back].value; }
+
+  void publish() {
+    // seq_cst：与读者“计数加一、再读 latest”构成 store-load 握手，
+    // 写者看不到某个读者的计数时，那个读者一定会看到新的 latest 而重试
+    latest.store(back, std::memory_order_seq_cst);
+    back = find_free(back);
+  }
+
+  void publish(const T& value) {
+    write_buffer() = value;
+    publish();
+  }
+
+  snapshot read() {
+    for (;;) {
+      const std::size_t i = latest.load(std::memory_order_acquire);
+      buffers[i].readers.fetch_add(1, std::memory_order_seq_cst);
+      if (latest.load(std::memory_order_seq_cst) == i) return snapshot(&buffers[i]);
+      buffers[i].readers.fetch_sub(1, std::memory_order_relaxed);  // 期间写者又发布了
+    }
+  }
+};
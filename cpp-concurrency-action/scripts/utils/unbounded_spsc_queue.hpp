@@ -0,0 +1,143 @@
+/**
+ * @file unbounded_spsc_queue.hpp
+ * @brief 无界单生产者-单消费者队列：定长环形段（segment）串成链表，段循环复用
+ * 示例见 07_lock_free_concurrent_data_structures/11_unbounded_spsc_queue.cpp
+ *
+ * - 每段 SegmentSize 个槽。生产者写满当前段后接上一个新段；消费者读完一段后前进到
+ *   下一段，push 永远成功，消费者落后时队列变长而不是让生产者失败重试；
+ * - 段复用（Vyukov 的节点缓存）：生产者记着自己分配过的最老的段 first，消费者已经离开的
+ *   段（first 到 consumer_seg 之间）都可以直接拿来重用。稳态下不再分配内存，
+ *   内存占用等于历史上最长积压所需的段数，析构时才释放；
+ * - push / pop 各自只写自己的缓存行，除了换段都不做 RMW。换段时只需申请新段一次，
+ *   此时 push 不是无等待的；
+ * - pop_wait / pop_wait_for 在空时按 WaitStrategy 等待（同 SPSCQueue），没有 push_wait：
+ *   队列不会满。
+ */
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <new>
+#include <optional>
+#include <utility>
+
+#include "cache_line.hpp"
+#include "wait_strategy.hpp"
+
+template <typename T, std::size_t SegmentSize = 1024, typename WaitStrategy = spin_park_wait>
+class unbounded_spsc_queue {
+  static_assert(SegmentSize > 0, "segment must hold at least one element");
+
+  struct segment {
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> tail{0};  // 已发布的槽数（生产者写）
+    std::atomic<segment*> next{nullptr};
+    alignas(CACHE_LINE_SIZE) alignas(T) unsigned char storage[sizeof(T) * SegmentSize];
+
+    T* slot(std::size_t i) { return std::launder(reinterpret_cast<T*>(storage) + i); }
+  };
+
+  // 生产者独占
+  alignas(CACHE_LINE_SIZE) segment* tail_seg;
+  std::size_t tail_index = 0;  // == tail_seg->tail，免得每次 push 读原子量
+  segment* first;              // 最老的段，[first, consumer_seg) 都可复用
+  segment* consumer_seg_copy;  // consumer_seg 的缓存，追上时才重新读
+  std::atomic<std::size_t> allocated{0};
+
+  // 消费者独占（consumer_seg 由生产者偶尔读取）
+  alignas(CACHE_LINE_SIZE) std::atomic<segment*> consumer_seg;
+  std::size_t head_index = 0;
+  std::size_t cached_tail = 0;  // 对 consumer_seg->tail 的缓存，读空了才重新读
+
+  alignas(CACHE_LINE_SIZE) WaitStrategy not_empty;
+
+  segment* next_segment() {
+    if (first == consumer_seg_copy) {
+      consumer_seg_copy = consumer_seg.load(std::memory_order_acquire);
+      if (first == consumer_seg_copy) {
+        allocated.fetch_add(1, std::memory_order_relaxed);
+        return new segment;
+      }
+    }
+    segment* s = first;  // 消费者已经离开：里面的元素都已析构
+    first = s->next.load(std::memory_order_relaxed);
+    s->tail.store(0, std::memory_order_relaxed);
+    s->next.store(nullptr, std::memory_order_relaxed);
+    return s;
+  }
+
+ public:
+  unbounded_spsc_queue() : tail_seg(new segment), first(tail_seg), consumer_seg_copy(tail_seg) {
+    allocated.store(1, std::memory_order_relaxed);
+    consumer_seg.store(tail_seg, std::memory_order_relaxed);
+  }
+
+  // 析构时不得有并发操作
+  ~unbounded_spsc_queue() {
+    while (pop()) {
+    }
+    for (segment* s = first; s;) {
+      segment* next = s->next.load(std::memory_order_relaxed);
+      delete s;
+      s = next;
+    }
+  }
+
+  unbounded_spsc_queue(const unbounded_spsc_queue&) = delete;
+  unbounded_spsc_queue& operator=(const unbounded_spsc_queue&) = delete;
+
+  template <typename... Args>
+  void emplace(Args&&... args) {
+    if (tail_index == SegmentSize) {
+      segment* s = next_segment();
+      tail_seg->next.store(s, std::memory_order_release);
+      tail_seg = s;
+      tail_index = 0;
+    }
+    ::new (tail_seg->slot(tail_index)) T(std::forward<Args>(args)...);
+    tail_seg->tail.store(++tail_index, std::memory_order_release);
+    not_empty.notify();
+  }
+
+  void push(const T& item) { emplace(item); }
+  void push(T&& item) { emplace(std::move(item)); }
+
+  std::optional<T> pop() {
+    segment* s = consumer_seg.load(std::memory_order_relaxed);
+    if (head_index == cached_tail) {
+      if (head_index == SegmentSize) {
+        // 整段读完：生产者先发布 tail 再接上 next，看到 next 就不会漏掉本段的元素
+        segment* next = s->next.load(std::memory_order_acquire);
+        if (!next) return std::nullopt;
+        consumer_seg.store(next, std::memory_order_release);  // 此后 s 归生产者复用
+        s = next;
+        head_index = 0;
+      }
+      cached_tail = s->tail.load(std::memory_order_acquire);
+      if (head_index == cached_tail) return std::nullopt;
+    }
+    T* p = s->slot(head_index++);
+    std::optional<T> item(std::move(*p));
+    p->~T();
+    return item;
+  }
+
+  // 阻塞式 pop：队列为空时按策略等待，直到生产者 push
+  T pop_wait() {
+    std::optional<T> item;
+    not_empty.wait([&] { return static_cast<bool>(item = pop()); });
+    return std::move(*item);
+  }
+
+  // 超时返回 std::nullopt
+  template <typename Rep, typename Period>
+  std::optional<T> pop_wait_for(const std::chrono::duration<Rep, Period>& timeout) {
+    std::optional<T> item;
+    not_empty.wait_until([&] { return static_cast<bool>(item = pop()); },
+                         std::chrono::steady_clock::now() + timeout);
+    return item;
+  }
+
+  // 累计分配过的段数（稳态下不再增长）
+  std::size_t segments_allocated() const { return allocated.load(std::memory_order_relaxed); }
+};
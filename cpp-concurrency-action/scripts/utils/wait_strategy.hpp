@@ -0,0 +1,146 @@
+/**
+ * @file wait_strategy.hpp
+ * @brief 等待策略（策略模板参数）：在延迟、CPU 占用与生产者开销之间取舍
+ *
+ * 每个策略对象负责“一侧”的等待（如 SPSCQueue 的 not_empty / not_full），接口：
+ *   wait(ready)                 : 阻塞直到 ready() 为真
+ *   wait_until(ready, deadline) : 带截止时间，超时返回 false
+ *   notify()                    : 状态变化后由对端调用
+ *
+ * | 策略              | 等待方式                    | 唤醒延迟 | 空闲 CPU | notify 开销        |
+ * |-------------------|-----------------------------|----------|----------|--------------------|
+ * | busy_spin_wait    | pause 死等（需独占核心）    | 最低     | 100%     | 无                 |
+ * | spin_yield_wait   | 自旋后 yield                | 低       | 高       | 无                 |
+ * | spin_park_wait    | 自旋后 futex 睡眠           | 中       | ~0       | fence + relaxed load |
+ * | timed_sleep_wait  | 自旋后按固定间隔睡眠重查    | ≈间隔    | 低       | 无                 |
+ */
+
+#pragma once
+#include <chrono>
+#include <thread>
+
+#include "event_count.hpp"
+#include "spin_wait.hpp"
+
+struct busy_spin_wait {
+  template <typename Ready>
+  void wait(Ready&& ready) {
+    while (!ready()) cpu_relax();
+  }
+
+  template <typename Ready, typename Clock, typename Duration>
+  bool wait_until(Ready&& ready,
+                  const std::chrono::time_point<Clock, Duration>& deadline) {
+    for (unsigned i = 0;; ++i) {
+      if (ready()) return true;
+      if ((i & 63) == 0 && Clock::now() >= deadline) return false;  // 降低取时开销
+      cpu_relax();
+    }
+  }
+
+  void notify() {}
+};
+
+struct spin_yield_wait {
+  template <typename Ready>
+  void wait(Ready&& ready) {
+    for (int i = 0; i < default_spin_limit(); ++i) {
+      if (ready()) return;
+      cpu_relax();
+    }
+    while (!ready()) std::this_thread::yield();
+  }
+
+  template <typename Ready, typename Clock, typename Duration>
+  bool wait_until(Ready&& ready,
+                  const std::chrono::time_point<Clock, Duration>& deadline) {
+    for (int i = 0; i < default_spin_limit(); ++i) {
+      if (ready()) return true;
+      cpu_relax();
+    }
+    while (!ready()) {
+      if (Clock::now() >= deadline) return false;
+      std::this_thread::yield();
+    }
+    return true;
+  }
+
+  void notify() {}
+};
+
+// 自旋一小段后通过 event_count 睡眠（Linux 上是 futex），无人睡眠时 notify 不进内核
+struct spin_park_wait {
+  template <typename Ready>
+  void wait(Ready&& ready) {
+    for (int i = 0; i < default_spin_limit(); ++i) {
+      if (ready()) return;
+      cpu_relax();
+    }
+    while (!ready()) {
+      auto key = ec.prepare_wait();
+      if (ready()) {  // 登记之后再查一次，避免唤醒丢失
+        ec.cancel_wait();
+        return;
+      }
+      ec.commit_wait(key);
+    }
+  }
+
+  template <typename Ready, typename Clock, typename Duration>
+  bool wait_until(Ready&& ready,
+                  const std::chrono::time_point<Clock, Duration>& deadline) {
+    for (int i = 0; i < default_spin_limit(); ++i) {
+      if (ready()) return true;
+      cpu_relax();
+    }
+    while (!ready()) {
+      auto key = ec.prepare_wait();
+      if (ready()) {
+        ec.cancel_wait();
+        return true;
+      }
+      if (!ec.commit_wait_until(key, deadline)) return ready();
+    }
+    return true;
+  }
+
+  void notify() { ec.notify(); }
+
+ private:
+  event_count ec;
+};
+
+// 按固定间隔睡眠后重查：生产者零开销，延迟上界约为 IntervalUs，适合后台批处理
+template <long IntervalUs = 50>
+struct timed_sleep_wait {
+  template <typename Ready>
+  void wait(Ready&& ready) {
+    for (int i = 0; i < default_spin_limit(); ++i) {
+      if (ready()) return;
+      cpu_relax();
+    }
+    while (!ready())
+      std::this_thread::sleep_for(std::chrono::microseconds(IntervalUs));
+  }
+
+  template <typename Ready, typename Clock, typename Duration>
+  bool wait_until(Ready&& ready,
+                  const std::chrono::time_point<Clock, Duration>& deadline) {
+    for (int i = 0; i < default_spin_limit(); ++i) {
+      if (ready()) return true;
+      cpu_relax();
+    }
+    const auto slice = std::chrono::microseconds(IntervalUs);
+    while (!ready()) {
+      auto now = Clock::now();
+      if (now >= deadline) return false;
+      if (deadline - now < slice)
+        std::this_thread::sleep_until(deadline);
+      else
+        std::this_thread::sleep_for(slice);
+    }
+    return true;
+  }
+
+  void notify() {}
+};